@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_trace.cpp
+//
+// Identification: src/buffer/access_trace.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/access_trace.h"
+
+#include <fstream>
+
+namespace bustub {
+
+void AccessTrace::Record(page_id_t page_id, AccessType access_type, bool is_new) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  accesses_.push_back({page_id, access_type, is_new});
+}
+
+auto AccessTrace::Save(const std::string &file_name) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::ofstream out(file_name);
+  if (!out) {
+    return false;
+  }
+  for (const auto &access : accesses_) {
+    out << (access.is_new_ ? 'n' : 'f') << ' ' << static_cast<int>(access.access_type_) << ' ' << access.page_id_
+        << '\n';
+  }
+  return static_cast<bool>(out);
+}
+
+auto AccessTrace::Load(const std::string &file_name) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::ifstream in(file_name);
+  if (!in) {
+    return false;
+  }
+  char kind;
+  int access_type;
+  page_id_t page_id;
+  while (in >> kind >> access_type >> page_id) {
+    if ((kind != 'n' && kind != 'f') || access_type < static_cast<int>(AccessType::Unknown) ||
+        access_type > static_cast<int>(AccessType::Scan)) {
+      return false;
+    }
+    accesses_.push_back({page_id, static_cast<AccessType>(access_type), kind == 'n'});
+  }
+  return in.eof();
+}
+
+}  // namespace bustub
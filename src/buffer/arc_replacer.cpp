@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+ArcReplacer::ArcReplacer(size_t num_frames) : capacity_(num_frames), frames_(num_frames) {}
+
+auto ArcReplacer::PreferredList() -> ListId { return t1_.size() > p_ ? ListId::T1 : ListId::T2; }
+
+auto ArcReplacer::Evict(frame_id_t *frame_id) -> bool {
+  return Evict(frame_id, [](frame_id_t) { return true; });
+}
+
+auto ArcReplacer::Evict(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &try_evict) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  ListId first = PreferredList();
+  for (ListId list_id : {first, first == ListId::T1 ? ListId::T2 : ListId::T1}) {
+    auto &list = ListOf(list_id);
+    for (auto it = list.rbegin(); it != list.rend(); ++it) {
+      frame_id_t victim = *it;
+      FrameNode &node = frames_[victim];
+      if (!node.is_evictable_ || !try_evict(victim)) {
+        continue;
+      }
+      list.erase(node.pos_);
+      if (node.page_id_ != INVALID_PAGE_ID && ghosts_.count(node.page_id_) == 0) {
+        bool to_b2 = list_id == ListId::T2;
+        auto &ghosts = to_b2 ? b2_ : b1_;
+        ghosts.push_front(node.page_id_);
+        ghosts_[node.page_id_] = {to_b2, ghosts.begin()};
+      }
+      node = FrameNode();
+      curr_size_--;
+      TrimGhosts();
+      *frame_id = victim;
+      return true;
+    }
+  }
+  return false;
+}
+
+auto ArcReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  ListId first = PreferredList();
+  for (ListId list_id : {first, first == ListId::T1 ? ListId::T2 : ListId::T1}) {
+    auto &list = ListOf(list_id);
+    for (auto it = list.rbegin(); it != list.rend() && candidates.size() < max_frames; ++it) {
+      if (frames_[*it].is_evictable_) {
+        candidates.push_back(*it);
+      }
+    }
+  }
+  return candidates;
+}
+
+void ArcReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, page_id_t page_id) {
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < capacity_, "frame id is out of range");
+  std::scoped_lock<std::mutex> lock(latch_);
+  FrameNode &node = frames_[frame_id];
+  if (page_id != INVALID_PAGE_ID) {
+    node.page_id_ = page_id;
+  }
+
+  if (node.list_ != ListId::None) {
+    // A hit moves the frame to the front of T2, except that a scan only refreshes its position in T1.
+    ListId to = node.list_ == ListId::T1 && access_type == AccessType::Scan ? ListId::T1 : ListId::T2;
+    ListOf(to).splice(ListOf(to).begin(), ListOf(node.list_), node.pos_);
+    node.list_ = to;
+    return;
+  }
+
+  auto ghost = page_id == INVALID_PAGE_ID ? ghosts_.end() : ghosts_.find(page_id);
+  if (ghost == ghosts_.end()) {
+    t1_.push_front(frame_id);
+    node.list_ = ListId::T1;
+    node.pos_ = t1_.begin();
+    TrimGhosts();
+    return;
+  }
+
+  // The page was evicted too early. Grow the list it was evicted from.
+  if (ghost->second.in_b2_) {
+    size_t delta = std::max<size_t>(b1_.size() / b2_.size(), 1);
+    p_ -= std::min(p_, delta);
+    b2_.erase(ghost->second.pos_);
+  } else {
+    size_t delta = std::max<size_t>(b2_.size() / b1_.size(), 1);
+    p_ = std::min(capacity_, p_ + delta);
+    b1_.erase(ghost->second.pos_);
+  }
+  ghosts_.erase(ghost);
+  t2_.push_front(frame_id);
+  node.list_ = ListId::T2;
+  node.pos_ = t2_.begin();
+}
+
+void ArcReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < capacity_, "frame id is out of range");
+  std::scoped_lock<std::mutex> lock(latch_);
+  FrameNode &node = frames_[frame_id];
+  if (node.list_ == ListId::None || node.is_evictable_ == set_evictable) {
+    return;
+  }
+  node.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void ArcReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  FrameNode &node = frames_[frame_id];
+  if (node.list_ == ListId::None) {
+    return;
+  }
+  BUSTUB_ENSURE(node.is_evictable_, "cannot remove a non-evictable frame");
+  ListOf(node.list_).erase(node.pos_);
+  node = FrameNode();
+  curr_size_--;
+}
+
+auto ArcReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+auto ArcReplacer::GetTargetT1Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return p_;
+}
+
+void ArcReplacer::TrimGhosts() {
+  while (!b1_.empty() && t1_.size() + b1_.size() > capacity_) {
+    DropGhost(false);
+  }
+  while (!b1_.empty() || !b2_.empty()) {
+    if (t1_.size() + t2_.size() + b1_.size() + b2_.size() <= 2 * capacity_) {
+      break;
+    }
+    DropGhost(!b2_.empty());
+  }
+}
+
+void ArcReplacer::DropGhost(bool from_b2) {
+  auto &ghosts = from_b2 ? b2_ : b1_;
+  ghosts_.erase(ghosts.back());
+  ghosts.pop_back();
+}
+
+}  // namespace bustub
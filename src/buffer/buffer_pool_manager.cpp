@@ -12,56 +12,1030 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+
 #include "common/exception.h"
+#include "common/logger.h"
 #include "common/macros.h"
 #include "storage/page/page_guard.h"
 
 namespace bustub {
 
+/** Marks a file of resident page ids saved by a warm restart snapshot. */
+static constexpr uint32_t WARM_RESTART_MAGIC = 0x6d726177;
+
+/** @return the page ids saved to path, or none if there is no valid snapshot there */
+static auto ReadPageList(const std::string &path) -> std::vector<page_id_t> {
+  std::ifstream in(path, std::ios::binary);
+  uint32_t magic = 0;
+  uint64_t count = 0;
+  in.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+  in.read(reinterpret_cast<char *>(&count), sizeof(count));
+  if (!in || magic != WARM_RESTART_MAGIC) {
+    return {};
+  }
+  std::vector<page_id_t> page_ids(count);
+  in.read(reinterpret_cast<char *>(page_ids.data()), static_cast<std::streamsize>(count * sizeof(page_id_t)));
+  if (!in) {
+    return {};
+  }
+  return page_ids;
+}
+
+/** Save page_ids to path. The file is replaced at once, so a crash never leaves half a snapshot behind. */
+static void WritePageList(const std::string &path, const std::vector<page_id_t> &page_ids) {
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    uint64_t count = page_ids.size();
+    out.write(reinterpret_cast<const char *>(&WARM_RESTART_MAGIC), sizeof(WARM_RESTART_MAGIC));
+    out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char *>(page_ids.data()), static_cast<std::streamsize>(count * sizeof(page_id_t)));
+    if (!out) {
+      LOG_WARN("cannot save the resident pages to %s", tmp_path.c_str());
+      return;
+    }
+  }
+  std::rename(tmp_path.c_str(), path.c_str());
+}
+
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // TODO(students): remove this line after you have implemented the buffer pool manager
-  throw NotImplementedException(
-      "BufferPoolManager is not implemented yet. If you have finished implementing BPM, please remove the throw "
-      "exception line in `buffer_pool_manager.cpp`.");
+                                     LogManager *log_manager, size_t num_io_workers, ReplacerPolicy replacer_policy,
+                                     bool use_frame_arena)
+    : BufferPoolManager(pool_size, 1, 0, disk_manager, replacer_k, log_manager, num_io_workers, replacer_policy,
+                        use_frame_arena) {}
+
+BufferPoolManager::BufferPoolManager(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                     DiskManager *disk_manager, size_t replacer_k, LogManager *log_manager,
+                                     size_t num_io_workers, ReplacerPolicy replacer_policy, bool use_frame_arena)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(static_cast<page_id_t>(instance_index)),
+      disk_manager_(disk_manager),
+      disk_scheduler_(std::make_unique<DiskScheduler>(disk_manager, num_io_workers, num_instances)),
+      log_manager_(log_manager),
+      page_table_(pool_size) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(
+      instance_index < num_instances,
+      "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
 
   // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
+  pages_ = static_cast<Page *>(operator new[](pool_size_ * sizeof(Page), std::align_val_t{alignof(Page)}));
+  if (use_frame_arena) {
+    frame_arena_ = std::make_unique<FrameArena>(pool_size_);
+    for (size_t i = 0; i < pool_size_; ++i) {
+      new (&pages_[i]) Page(frame_arena_->GetFrame(static_cast<frame_id_t>(i)));
+    }
+  } else {
+    for (size_t i = 0; i < pool_size_; ++i) {
+      new (&pages_[i]) Page();
+    }
+  }
+  pending_io_.resize(pool_size_);
+  prefetched_.resize(pool_size_, false);
+  warm_.resize(pool_size_, false);
+  ring_of_.resize(pool_size_, nullptr);
+  shared_ = std::make_unique<std::atomic<bool>[]>(pool_size_);
+  replacer_ = MakeReplacer(replacer_policy, pool_size, replacer_k);
+
+  size_t access_log_size = 1;
+  while (access_log_size < pool_size_) {
+    access_log_size *= 2;
+  }
+  access_log_ = std::make_unique<std::atomic<frame_id_t>[]>(access_log_size);
+  access_log_mask_ = access_log_size - 1;
+  for (size_t i = 0; i < access_log_size; ++i) {
+    access_log_[i] = INVALID_PAGE_ID;
+  }
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].pin_count_ = -1;
+    shared_[i] = false;
     free_list_.emplace_back(static_cast<int>(i));
   }
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+BufferPoolManager::BufferPoolManager(DiskManager *disk_manager, LogManager *log_manager)
+    : pool_size_(0), disk_manager_(disk_manager), log_manager_(log_manager), page_table_(0) {}
+
+BufferPoolManager::~BufferPoolManager() {
+  BufferPoolManager::StopPageCleaner();
+  StopWarmRestart();
+  // Nobody waits for read-ahead, so the disk workers may still be filling frames.
+  for (frame_id_t frame_id : read_ahead_) {
+    if (pending_io_[frame_id].valid()) {
+      pending_io_[frame_id].wait();
+    }
+  }
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].~Page();
+  }
+  operator delete[](pages_, std::align_val_t{alignof(Page)});
+}
+
+auto BufferPoolManager::AcquireFrame(frame_id_t *frame_id, std::optional<std::future<bool>> *writeback,
+                                     lsn_t *wait_lsn, BufferRing *ring) -> bool {
+  // Let the replacer see the accesses made without the latch before it picks a victim.
+  DrainAccessLog();
+
+  std::deque<frame_id_t> *ring_frames = nullptr;
+  bool recycled = false;
+  if (ring != nullptr) {
+    ring_frames = &ring->frames_[this];
+    size_t share = (ring->GetNumFrames() + num_instances_ - 1) / num_instances_;
+    if (!ring_frames->empty() && ring_frames->size() >= share) {
+      frame_id_t oldest = ring_frames->front();
+      ring_frames->pop_front();
+      // Somebody else may have fetched the page since, or the ring may not have gotten to it yet. Either way the
+      // frame just leaves the ring and the ring takes a frame from the pool instead.
+      if (ring_of_[oldest] == ring && !prefetched_[oldest] && TryClaimVictim(oldest, wait_lsn)) {
+        replacer_->Remove(oldest);
+        *frame_id = oldest;
+        recycled = true;
+      }
+    }
+  }
+
+  if (!recycled && !free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+  } else {
+    auto claim = [this, wait_lsn](frame_id_t victim) { return TryClaimVictim(victim, wait_lsn); };
+    while (!recycled && !replacer_->Evict(frame_id, claim)) {
+      // Read-ahead pages nobody fetched yet are only given up when there is nothing else to evict.
+      if (read_ahead_.empty()) {
+        return false;
+      }
+      ReleaseReadAhead(read_ahead_.front());
+    }
+    evictions_++;
+    Page *victim = &pages_[*frame_id];
+    if (victim->IsDirty()) {
+      // WAL: TryClaimVictim() only takes dirty pages whose log records are on disk already. The write is scheduled
+      // while the latch is still held, so a later fetch of the victim page is queued behind it on the same disk worker
+      // and always reads the written-back data.
+      *writeback = ScheduleIO(true, victim->GetPageId(), victim->GetData());
+      victim->is_dirty_ = false;
+      foreground_writes_++;
+      // The page cleaner is falling behind.
+      if (cleaner_running_) {
+        cleaner_wakeup_ = true;
+        cleaner_cv_.notify_one();
+      }
+    }
+    page_table_.Erase(victim->GetPageId());
+  }
+
+  // The caller hands the frame to the ring once it is pinned.
+  ring_of_[*frame_id] = nullptr;
+  warm_[*frame_id] = false;
+  if (ring_frames != nullptr) {
+    ring_frames->push_back(*frame_id);
+  }
+  return true;
+}
+
+auto BufferPoolManager::IsLoading(frame_id_t frame_id) -> bool {
+  auto &pending = pending_io_[frame_id];
+  if (!pending.valid()) {
+    return false;
+  }
+  if (pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return true;
+  }
+  pending = std::shared_future<bool>();
+  return false;
+}
+
+void BufferPoolManager::ReleaseReadAhead(frame_id_t frame_id) {
+  if (pending_io_[frame_id].valid()) {
+    pending_io_[frame_id].wait();
+    pending_io_[frame_id] = std::shared_future<bool>();
+  }
+  prefetched_[frame_id] = false;
+  read_ahead_.remove(frame_id);
+  replacer_->SetEvictable(frame_id, true);
+}
+
+void BufferPoolManager::PinFrame(frame_id_t frame_id, AccessType access_type, BufferRing *ring) {
+  // Frames are never claimed while the latch is held by somebody else, so the pin count is not -1 here.
+  pages_[frame_id].pin_count_++;
+  warm_[frame_id] = false;
+  if (ring_of_[frame_id] != ring) {
+    // Somebody other than the ring that brought the page in uses it: it is part of the shared working set now.
+    ring_of_[frame_id] = nullptr;
+  }
+  if (prefetched_[frame_id]) {
+    // The read-ahead already recorded this access.
+    prefetched_[frame_id] = false;
+    read_ahead_.remove(frame_id);
+  } else if (ring_of_[frame_id] == nullptr) {
+    replacer_->RecordAccess(frame_id, access_type, pages_[frame_id].GetPageId());
+  }
+  // The replacer does not track pins (see TryClaim()), so every frame it knows of is evictable, read-ahead aside.
+  replacer_->SetEvictable(frame_id, true);
+}
 
-auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * { return nullptr; }
+auto BufferPoolManager::TryPinShared(page_id_t page_id) -> Page * {
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    return nullptr;
+  }
+  Page *page = &pages_[frame_id];
+  int pin_count = page->pin_count_;
+  do {
+    if (pin_count < 0) {
+      return nullptr;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+  // The page table entry may be stale, and the frame may have been claimed and given to another page since. Once
+  // pinned, it stays put, so check again.
+  if (!shared_[frame_id] || page->GetPageId() != page_id) {
+    page->pin_count_--;
+    return nullptr;
+  }
+  access_log_[access_tail_.fetch_add(1, std::memory_order_relaxed) & access_log_mask_].store(
+      frame_id, std::memory_order_relaxed);
+  return page;
+}
 
-auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
-  return nullptr;
+auto BufferPoolManager::TryClaim(frame_id_t frame_id) -> bool {
+  int unpinned = 0;
+  if (!pages_[frame_id].pin_count_.compare_exchange_strong(unpinned, -1)) {
+    return false;
+  }
+  shared_[frame_id] = false;
+  return true;
 }
 
-auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
+auto BufferPoolManager::TryClaimVictim(frame_id_t frame_id, lsn_t *wait_lsn) -> bool {
+  if (!TryClaim(frame_id)) {
+    return false;
+  }
+  Page *page = &pages_[frame_id];
+  if (log_manager_ == nullptr || !page->IsDirty()) {
+    return true;
+  }
+  // WAL: the log records of a page must reach the disk before the page does. Nobody has the page pinned now, so its
+  // LSN cannot change anymore; nothing beyond the last appended record can become persistent, though.
+  lsn_t lsn = std::min<lsn_t>(page->GetLSN(), log_manager_->GetNextLSN() - 1);
+  if (lsn <= log_manager_->GetPersistentLSN()) {
+    return true;
+  }
+  *wait_lsn = *wait_lsn == INVALID_LSN ? lsn : std::min(*wait_lsn, lsn);
+  page->pin_count_ = 0;
+  ShareFrame(frame_id);
+  return false;
+}
+
+void BufferPoolManager::WaitForLog(std::unique_lock<std::mutex> *lock, lsn_t lsn) {
+  lock->unlock();
+  log_manager_->WaitUntilPersistent(lsn);
+  lock->lock();
+}
+
+void BufferPoolManager::ShareFrame(frame_id_t frame_id) {
+  shared_[frame_id] = !prefetched_[frame_id] && ring_of_[frame_id] == nullptr && !IsLoading(frame_id);
+}
+
+void BufferPoolManager::DrainAccessLog() {
+  uint64_t tail = access_tail_.load(std::memory_order_relaxed);
+  // Older accesses than one lap of the log were overwritten.
+  for (uint64_t i = std::max(access_head_, tail - std::min(tail, access_log_mask_ + 1)); i < tail; i++) {
+    frame_id_t frame_id = access_log_[i & access_log_mask_].exchange(INVALID_PAGE_ID, std::memory_order_relaxed);
+    // The frame may have been reused since; its new page inherits the access, which is harmless.
+    if (frame_id != INVALID_PAGE_ID && shared_[frame_id]) {
+      replacer_->RecordAccess(frame_id, AccessType::Unknown, pages_[frame_id].GetPageId());
+      warm_[frame_id] = false;
+    }
+  }
+  access_head_ = tail;
+}
+
+auto BufferPoolManager::ScheduleIO(bool is_write, page_id_t page_id, char *data) -> std::future<bool> {
+  auto promise = disk_scheduler_->CreatePromise();
+  auto future = promise.get_future();
+  disk_scheduler_->Schedule({is_write, data, page_id, std::move(promise)});
+  return future;
+}
+
+void BufferPoolManager::FinishPendingIO(frame_id_t frame_id, std::promise<bool> *loaded) {
+  loaded->set_value(true);
+  std::scoped_lock<std::mutex> lock(latch_);
+  pending_io_[frame_id] = std::shared_future<bool>();
+  ShareFrame(frame_id);
+}
+
+auto BufferPoolManager::NewPage(page_id_t *page_id, BufferRing *ring, page_id_t near_page_id) -> Page * {
+  if (free_space_map_ == nullptr) {
+    Page *page = CreatePage(INVALID_PAGE_ID, ring);
+    if (page != nullptr) {
+      *page_id = page->GetPageId();
+    }
+    return page;
+  }
+
+  // The map fetches its own pages through this buffer pool, so the page id is allocated before taking the latch.
+  page_id_t new_page_id = free_space_map_->Allocate(near_page_id);
+  if (new_page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  Page *page = CreatePage(new_page_id, ring);
+  if (page == nullptr) {
+    free_space_map_->Free(new_page_id);
+    return nullptr;
+  }
+  RaiseNextPageId(new_page_id);
+  *page_id = new_page_id;
+  return page;
+}
+
+auto BufferPoolManager::AllocateExtent(size_t num_pages, page_id_t near_page_id) -> std::vector<page_id_t> {
+  std::vector<page_id_t> page_ids;
+  if (free_space_map_ != nullptr) {
+    page_ids = free_space_map_->AllocateRun(num_pages, near_page_id);
+    if (page_ids.empty()) {
+      return page_ids;
+    }
+    RaiseNextPageId(page_ids.back());
+  } else {
+    std::scoped_lock<std::mutex> lock(latch_);
+    page_ids.reserve(num_pages);
+    for (size_t i = 0; i < num_pages; i++) {
+      page_ids.push_back(AllocatePage());
+    }
+  }
+  disk_manager_->AllocateExtent(page_ids.front(), page_ids.back() - page_ids.front() + 1);
+  return page_ids;
+}
+
+auto BufferPoolManager::NewPageAt(page_id_t page_id, BufferRing *ring) -> Page * {
+  BUSTUB_ASSERT(page_id >= 0 && page_id < next_page_id_, "page was not reserved");
+  return CreatePage(page_id, ring);
+}
+
+void BufferPoolManager::RaiseNextPageId(page_id_t page_id) {
+  // Let read-ahead reach the page.
+  page_id_t next_page_id = next_page_id_;
+  while (next_page_id <= page_id &&
+         !next_page_id_.compare_exchange_weak(next_page_id, page_id + static_cast<page_id_t>(num_instances_))) {
+  }
+}
+
+auto BufferPoolManager::CreatePage(page_id_t page_id, BufferRing *ring) -> Page * {
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  std::optional<std::future<bool>> writeback;
+  while (true) {
+    if (page_id != INVALID_PAGE_ID && page_table_.Find(page_id, &frame_id)) {
+      // A reused page id whose old page is still around, e.g. because it was read ahead after it was deleted.
+      if (prefetched_[frame_id]) {
+        ReleaseReadAhead(frame_id);
+      }
+      if (IsLoading(frame_id) || !TryClaim(frame_id)) {
+        return nullptr;
+      }
+      DiscardFrame(frame_id);
+    }
+    lsn_t wait_lsn = INVALID_LSN;
+    if (AcquireFrame(&frame_id, &writeback, &wait_lsn, ring)) {
+      break;
+    }
+    if (wait_lsn == INVALID_LSN) {
+      return nullptr;
+    }
+    WaitForLog(&lock, wait_lsn);
+  }
+
+  if (page_id == INVALID_PAGE_ID) {
+    page_id = AllocatePage();
+  }
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->pin_count_ = 0;
+  page->is_dirty_ = false;
+  page->rec_lsn_ = INVALID_LSN;
+  page_table_.Insert(page_id, frame_id);
+  PinFrame(frame_id, ring == nullptr ? AccessType::Unknown : AccessType::Scan);
+  if (AccessTrace *trace = access_trace_.load(); trace != nullptr) {
+    trace->Record(page_id, ring == nullptr ? AccessType::Unknown : AccessType::Scan, true);
+  }
+  ring_of_[frame_id] = ring;
+  if (!writeback.has_value()) {
+    page->ResetMemory();
+    ShareFrame(frame_id);
+    return page;
+  }
+
+  // The frame still holds the victim's data until its write-back completes. Wait for it without the latch; anybody
+  // fetching the new page meanwhile waits on pending_io_.
+  std::promise<bool> loaded;
+  pending_io_[frame_id] = loaded.get_future().share();
+  lock.unlock();
+  writeback->wait();
+  page->ResetMemory();
+  FinishPendingIO(frame_id, &loaded);
+  return page;
+}
+
+auto BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type, BufferRing *ring) -> Page * {
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  if (AccessTrace *trace = access_trace_.load(); trace != nullptr) {
+    trace->Record(page_id, access_type);
+  }
+  if (ring == nullptr) {
+    Page *page = TryPinShared(page_id);
+    if (page != nullptr) {
+      hits_[static_cast<size_t>(access_type)]++;
+      return page;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  std::optional<std::future<bool>> writeback;
+  while (true) {
+    if (page_table_.Find(page_id, &frame_id)) {
+      hits_[static_cast<size_t>(access_type)]++;
+      PinFrame(frame_id, access_type, ring);
+      if (IsLoading(frame_id)) {
+        // Another thread is still bringing this page in: share its read instead of issuing a second one.
+        auto pending = pending_io_[frame_id];
+        lock.unlock();
+        pending.wait();
+      } else {
+        ShareFrame(frame_id);
+      }
+      return &pages_[frame_id];
+    }
+
+    lsn_t wait_lsn = INVALID_LSN;
+    if (AcquireFrame(&frame_id, &writeback, &wait_lsn, ring)) {
+      break;
+    }
+    if (wait_lsn == INVALID_LSN) {
+      misses_[static_cast<size_t>(access_type)]++;
+      return nullptr;
+    }
+    // Somebody may fetch the page while we wait for the log, so look it up again afterwards.
+    WaitForLog(&lock, wait_lsn);
+  }
+  misses_[static_cast<size_t>(access_type)]++;
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->pin_count_ = 0;
+  page->is_dirty_ = false;
+  page->rec_lsn_ = INVALID_LSN;
+  page_table_.Insert(page_id, frame_id);
+  PinFrame(frame_id, access_type);
+  ring_of_[frame_id] = ring;
+
+  // Publish the frame as in flight and do the I/O without holding the latch.
+  std::promise<bool> loaded;
+  pending_io_[frame_id] = loaded.get_future().share();
+  lock.unlock();
+  if (writeback.has_value()) {
+    writeback->wait();
+  }
+  ScheduleIO(false, page_id, page->GetData()).wait();
+  FinishPendingIO(frame_id, &loaded);
+  return page;
+}
+
+auto BufferPoolManager::PrefetchPage(page_id_t page_id, BufferRing *ring) -> bool {
+  // Never read ahead a page that has not been allocated yet.
+  if (page_id < 0 || page_id >= next_page_id_) {
+    return false;
+  }
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (page_table_.Find(page_id, &frame_id)) {
+    return !IsLoading(frame_id);
+  }
+  // Keep read-ahead from taking over the pool, e.g. when scans are abandoned halfway.
+  if (read_ahead_.size() >= std::max<size_t>(pool_size_ / 2, 1)) {
+    ReleaseReadAhead(read_ahead_.front());
+  }
+
+  // Read-ahead is not worth waiting for the log.
+  std::optional<std::future<bool>> writeback;
+  lsn_t wait_lsn = INVALID_LSN;
+  if (!AcquireFrame(&frame_id, &writeback, &wait_lsn, ring)) {
+    return false;
+  }
+  if (writeback.has_value()) {
+    // The frame is in neither the page table, the free list nor the replacer, so nobody else can touch it while we
+    // wait without the latch. Somebody may fetch the page meanwhile, though.
+    lock.unlock();
+    writeback->wait();
+    lock.lock();
+    frame_id_t resident_frame_id;
+    if (page_table_.Find(page_id, &resident_frame_id)) {
+      free_list_.push_back(frame_id);
+      return false;
+    }
+  }
+
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->pin_count_ = 0;
+  page->is_dirty_ = false;
+  page->rec_lsn_ = INVALID_LSN;
+  page_table_.Insert(page_id, frame_id);
+  replacer_->RecordAccess(frame_id, AccessType::Scan, page_id);
+  replacer_->SetEvictable(frame_id, false);
+  prefetched_[frame_id] = true;
+  ring_of_[frame_id] = ring;
+  pending_io_[frame_id] = ScheduleIO(false, page_id, page->GetData()).share();
+  read_ahead_.push_back(frame_id);
   return false;
 }
 
-auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool { return false; }
+auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    // A lookup without the latch can miss a page whose entry is being moved; only a miss under the latch is final.
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (!page_table_.Find(page_id, &frame_id)) {
+      return false;
+    }
+  }
+  Page *page = &pages_[frame_id];
+  int pin_count = page->pin_count_;
+  do {
+    if (pin_count <= 0 || page->GetPageId() != page_id) {
+      return false;
+    }
+    // Mark the page dirty while still pinned: once unpinned, the frame may be claimed by somebody else.
+    if (is_dirty) {
+      page->is_dirty_ = true;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+  return true;
+}
+
+auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "cannot flush an invalid page");
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    return false;
+  }
+  Page *page = &pages_[frame_id];
+
+  // Keep the frame from being reused while the write is in flight, without counting it as an access.
+  page->pin_count_++;
+  auto pending = pending_io_[frame_id];
+  lock.unlock();
+
+  if (pending.valid()) {
+    pending.wait();
+  }
+  // A page that is write-latched right now may be half changed: wait for the writer rather than write it torn.
+  page->RLatch();
+  // WAL: the log records of a page must reach the disk before the page does.
+  if (log_manager_ != nullptr) {
+    log_manager_->WaitUntilPersistent(page->GetLSN());
+  }
+  page->is_dirty_ = false;
+  ScheduleIO(true, page_id, page->GetData()).wait();
+  page->rec_lsn_ = INVALID_LSN;
+  page->RUnlatch();
+  page->pin_count_--;
+  return true;
+}
+
+void BufferPoolManager::FlushAllPages() {
+  std::vector<Page *> pages = PinDirtyPages();
+  WriteBackPages(&pages);
+}
+
+auto BufferPoolManager::PinDirtyPages() -> std::vector<Page *> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<Page *> pages;
+  for (frame_id_t frame_id = 0; frame_id < static_cast<frame_id_t>(pool_size_); frame_id++) {
+    // Free frames hold no page. Frames with I/O in flight were just read from disk or are new pages being zeroed;
+    // neither has anything to flush yet.
+    Page *page = &pages_[frame_id];
+    if (page->pin_count_ < 0 || !page->IsDirty() || IsLoading(frame_id)) {
+      continue;
+    }
+    // Keep the frame from being reused while the write is in flight, without counting it as an access.
+    page->pin_count_++;
+    pages.push_back(page);
+  }
+  return pages;
+}
+
+void BufferPoolManager::WriteBackPages(std::vector<Page *> *pages) {
+  std::sort(pages->begin(), pages->end(),
+            [](Page *left, Page *right) { return left->GetPageId() < right->GetPageId(); });
+  // As in FlushPage(), only the pages latched for their write are written; the others stay dirty for the next flush.
+  std::vector<Page *> latched;
+  lsn_t max_lsn = INVALID_LSN;
+  for (Page *page : *pages) {
+    if (page->TryRLatch()) {
+      latched.push_back(page);
+      max_lsn = std::max(max_lsn, page->GetLSN());
+    }
+  }
+  // WAL: the log records of the pages must reach the disk before the pages do.
+  if (log_manager_ != nullptr) {
+    log_manager_->WaitUntilPersistent(max_lsn);
+  }
+  for (Page *page : latched) {
+    page->is_dirty_ = false;
+  }
+  std::vector<std::future<bool>> writes;
+  for (size_t first = 0; first < latched.size();) {
+    Page *page = latched[first];
+    DiskRequest request{true, page->GetData(), page->GetPageId(), disk_scheduler_->CreatePromise()};
+    size_t end = first + 1;
+    while (end < latched.size() && end - first < WRITEBACK_MAX_RUN_PAGES &&
+           latched[end]->GetPageId() == page->GetPageId() + static_cast<page_id_t>(end - first)) {
+      request.run_.push_back(latched[end]->GetData());
+      end++;
+    }
+    writes.emplace_back(request.callback_.get_future());
+    disk_scheduler_->Schedule(std::move(request));
+    first = end;
+  }
+  // Issue all writes at once so the disk workers can overlap them, and sync once they are all done.
+  for (auto &write : writes) {
+    write.wait();
+  }
+  if (!writes.empty()) {
+    disk_manager_->SyncPages();
+  }
+  for (Page *page : latched) {
+    page->rec_lsn_ = INVALID_LSN;
+    page->RUnlatch();
+  }
+  for (Page *page : *pages) {
+    page->pin_count_--;
+  }
+}
+
+auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
+  if (free_space_map_ != nullptr && free_space_map_->IsMapPage(page_id)) {
+    return false;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    frame_id_t frame_id;
+    if (page_table_.Find(page_id, &frame_id)) {
+      if (IsLoading(frame_id) || !TryClaim(frame_id)) {
+        return false;
+      }
+      DiscardFrame(frame_id);
+    }
+  }
+  DeallocatePage(page_id);
+  return true;
+}
+
+void BufferPoolManager::DiscardFrame(frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  if (prefetched_[frame_id]) {
+    ReleaseReadAhead(frame_id);
+  }
+  page_table_.Erase(page->page_id_);
+  replacer_->Remove(frame_id);
+  free_list_.push_back(frame_id);
+  page->ResetMemory();
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  page->rec_lsn_ = INVALID_LSN;
+}
+
+auto BufferPoolManager::GetHitCount(AccessType access_type) -> uint64_t {
+  return hits_[static_cast<size_t>(access_type)];
+}
+
+auto BufferPoolManager::GetMissCount(AccessType access_type) -> uint64_t {
+  return misses_[static_cast<size_t>(access_type)];
+}
+
+void BufferPoolManager::RunPageCleaner(size_t pages_per_round, std::chrono::milliseconds interval,
+                                       size_t target_clean_percent) {
+  if (cleaner_running_) {
+    return;
+  }
+  cleaner_pages_per_round_ = pages_per_round;
+  cleaner_interval_ = interval;
+  cleaner_target_clean_percent_ = std::min<size_t>(target_clean_percent, 100);
+  cleaner_running_ = true;
+  cleaner_thread_ = std::thread([this] {
+    std::unique_lock<std::mutex> lock(cleaner_mutex_);
+    while (cleaner_running_) {
+      lock.unlock();
+      CleanDirtyPages();
+      lock.lock();
+      cleaner_cv_.wait_for(lock, cleaner_interval_, [this] { return !cleaner_running_ || cleaner_wakeup_; });
+      cleaner_wakeup_ = false;
+    }
+  });
+}
+
+void BufferPoolManager::StopPageCleaner() {
+  if (!cleaner_running_) {
+    return;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(cleaner_mutex_);
+    cleaner_running_ = false;
+  }
+  cleaner_cv_.notify_one();
+  cleaner_thread_.join();
+}
+
+auto BufferPoolManager::CleanDirtyPages() -> size_t {
+  std::vector<frame_id_t> frames;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    DrainAccessLog();
+    size_t target = pool_size_ * cleaner_target_clean_percent_ / 100;
+    if (free_list_.size() >= target) {
+      return 0;
+    }
+    for (frame_id_t frame_id : replacer_->GetEvictionCandidates(target - free_list_.size())) {
+      if (frames.size() >= cleaner_pages_per_round_) {
+        break;
+      }
+      Page *page = &pages_[frame_id];
+      if (!page->IsDirty() || page->pin_count_ > 0 || IsLoading(frame_id)) {
+        continue;
+      }
+      // Pin the frame so it is not reused while we write it, without counting it as an access.
+      page->pin_count_++;
+      frames.push_back(frame_id);
+    }
+  }
+  if (frames.empty()) {
+    return 0;
+  }
+
+  // Never wait for a page latch: its holder may be waiting for our latch_, or hold the latch of another of our pages.
+  // A page that is write-latched right now is about to be dirty again anyway.
+  std::vector<frame_id_t> latched;
+  for (frame_id_t frame_id : frames) {
+    Page *page = &pages_[frame_id];
+    if (!page->TryRLatch()) {
+      continue;
+    }
+    // WAL: the log records of a page must reach the disk before the page does.
+    if (enable_logging && log_manager_ != nullptr && page->GetLSN() > log_manager_->GetPersistentLSN()) {
+      page->RUnlatch();
+      continue;
+    }
+    latched.push_back(frame_id);
+  }
+
+  std::vector<std::future<bool>> writes;
+  writes.reserve(latched.size());
+  {
+    // Nobody can change the latched pages until their writes are done, so they are clean from here on.
+    std::scoped_lock<std::mutex> lock(latch_);
+    for (frame_id_t frame_id : latched) {
+      Page *page = &pages_[frame_id];
+      writes.emplace_back(ScheduleIO(true, page->GetPageId(), page->GetData()));
+      page->is_dirty_ = false;
+      page->rec_lsn_ = INVALID_LSN;
+    }
+  }
+  for (auto &write : writes) {
+    write.wait();
+  }
+  for (frame_id_t frame_id : latched) {
+    pages_[frame_id].RUnlatch();
+  }
+
+  for (frame_id_t frame_id : frames) {
+    pages_[frame_id].pin_count_--;
+  }
+  cleaner_writes_ += writes.size();
+  return writes.size();
+}
+
+auto BufferPoolManager::GetEvictionCount() -> uint64_t { return evictions_; }
+
+auto BufferPoolManager::GetForegroundWriteCount() -> uint64_t { return foreground_writes_; }
+
+auto BufferPoolManager::GetCleanerWriteCount() -> uint64_t { return cleaner_writes_; }
+
+void BufferPoolManager::SetAccessTrace(AccessTrace *trace) { access_trace_ = trace; }
+
+void BufferPoolManager::EnableFreeSpaceMap() {
+  free_space_map_ = std::make_unique<FreeSpaceMap>(this, num_instances_, instance_index_);
+  next_page_id_ = free_space_map_->Open();
+}
+
+void BufferPoolManager::EnableWarmRestart(const std::string &path, std::chrono::milliseconds snapshot_interval) {
+  if (warm_restart_running_) {
+    return;
+  }
+  warm_restart_path_ = path;
+  warm_restart_interval_ = snapshot_interval;
+  warm_restart_running_ = true;
+  warming_up_ = true;
+  warm_restart_thread_ = std::thread([this] {
+    WarmUp(ReadPageList(warm_restart_path_), &warm_restart_running_);
+    warming_up_ = false;
+    // Snapshots only start after the warm-up, which would otherwise save a half-loaded pool.
+    std::unique_lock<std::mutex> lock(warm_restart_mutex_);
+    while (warm_restart_running_) {
+      warm_restart_cv_.wait_for(lock, warm_restart_interval_, [this] { return !warm_restart_running_; });
+      if (warm_restart_running_) {
+        lock.unlock();
+        WritePageList(warm_restart_path_, GetResidentPages());
+        lock.lock();
+      }
+    }
+  });
+}
+
+void BufferPoolManager::StopWarmRestart() {
+  if (!warm_restart_running_) {
+    return;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(warm_restart_mutex_);
+    warm_restart_running_ = false;
+  }
+  warm_restart_cv_.notify_one();
+  warm_restart_thread_.join();
+  WritePageList(warm_restart_path_, GetResidentPages());
+}
 
-void BufferPoolManager::FlushAllPages() {}
+auto BufferPoolManager::GetResidentPages() -> std::vector<page_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  DrainAccessLog();
+  std::vector<page_id_t> page_ids;
+  // Read-ahead pages nobody fetched yet are not evictable, and not worth keeping either.
+  for (frame_id_t frame_id : replacer_->GetEvictionCandidates(pool_size_)) {
+    if (pages_[frame_id].GetPageId() != INVALID_PAGE_ID) {
+      page_ids.push_back(pages_[frame_id].GetPageId());
+    }
+  }
+  return page_ids;
+}
+
+auto BufferPoolManager::GetDirtyPageTable() -> std::vector<std::pair<page_id_t, lsn_t>> {
+  std::vector<std::pair<page_id_t, lsn_t>> dirty_pages;
+  std::vector<std::shared_future<bool>> loading;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    for (frame_id_t frame_id = 0; frame_id < static_cast<frame_id_t>(pool_size_); frame_id++) {
+      // A frame being loaded may still be writing back the page evicted from it.
+      if (IsLoading(frame_id)) {
+        loading.push_back(pending_io_[frame_id]);
+        continue;
+      }
+      Page *page = &pages_[frame_id];
+      lsn_t rec_lsn = page->GetRecLSN();
+      if (page->pin_count_ >= 0 && rec_lsn != INVALID_LSN) {
+        dirty_pages.emplace_back(page->GetPageId(), rec_lsn);
+      }
+    }
+  }
+  for (auto &load : loading) {
+    load.wait();
+  }
+  return dirty_pages;
+}
+
+auto BufferPoolManager::WarmUp(const std::vector<page_id_t> &page_ids, const std::atomic<bool> *running) -> size_t {
+  // The hottest pages of this instance that are not resident yet and fit into the free frames, coldest first.
+  std::vector<page_id_t> ranked;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    for (page_id_t page_id : page_ids) {
+      frame_id_t frame_id;
+      if (page_id >= 0 && page_id < next_page_id_ &&
+          static_cast<uint32_t>(page_id) % num_instances_ == instance_index_ && !page_table_.Find(page_id, &frame_id)) {
+        ranked.push_back(page_id);
+      }
+    }
+    ranked.erase(ranked.begin(), ranked.end() - std::min(ranked.size(), free_list_.size()));
+  }
+
+  // Read them in page id order, so that the reads are mostly sequential, a batch at a time, so that the warm-up never
+  // holds many frames pinned. Queries keep running meanwhile: a page they need is either loaded already, is being
+  // loaded and waited for, or is read by the query itself and then skipped here.
+  std::vector<page_id_t> sorted = ranked;
+  std::sort(sorted.begin(), sorted.end());
+  size_t loaded = 0;
+  bool out_of_frames = false;
+  for (size_t first = 0; first < sorted.size() && !out_of_frames && (running == nullptr || *running);
+       first += WARM_RESTART_BATCH_PAGES) {
+    std::vector<frame_id_t> frames;
+    std::vector<std::promise<bool>> promises;
+    promises.reserve(WARM_RESTART_BATCH_PAGES);
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      for (size_t i = first; i < std::min<size_t>(first + WARM_RESTART_BATCH_PAGES, sorted.size()); i++) {
+        frame_id_t frame_id;
+        if (page_table_.Find(sorted[i], &frame_id)) {
+          continue;
+        }
+        // Never evict anything for the warm-up.
+        if (free_list_.empty()) {
+          out_of_frames = true;
+          break;
+        }
+        frame_id = free_list_.front();
+        free_list_.pop_front();
+        Page *page = &pages_[frame_id];
+        page->page_id_ = sorted[i];
+        page->pin_count_ = 1;
+        page->is_dirty_ = false;
+        page->rec_lsn_ = INVALID_LSN;
+        page_table_.Insert(sorted[i], frame_id);
+        ring_of_[frame_id] = nullptr;
+        replacer_->RecordAccess(frame_id, AccessType::Unknown, sorted[i]);
+        replacer_->SetEvictable(frame_id, true);
+        warm_[frame_id] = true;
+        pending_io_[frame_id] = promises.emplace_back().get_future().share();
+        frames.push_back(frame_id);
+      }
+    }
+    std::vector<std::future<bool>> reads;
+    reads.reserve(frames.size());
+    for (frame_id_t frame_id : frames) {
+      reads.emplace_back(ScheduleIO(false, pages_[frame_id].GetPageId(), pages_[frame_id].GetData()));
+    }
+    for (size_t i = 0; i < frames.size(); i++) {
+      reads[i].wait();
+      FinishPendingIO(frames[i], &promises[i]);
+      pages_[frames[i]].pin_count_--;
+    }
+    loaded += frames.size();
+  }
+
+  // The pages were first accessed in page id order. Replay the saved eviction order on those that nobody accessed
+  // since; the pages the queries did access are hotter than all of them now.
+  std::scoped_lock<std::mutex> lock(latch_);
+  DrainAccessLog();
+  for (page_id_t page_id : ranked) {
+    frame_id_t frame_id;
+    if (!page_table_.Find(page_id, &frame_id) || !warm_[frame_id]) {
+      continue;
+    }
+    warm_[frame_id] = false;
+    replacer_->Remove(frame_id);
+    replacer_->RecordAccess(frame_id, AccessType::Unknown, page_id);
+    replacer_->SetEvictable(frame_id, true);
+  }
+  return loaded;
+}
+
+void BufferPoolManager::DeallocatePage(page_id_t page_id) {
+  if (free_space_map_ != nullptr) {
+    free_space_map_->Free(page_id);
+  }
+}
 
-auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool { return false; }
+auto BufferPoolManager::AllocatePage() -> page_id_t {
+  const page_id_t next_page_id = next_page_id_;
+  next_page_id_ += num_instances_;
+  ValidatePageId(next_page_id);
+  return next_page_id;
+}
 
-auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
+void BufferPoolManager::ValidatePageId(const page_id_t page_id) const {
+  assert(page_id % num_instances_ == instance_index_);  // allocated pages mod back to this BPI
+}
 
-auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard { return {this, nullptr}; }
+auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard {
+  return {this, FetchPage(page_id)};
+}
 
-auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard { return {this, nullptr}; }
+auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
+  Page *page = FetchPage(page_id);
+  if (page != nullptr) {
+    page->RLatch();
+  }
+  return {this, page};
+}
 
-auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard { return {this, nullptr}; }
+auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
+  Page *page = FetchPage(page_id);
+  if (page != nullptr) {
+    page->WLatch();
+  }
+  return {this, page};
+}
 
-auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard { return {this, nullptr}; }
+auto BufferPoolManager::NewPageGuarded(page_id_t *page_id, page_id_t near_page_id) -> BasicPageGuard {
+  return {this, NewPage(page_id, nullptr, near_page_id)};
+}
 
 }  // namespace bustub
@@ -0,0 +1,300 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_pro_replacer.cpp
+//
+// Identification: src/buffer/clock_pro_replacer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/clock_pro_replacer.h"
+
+#include "common/exception.h"
+
+namespace bustub {
+
+ClockProReplacer::ClockProReplacer(size_t num_frames)
+    : capacity_(num_frames),
+      frames_(num_frames),
+      hand_hot_(clock_.end()),
+      hand_cold_(clock_.end()),
+      hand_test_(clock_.end()) {}
+
+auto ClockProReplacer::Evict(frame_id_t *frame_id) -> bool {
+  return Evict(frame_id, [](frame_id_t) { return true; });
+}
+
+auto ClockProReplacer::Evict(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &try_evict) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+
+  // Every lap of hand_cold without a victim turns one more hot page cold. The number of laps is bounded so that a
+  // clock of pinned pages cannot keep us here; what is left is handled by the sweep below.
+  size_t steps = 0;
+  size_t max_steps = 4 * clock_.size();
+  while (steps++ < max_steps && hand_cold_ != clock_.end()) {
+    if (steps % clock_.size() == 0) {
+      RunHandHot();
+    }
+    EntryIter it = hand_cold_;
+    Entry &entry = *it;
+    if (entry.hot_ || entry.frame_id_ < 0 || !frames_[entry.frame_id_].is_evictable_) {
+      hand_cold_ = Next(it);
+      continue;
+    }
+    if (entry.ref_) {
+      entry.ref_ = false;
+      if (entry.test_) {
+        entry.hot_ = true;
+        entry.test_ = false;
+        hot_count_++;
+      } else {
+        entry.test_ = true;
+      }
+      MoveToHead(it);
+      if (hot_count_ > capacity_ - cold_target_) {
+        RunHandHot();
+      }
+      continue;
+    }
+    if (!try_evict(entry.frame_id_)) {
+      hand_cold_ = Next(it);
+      continue;
+    }
+    *frame_id = entry.frame_id_;
+    hand_cold_ = Next(it);
+    EvictEntry(it);
+    return true;
+  }
+
+  // Only hot or refused frames are left: take any frame try_evict agrees to.
+  for (auto it = clock_.begin(); it != clock_.end(); ++it) {
+    if (it->frame_id_ >= 0 && frames_[it->frame_id_].is_evictable_ && try_evict(it->frame_id_)) {
+      *frame_id = it->frame_id_;
+      EvictEntry(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+auto ClockProReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  if (clock_.empty()) {
+    return candidates;
+  }
+  // Unreferenced cold pages from hand_cold on, then referenced cold pages, then hot pages.
+  for (int pass = 0; pass < 3; pass++) {
+    EntryIter it = hand_cold_;
+    for (size_t i = 0; i < clock_.size() && candidates.size() < max_frames; i++, it = Next(it)) {
+      if (it->frame_id_ < 0 || !frames_[it->frame_id_].is_evictable_) {
+        continue;
+      }
+      int category = it->hot_ ? 2 : (it->ref_ ? 1 : 0);
+      if (category == pass) {
+        candidates.push_back(it->frame_id_);
+      }
+    }
+  }
+  return candidates;
+}
+
+void ClockProReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type,
+                                    page_id_t page_id) {
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < capacity_, "frame id is out of range");
+  std::scoped_lock<std::mutex> lock(latch_);
+  FrameNode &node = frames_[frame_id];
+  if (node.tracked_) {
+    node.pos_->ref_ = true;
+    if (page_id != INVALID_PAGE_ID) {
+      node.pos_->page_id_ = page_id;
+    }
+    return;
+  }
+
+  auto ghost = page_id == INVALID_PAGE_ID ? non_resident_.end() : non_resident_.find(page_id);
+  if (ghost != non_resident_.end()) {
+    // The page came back during its test: cold pages were evicted too early.
+    RemoveEntry(ghost->second);
+    GrowColdTarget();
+    node.pos_ = InsertAtHead(Entry{page_id, frame_id, true, false, false});
+    hot_count_++;
+  } else {
+    node.pos_ = InsertAtHead(Entry{page_id, frame_id, false, false, true});
+  }
+  node.tracked_ = true;
+  node.is_evictable_ = false;
+  if (hot_count_ > capacity_ - cold_target_) {
+    RunHandHot();
+  }
+}
+
+void ClockProReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < capacity_, "frame id is out of range");
+  std::scoped_lock<std::mutex> lock(latch_);
+  FrameNode &node = frames_[frame_id];
+  if (!node.tracked_ || node.is_evictable_ == set_evictable) {
+    return;
+  }
+  node.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void ClockProReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  FrameNode &node = frames_[frame_id];
+  if (!node.tracked_) {
+    return;
+  }
+  BUSTUB_ENSURE(node.is_evictable_, "cannot remove a non-evictable frame");
+  EntryIter it = node.pos_;
+  if (it->hot_) {
+    hot_count_--;
+  }
+  node = FrameNode();
+  curr_size_--;
+  RemoveEntry(it);
+}
+
+auto ClockProReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+auto ClockProReplacer::GetColdTarget() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return cold_target_;
+}
+
+auto ClockProReplacer::Next(EntryIter it) -> EntryIter {
+  ++it;
+  return it == clock_.end() ? clock_.begin() : it;
+}
+
+auto ClockProReplacer::InsertAtHead(const Entry &entry) -> EntryIter {
+  if (clock_.empty()) {
+    clock_.push_back(entry);
+    hand_hot_ = hand_cold_ = hand_test_ = clock_.begin();
+    return clock_.begin();
+  }
+  // Inserting before begin() appends to the clock, which is still right behind hand_hot.
+  return clock_.insert(hand_hot_ == clock_.begin() ? clock_.end() : hand_hot_, entry);
+}
+
+void ClockProReplacer::MoveToHead(EntryIter it) {
+  if (clock_.size() == 1) {
+    return;
+  }
+  for (EntryIter *hand : {&hand_hot_, &hand_cold_, &hand_test_}) {
+    if (*hand == it) {
+      *hand = Next(it);
+    }
+  }
+  clock_.splice(hand_hot_ == clock_.begin() ? clock_.end() : hand_hot_, clock_, it);
+}
+
+void ClockProReplacer::RemoveEntry(EntryIter it) {
+  if (clock_.size() == 1) {
+    hand_hot_ = hand_cold_ = hand_test_ = clock_.end();
+  } else {
+    for (EntryIter *hand : {&hand_hot_, &hand_cold_, &hand_test_}) {
+      if (*hand == it) {
+        *hand = Next(it);
+      }
+    }
+  }
+  if (it->frame_id_ < 0) {
+    non_resident_.erase(it->page_id_);
+  }
+  clock_.erase(it);
+  if (clock_.empty()) {
+    hand_hot_ = hand_cold_ = hand_test_ = clock_.end();
+  }
+}
+
+void ClockProReplacer::EvictEntry(EntryIter it) {
+  frames_[it->frame_id_] = FrameNode();
+  curr_size_--;
+  if (it->hot_) {
+    hot_count_--;
+    RemoveEntry(it);
+    return;
+  }
+  if (!it->test_ || it->page_id_ == INVALID_PAGE_ID || non_resident_.count(it->page_id_) != 0) {
+    RemoveEntry(it);
+    return;
+  }
+  it->frame_id_ = -1;
+  it->ref_ = false;
+  non_resident_[it->page_id_] = it;
+  RunHandTest();
+}
+
+void ClockProReplacer::RunHandHot() {
+  size_t max_steps = 2 * clock_.size();
+  for (size_t steps = 0; steps < max_steps && hot_count_ > 0 && hand_hot_ != clock_.end(); steps++) {
+    EntryIter it = hand_hot_;
+    if (it->hot_) {
+      hand_hot_ = Next(it);
+      if (it->ref_) {
+        it->ref_ = false;
+        continue;
+      }
+      it->hot_ = false;
+      hot_count_--;
+      return;
+    }
+    if (it->frame_id_ < 0) {
+      // A non-resident page whose test ends without it coming back.
+      RemoveEntry(it);
+      ShrinkColdTarget();
+      continue;
+    }
+    if (it->test_) {
+      it->test_ = false;
+      ShrinkColdTarget();
+    }
+    hand_hot_ = Next(it);
+  }
+}
+
+void ClockProReplacer::RunHandTest() {
+  size_t max_steps = 2 * clock_.size();
+  for (size_t steps = 0; steps < max_steps && non_resident_.size() > capacity_; steps++) {
+    EntryIter it = hand_test_;
+    if (it->frame_id_ < 0) {
+      RemoveEntry(it);
+      ShrinkColdTarget();
+      continue;
+    }
+    if (!it->hot_ && it->test_) {
+      it->test_ = false;
+      ShrinkColdTarget();
+    }
+    hand_test_ = Next(it);
+  }
+}
+
+void ClockProReplacer::GrowColdTarget() {
+  if (cold_target_ + 1 < capacity_) {
+    cold_target_++;
+  }
+}
+
+void ClockProReplacer::ShrinkColdTarget() {
+  if (cold_target_ > 1) {
+    cold_target_--;
+  }
+}
+
+}  // namespace bustub
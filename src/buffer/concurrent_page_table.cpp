@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table.cpp
+//
+// Identification: src/buffer/concurrent_page_table.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/concurrent_page_table.h"
+
+namespace bustub {
+
+ConcurrentPageTable::ConcurrentPageTable(size_t max_entries) {
+  // Keep the load factor at or below 1/2 so that probe sequences stay short.
+  size_t num_slots = 2;
+  while (num_slots < 2 * max_entries) {
+    num_slots *= 2;
+  }
+  mask_ = num_slots - 1;
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(num_slots);
+  for (size_t i = 0; i < num_slots; i++) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+auto ConcurrentPageTable::HomeOf(page_id_t page_id) const -> size_t {
+  // Page ids are dense, and those of one instance of a parallel buffer pool are strided. Fibonacci hashing spreads
+  // both evenly over the table.
+  return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL >> 32) & mask_;
+}
+
+auto ConcurrentPageTable::Find(page_id_t page_id, frame_id_t *frame_id) const -> bool {
+  for (size_t i = HomeOf(page_id), probes = 0; probes <= mask_; i = (i + 1) & mask_, probes++) {
+    uint64_t slot = slots_[i].load(std::memory_order_acquire);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (PageOf(slot) == page_id) {
+      *frame_id = FrameOf(slot);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ConcurrentPageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  size_t i = HomeOf(page_id);
+  while (true) {
+    uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT || PageOf(slot) == page_id) {
+      BUSTUB_ASSERT(slot != EMPTY_SLOT || size_ <= mask_ / 2, "page table holds more entries than it was sized for");
+      size_ += slot == EMPTY_SLOT ? 1 : 0;
+      slots_[i].store(MakeSlot(page_id, frame_id), std::memory_order_release);
+      return;
+    }
+    i = (i + 1) & mask_;
+  }
+}
+
+auto ConcurrentPageTable::Erase(page_id_t page_id) -> bool {
+  size_t hole = HomeOf(page_id);
+  while (true) {
+    uint64_t slot = slots_[hole].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (PageOf(slot) == page_id) {
+      break;
+    }
+    hole = (hole + 1) & mask_;
+  }
+
+  // Move every later entry of the cluster that may not sit behind the hole back into it, so that lookups never
+  // stop early at the hole.
+  for (size_t i = (hole + 1) & mask_;; i = (i + 1) & mask_) {
+    uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      break;
+    }
+    size_t home = HomeOf(PageOf(slot));
+    // The entry at i can stay if its home lies cyclically in (hole, i].
+    bool stays = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+    if (!stays) {
+      slots_[hole].store(slot, std::memory_order_release);
+      hole = i;
+    }
+  }
+  slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+  size_--;
+  return true;
+}
+
+}  // namespace bustub
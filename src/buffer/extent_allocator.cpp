@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extent_allocator.cpp
+//
+// Identification: src/buffer/extent_allocator.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/extent_allocator.h"
+
+#include <utility>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+ExtentAllocator::ExtentAllocator(BufferPoolManager *bpm, page_id_t near_page_id, size_t extent_size)
+    : bpm_(bpm), extent_size_(extent_size), last_page_id_(near_page_id) {}
+
+ExtentAllocator::~ExtentAllocator() {
+  for (size_t i = next_; i < extent_.size(); i++) {
+    bpm_->DeletePage(extent_[i]);
+  }
+}
+
+auto ExtentAllocator::NewPage(page_id_t *page_id, BufferRing *ring) -> Page * {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (next_ == extent_.size()) {
+    std::vector<page_id_t> extent = bpm_->AllocateExtent(extent_size_, last_page_id_);
+    if (extent.empty()) {
+      return nullptr;
+    }
+    extent_ = std::move(extent);
+    next_ = 0;
+  }
+  Page *page = bpm_->NewPageAt(extent_[next_], ring);
+  if (page == nullptr) {
+    return nullptr;
+  }
+  *page_id = extent_[next_++];
+  last_page_id_ = *page_id;
+  return page;
+}
+
+}  // namespace bustub
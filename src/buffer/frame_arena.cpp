@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+#include <algorithm>
+#include <cstdint>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+FrameArena::FrameArena(size_t num_frames) {
+  size_ = (std::max<size_t>(num_frames, 1) * BUSTUB_PAGE_SIZE + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+
+  // mmap only guarantees regular page alignment. Map one huge page more than needed and unmap the slack on both sides,
+  // so that every huge page of the arena can be backed by one.
+  size_t mapped_size = size_ + HUGE_PAGE_SIZE;
+  void *mapped = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapped == MAP_FAILED) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot map the frame arena");
+  }
+  auto start = reinterpret_cast<uintptr_t>(mapped);
+  auto aligned = (start + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+  if (aligned > start) {
+    munmap(mapped, aligned - start);
+  }
+  size_t tail = start + mapped_size - (aligned + size_);
+  if (tail > 0) {
+    munmap(reinterpret_cast<void *>(aligned + size_), tail);
+  }
+  base_ = reinterpret_cast<char *>(aligned);
+
+#ifdef MADV_HUGEPAGE
+  huge_pages_ = madvise(base_, size_, MADV_HUGEPAGE) == 0;
+#endif
+}
+
+FrameArena::~FrameArena() { munmap(base_, size_); }
+
+}  // namespace bustub
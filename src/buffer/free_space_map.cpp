@@ -0,0 +1,222 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/buffer/free_space_map.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/free_space_map.h"
+
+#include <limits>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/free_space_map_page.h"
+
+namespace bustub {
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *bpm, uint32_t num_instances, uint32_t instance_index)
+    : bpm_(bpm), num_instances_(num_instances), instance_index_(instance_index) {}
+
+auto FreeSpaceMap::Open() -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  free_counts_.clear();
+  int64_t end = 0;
+  for (size_t group = 0;; group++) {
+    page_id_t map_page_id = MapPageId(group);
+    Page *page = bpm_->FetchPage(map_page_id);
+    BUSTUB_ENSURE(page != nullptr, "no free frame to read the free space map");
+    page->WLatch();
+    auto *map = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+    bool is_dirty = false;
+    if (!map->IsInitialized()) {
+      if (group > 0) {
+        page->WUnlatch();
+        bpm_->UnpinPage(map_page_id, false);
+        break;
+      }
+      // A new database: the map page is the first page of the file.
+      map->Init();
+      map->Set(0);
+      is_dirty = true;
+    }
+    free_counts_.push_back(FreeSpaceMapPage::NUM_BITS - map->CountSet());
+    end = static_cast<int64_t>(group) * FreeSpaceMapPage::NUM_BITS + map->FindLastSet() + 1;
+    page->WUnlatch();
+    bpm_->UnpinPage(map_page_id, is_dirty);
+  }
+  return ToPageId(end);
+}
+
+auto FreeSpaceMap::Allocate(page_id_t near_page_id) -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (near_page_id >= 0 && static_cast<uint32_t>(near_page_id) % num_instances_ == instance_index_) {
+    int64_t local = ToLocal(near_page_id);
+    size_t group = local / FreeSpaceMapPage::NUM_BITS;
+    if (group < free_counts_.size() && free_counts_[group] > 0) {
+      return AllocateInGroup(group, local % FreeSpaceMapPage::NUM_BITS);
+    }
+  }
+  for (size_t group = 0; group < free_counts_.size(); group++) {
+    if (free_counts_[group] > 0) {
+      return AllocateInGroup(group, 0);
+    }
+  }
+  return AllocateInGroup(free_counts_.size(), 0);
+}
+
+auto FreeSpaceMap::AllocateRun(size_t num_pages, page_id_t near_page_id) -> std::vector<page_id_t> {
+  BUSTUB_ENSURE(num_pages > 0 && num_pages < FreeSpaceMapPage::NUM_BITS, "a run must fit into one group");
+  const int length = static_cast<int>(num_pages);
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<page_id_t> page_ids;
+  if (near_page_id >= 0 && static_cast<uint32_t>(near_page_id) % num_instances_ == instance_index_) {
+    int64_t local = ToLocal(near_page_id);
+    size_t group = local / FreeSpaceMapPage::NUM_BITS;
+    if (group < free_counts_.size() && free_counts_[group] >= length &&
+        AllocateRunInGroup(group, local % FreeSpaceMapPage::NUM_BITS, length, &page_ids)) {
+      return page_ids;
+    }
+  }
+  for (size_t group = 0; group < free_counts_.size(); group++) {
+    if (free_counts_[group] >= length && AllocateRunInGroup(group, 1, length, &page_ids)) {
+      return page_ids;
+    }
+  }
+  AllocateRunInGroup(free_counts_.size(), 1, length, &page_ids);
+  return page_ids;
+}
+
+auto FreeSpaceMap::Free(page_id_t page_id) -> bool {
+  if (page_id < 0 || static_cast<uint32_t>(page_id) % num_instances_ != instance_index_ || IsMapPage(page_id)) {
+    return true;
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  int64_t local = ToLocal(page_id);
+  size_t group = local / FreeSpaceMapPage::NUM_BITS;
+  if (group >= free_counts_.size()) {
+    return true;
+  }
+  page_id_t map_page_id = MapPageId(group);
+  Page *page = bpm_->FetchPage(map_page_id);
+  if (page == nullptr) {
+    return false;
+  }
+  page->WLatch();
+  auto *map = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+  int bit = local % FreeSpaceMapPage::NUM_BITS;
+  bool is_dirty = map->IsSet(bit);
+  if (is_dirty) {
+    map->Clear(bit);
+    free_counts_[group]++;
+  }
+  page->WUnlatch();
+  bpm_->UnpinPage(map_page_id, is_dirty);
+  return true;
+}
+
+auto FreeSpaceMap::IsAllocated(page_id_t page_id) -> bool {
+  if (page_id < 0 || static_cast<uint32_t>(page_id) % num_instances_ != instance_index_) {
+    return false;
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  int64_t local = ToLocal(page_id);
+  size_t group = local / FreeSpaceMapPage::NUM_BITS;
+  if (group >= free_counts_.size()) {
+    return false;
+  }
+  page_id_t map_page_id = MapPageId(group);
+  Page *page = bpm_->FetchPage(map_page_id);
+  BUSTUB_ENSURE(page != nullptr, "no free frame to read the free space map");
+  page->RLatch();
+  auto *map = reinterpret_cast<const FreeSpaceMapPage *>(page->GetData());
+  bool is_set = map->IsSet(local % FreeSpaceMapPage::NUM_BITS);
+  page->RUnlatch();
+  bpm_->UnpinPage(map_page_id, false);
+  return is_set;
+}
+
+auto FreeSpaceMap::IsMapPage(page_id_t page_id) const -> bool {
+  return page_id >= 0 && static_cast<uint32_t>(page_id) % num_instances_ == instance_index_ &&
+         ToLocal(page_id) % FreeSpaceMapPage::NUM_BITS == 0;
+}
+
+auto FreeSpaceMap::GetGroupCount() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return free_counts_.size();
+}
+
+auto FreeSpaceMap::ToLocal(page_id_t page_id) const -> int64_t { return page_id / num_instances_; }
+
+auto FreeSpaceMap::ToPageId(int64_t local) const -> page_id_t {
+  int64_t page_id = local * num_instances_ + instance_index_;
+  BUSTUB_ENSURE(page_id <= std::numeric_limits<page_id_t>::max(), "out of page ids");
+  return static_cast<page_id_t>(page_id);
+}
+
+auto FreeSpaceMap::MapPageId(size_t group) const -> page_id_t {
+  return ToPageId(static_cast<int64_t>(group) * FreeSpaceMapPage::NUM_BITS);
+}
+
+auto FreeSpaceMap::FetchMapPage(size_t group) -> Page * {
+  Page *page = bpm_->FetchPage(MapPageId(group));
+  if (page == nullptr) {
+    return nullptr;
+  }
+  page->WLatch();
+  if (group == free_counts_.size()) {
+    // All groups are full. The map page of the next one was never written and reads as zeros.
+    auto *map = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+    map->Init();
+    map->Set(0);
+    free_counts_.push_back(FreeSpaceMapPage::NUM_BITS - 1);
+  }
+  return page;
+}
+
+auto FreeSpaceMap::AllocateInGroup(size_t group, int bit) -> page_id_t {
+  Page *page = FetchMapPage(group);
+  if (page == nullptr) {
+    return INVALID_PAGE_ID;
+  }
+  auto *map = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+  // Take the closer of the free pages around bit, the lower one on a tie. There always is one, since the group is not
+  // full.
+  int after = map->FindClearFrom(bit);
+  int before = map->FindClearBefore(bit);
+  int found = before >= 0 && (after < 0 || bit - before <= after - bit) ? before : after;
+  map->Set(found);
+  free_counts_[group]--;
+  page->WUnlatch();
+  bpm_->UnpinPage(page->GetPageId(), true);
+  return ToPageId(static_cast<int64_t>(group) * FreeSpaceMapPage::NUM_BITS + found);
+}
+
+auto FreeSpaceMap::AllocateRunInGroup(size_t group, int bit, int num_pages, std::vector<page_id_t> *page_ids)
+    -> bool {
+  Page *page = FetchMapPage(group);
+  if (page == nullptr) {
+    return false;
+  }
+  auto *map = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+  int first = map->FindClearRun(bit, num_pages);
+  if (first < 0 && bit > 1) {
+    first = map->FindClearRun(1, num_pages);
+  }
+  if (first >= 0) {
+    for (int i = first; i < first + num_pages; i++) {
+      map->Set(i);
+      page_ids->push_back(ToPageId(static_cast<int64_t>(group) * FreeSpaceMapPage::NUM_BITS + i));
+    }
+    free_counts_[group] -= num_pages;
+  }
+  page->WUnlatch();
+  bpm_->UnpinPage(page->GetPageId(), first >= 0);
+  return first >= 0;
+}
+
+}  // namespace bustub
@@ -11,20 +11,234 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/lru_k_replacer.h"
+
+#include <algorithm>
+#include <utility>
+
 #include "common/exception.h"
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : node_store_(num_frames), history_(num_frames * std::max<size_t>(k, 1)), replacer_size_(num_frames),
+      k_(std::max<size_t>(k, 1)) {
+  heap_.reserve(num_frames);
+}
+
+auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+  return Evict(frame_id, [](frame_id_t) { return true; });
+}
+
+auto LRUKReplacer::Evict(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &try_evict) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // Frames with fewer than k accesses have +inf backward k-distance and always beat frames with a full history.
+  for (frame_id_t fid = inf_head_; fid != INVALID_PAGE_ID; fid = node_store_[fid].next_) {
+    if (node_store_[fid].is_evictable_ && try_evict(fid)) {
+      RemoveFrame(fid);
+      *frame_id = fid;
+      return true;
+    }
+  }
+
+  // Take refused frames off the heap until one is accepted, and put them back afterwards.
+  std::vector<frame_id_t> refused;
+  bool evicted = false;
+  while (!heap_.empty()) {
+    frame_id_t fid = heap_.front();
+    if (try_evict(fid)) {
+      RemoveFrame(fid);
+      *frame_id = fid;
+      evicted = true;
+      break;
+    }
+    HeapErase(0);
+    refused.push_back(fid);
+  }
+  for (frame_id_t fid : refused) {
+    HeapPush(fid);
+  }
+  return evicted;
+}
+
+auto LRUKReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // Same order as Evict(): +inf backward k-distance first, then the oldest k-th most recent access.
+  std::vector<frame_id_t> frames;
+  for (frame_id_t fid = inf_head_; fid != INVALID_PAGE_ID && frames.size() < max_frames;
+       fid = node_store_[fid].next_) {
+    if (node_store_[fid].is_evictable_) {
+      frames.push_back(fid);
+    }
+  }
+  size_t from_heap = frames.size();
+  while (frames.size() < max_frames && !heap_.empty()) {
+    frames.push_back(heap_.front());
+    HeapErase(0);
+  }
+  for (size_t i = from_heap; i < frames.size(); i++) {
+    HeapPush(frames[i]);
+  }
+  return frames;
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type,
+                                [[maybe_unused]] page_id_t page_id) {
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < replacer_size_, "frame id is out of range");
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &node = node_store_[frame_id];
+  size_t *history = &history_[frame_id * k_];
+  if (!node.is_tracked_) {
+    node.is_tracked_ = true;
+    ListPushBack(frame_id);
+  }
+
+  if (node.history_size_ == k_) {
+    // Overwrite the least recent timestamp. The frame's k-th most recent access only gets later.
+    history[node.history_head_] = current_timestamp_++;
+    node.history_head_ = (node.history_head_ + 1) % k_;
+    if (node.heap_pos_ != std::numeric_limits<size_t>::max()) {
+      HeapSiftDown(node.heap_pos_);
+    }
+    return;
+  }
+
+  history[node.history_size_++] = current_timestamp_++;
+  if (node.history_size_ == k_) {
+    ListErase(frame_id);
+    node.history_head_ = 0;
+    if (node.is_evictable_) {
+      HeapPush(frame_id);
+    }
+  }
+}
+
+void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < replacer_size_, "frame id is out of range");
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &node = node_store_[frame_id];
+  if (!node.is_tracked_ || node.is_evictable_ == set_evictable) {
+    return;
+  }
+  node.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+  if (node.history_size_ == k_) {
+    if (set_evictable) {
+      HeapPush(frame_id);
+    } else {
+      HeapErase(node.heap_pos_);
+    }
+  }
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (static_cast<size_t>(frame_id) >= replacer_size_ || !node_store_[frame_id].is_tracked_) {
+    return;
+  }
+  BUSTUB_ENSURE(node_store_[frame_id].is_evictable_, "cannot remove a non-evictable frame");
+  RemoveFrame(frame_id);
+}
+
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+auto LRUKReplacer::OrderingTimestamp(frame_id_t frame_id) const -> size_t {
+  const auto &node = node_store_[frame_id];
+  return history_[frame_id * k_ + (node.history_size_ < k_ ? 0 : node.history_head_)];
+}
+
+void LRUKReplacer::RemoveFrame(frame_id_t frame_id) {
+  auto &node = node_store_[frame_id];
+  if (node.history_size_ < k_) {
+    ListErase(frame_id);
+  } else {
+    HeapErase(node.heap_pos_);
+  }
+  node = LRUKNode();
+  curr_size_--;
+}
+
+void LRUKReplacer::ListPushBack(frame_id_t frame_id) {
+  auto &node = node_store_[frame_id];
+  node.prev_ = inf_tail_;
+  node.next_ = INVALID_PAGE_ID;
+  if (inf_tail_ == INVALID_PAGE_ID) {
+    inf_head_ = frame_id;
+  } else {
+    node_store_[inf_tail_].next_ = frame_id;
+  }
+  inf_tail_ = frame_id;
+}
+
+void LRUKReplacer::ListErase(frame_id_t frame_id) {
+  auto &node = node_store_[frame_id];
+  if (node.prev_ == INVALID_PAGE_ID) {
+    inf_head_ = node.next_;
+  } else {
+    node_store_[node.prev_].next_ = node.next_;
+  }
+  if (node.next_ == INVALID_PAGE_ID) {
+    inf_tail_ = node.prev_;
+  } else {
+    node_store_[node.next_].prev_ = node.prev_;
+  }
+  node.prev_ = node.next_ = INVALID_PAGE_ID;
+}
 
-auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool { return false; }
+void LRUKReplacer::HeapPush(frame_id_t frame_id) {
+  node_store_[frame_id].heap_pos_ = heap_.size();
+  heap_.push_back(frame_id);
+  HeapSiftUp(heap_.size() - 1);
+}
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type) {}
+void LRUKReplacer::HeapErase(size_t pos) {
+  size_t last = heap_.size() - 1;
+  if (pos != last) {
+    HeapSwap(pos, last);
+  }
+  node_store_[heap_.back()].heap_pos_ = std::numeric_limits<size_t>::max();
+  heap_.pop_back();
+  if (pos < heap_.size()) {
+    // The frame moved into pos may belong either above or below it.
+    frame_id_t moved = heap_[pos];
+    HeapSiftUp(pos);
+    HeapSiftDown(node_store_[moved].heap_pos_);
+  }
+}
 
-void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {}
+void LRUKReplacer::HeapSiftUp(size_t pos) {
+  while (pos > 0 && HeapLess(pos, (pos - 1) / 2)) {
+    HeapSwap(pos, (pos - 1) / 2);
+    pos = (pos - 1) / 2;
+  }
+}
 
-void LRUKReplacer::Remove(frame_id_t frame_id) {}
+void LRUKReplacer::HeapSiftDown(size_t pos) {
+  while (true) {
+    size_t smallest = pos;
+    for (size_t child : {2 * pos + 1, 2 * pos + 2}) {
+      if (child < heap_.size() && HeapLess(child, smallest)) {
+        smallest = child;
+      }
+    }
+    if (smallest == pos) {
+      return;
+    }
+    HeapSwap(pos, smallest);
+    pos = smallest;
+  }
+}
 
-auto LRUKReplacer::Size() -> size_t { return 0; }
+void LRUKReplacer::HeapSwap(size_t a, size_t b) {
+  std::swap(heap_[a], heap_[b]);
+  node_store_[heap_[a]].heap_pos_ = a;
+  node_store_[heap_[b]].heap_pos_ = b;
+}
 
 }  // namespace bustub
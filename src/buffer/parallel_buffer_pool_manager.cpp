@@ -0,0 +1,262 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <thread>  // NOLINT
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, size_t num_io_workers,
+                                                     ReplacerPolicy replacer_policy, bool use_frame_arena)
+    : BufferPoolManager(disk_manager, log_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "a parallel buffer pool needs at least one instance");
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManager>(pool_size, static_cast<uint32_t>(num_instances),
+                                                                static_cast<uint32_t>(i), disk_manager, replacer_k,
+                                                                log_manager, num_io_workers, replacer_policy,
+                                                                use_frame_arena));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  // The last snapshot needs the instances, which are gone by the time the base class destructor runs.
+  StopWarmRestart();
+}
+
+auto ParallelBufferPoolManager::GetPoolSize() -> size_t {
+  size_t pool_size = 0;
+  for (auto &instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManager * {
+  BUSTUB_ASSERT(page_id >= 0, "page id must be valid to pick an instance");
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+auto ParallelBufferPoolManager::NewPage(page_id_t *page_id, BufferRing *ring, page_id_t near_page_id) -> Page * {
+  if (near_page_id != INVALID_PAGE_ID) {
+    Page *page = GetBufferPoolManager(near_page_id)->NewPage(page_id, ring, near_page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  // Start from a different instance on every call so that new pages spread evenly, and fall through to the next
+  // instance when one is full of pinned pages.
+  size_t start = next_instance_.fetch_add(1) % instances_.size();
+  for (size_t i = 0; i < instances_.size(); i++) {
+    Page *page = instances_[(start + i) % instances_.size()]->NewPage(page_id, ring);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::NewPageGuarded(page_id_t *page_id, page_id_t near_page_id) -> BasicPageGuard {
+  if (near_page_id != INVALID_PAGE_ID) {
+    auto *instance = GetBufferPoolManager(near_page_id);
+    Page *page = instance->NewPage(page_id, nullptr, near_page_id);
+    if (page != nullptr) {
+      return {instance, page};
+    }
+  }
+  size_t start = next_instance_.fetch_add(1) % instances_.size();
+  for (size_t i = 0; i < instances_.size(); i++) {
+    auto *instance = instances_[(start + i) % instances_.size()].get();
+    Page *page = instance->NewPage(page_id);
+    if (page != nullptr) {
+      return {instance, page};
+    }
+  }
+  return {this, nullptr};
+}
+
+auto ParallelBufferPoolManager::AllocateExtent(size_t num_pages, page_id_t near_page_id) -> std::vector<page_id_t> {
+  if (near_page_id != INVALID_PAGE_ID) {
+    return GetBufferPoolManager(near_page_id)->AllocateExtent(num_pages, near_page_id);
+  }
+  return instances_[next_instance_.fetch_add(1) % instances_.size()]->AllocateExtent(num_pages);
+}
+
+auto ParallelBufferPoolManager::NewPageAt(page_id_t page_id, BufferRing *ring) -> Page * {
+  return GetBufferPoolManager(page_id)->NewPageAt(page_id, ring);
+}
+
+auto ParallelBufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type, BufferRing *ring) -> Page * {
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  return GetBufferPoolManager(page_id)->FetchPage(page_id, access_type, ring);
+}
+
+auto ParallelBufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard {
+  if (page_id == INVALID_PAGE_ID) {
+    return {this, nullptr};
+  }
+  return GetBufferPoolManager(page_id)->FetchPageBasic(page_id);
+}
+
+auto ParallelBufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
+  if (page_id == INVALID_PAGE_ID) {
+    return {this, nullptr};
+  }
+  return GetBufferPoolManager(page_id)->FetchPageRead(page_id);
+}
+
+auto ParallelBufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
+  if (page_id == INVALID_PAGE_ID) {
+    return {this, nullptr};
+  }
+  return GetBufferPoolManager(page_id)->FetchPageWrite(page_id);
+}
+
+auto ParallelBufferPoolManager::PrefetchPage(page_id_t page_id, BufferRing *ring) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetBufferPoolManager(page_id)->PrefetchPage(page_id, ring);
+}
+
+auto ParallelBufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty, access_type);
+}
+
+auto ParallelBufferPoolManager::FlushPage(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPages() {
+  // Adjacent pages belong to different instances, so the instances are flushed together to find the runs.
+  std::vector<Page *> pages;
+  for (auto &instance : instances_) {
+    std::vector<Page *> dirty = instance->PinDirtyPages();
+    pages.insert(pages.end(), dirty.begin(), dirty.end());
+  }
+  instances_[0]->WriteBackPages(&pages);
+}
+
+auto ParallelBufferPoolManager::DeletePage(page_id_t page_id) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return true;
+  }
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+auto ParallelBufferPoolManager::GetHitCount(AccessType access_type) -> uint64_t {
+  uint64_t hits = 0;
+  for (auto &instance : instances_) {
+    hits += instance->GetHitCount(access_type);
+  }
+  return hits;
+}
+
+auto ParallelBufferPoolManager::GetMissCount(AccessType access_type) -> uint64_t {
+  uint64_t misses = 0;
+  for (auto &instance : instances_) {
+    misses += instance->GetMissCount(access_type);
+  }
+  return misses;
+}
+
+void ParallelBufferPoolManager::RunPageCleaner(size_t pages_per_round, std::chrono::milliseconds interval,
+                                               size_t target_clean_percent) {
+  for (auto &instance : instances_) {
+    instance->RunPageCleaner(pages_per_round, interval, target_clean_percent);
+  }
+}
+
+void ParallelBufferPoolManager::StopPageCleaner() {
+  for (auto &instance : instances_) {
+    instance->StopPageCleaner();
+  }
+}
+
+auto ParallelBufferPoolManager::GetEvictionCount() -> uint64_t {
+  uint64_t evictions = 0;
+  for (auto &instance : instances_) {
+    evictions += instance->GetEvictionCount();
+  }
+  return evictions;
+}
+
+auto ParallelBufferPoolManager::GetForegroundWriteCount() -> uint64_t {
+  uint64_t writes = 0;
+  for (auto &instance : instances_) {
+    writes += instance->GetForegroundWriteCount();
+  }
+  return writes;
+}
+
+auto ParallelBufferPoolManager::GetCleanerWriteCount() -> uint64_t {
+  uint64_t writes = 0;
+  for (auto &instance : instances_) {
+    writes += instance->GetCleanerWriteCount();
+  }
+  return writes;
+}
+
+void ParallelBufferPoolManager::SetAccessTrace(AccessTrace *trace) {
+  for (auto &instance : instances_) {
+    instance->SetAccessTrace(trace);
+  }
+}
+
+void ParallelBufferPoolManager::EnableFreeSpaceMap() {
+  for (auto &instance : instances_) {
+    instance->EnableFreeSpaceMap();
+  }
+}
+
+auto ParallelBufferPoolManager::GetResidentPages() -> std::vector<page_id_t> {
+  std::vector<page_id_t> page_ids;
+  for (auto &instance : instances_) {
+    std::vector<page_id_t> resident = instance->GetResidentPages();
+    page_ids.insert(page_ids.end(), resident.begin(), resident.end());
+  }
+  return page_ids;
+}
+
+auto ParallelBufferPoolManager::GetDirtyPageTable() -> std::vector<std::pair<page_id_t, lsn_t>> {
+  std::vector<std::pair<page_id_t, lsn_t>> dirty_pages;
+  for (auto &instance : instances_) {
+    std::vector<std::pair<page_id_t, lsn_t>> instance_pages = instance->GetDirtyPageTable();
+    dirty_pages.insert(dirty_pages.end(), instance_pages.begin(), instance_pages.end());
+  }
+  return dirty_pages;
+}
+
+auto ParallelBufferPoolManager::WarmUp(const std::vector<page_id_t> &page_ids, const std::atomic<bool> *running)
+    -> size_t {
+  std::atomic<size_t> loaded{0};
+  std::vector<std::thread> threads;
+  for (auto &instance : instances_) {
+    threads.emplace_back([&, instance = instance.get()] { loaded += instance->WarmUp(page_ids, running); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return loaded;
+}
+
+}  // namespace bustub
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer.cpp
+//
+// Identification: src/buffer/replacer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/replacer.h"
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_pro_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+auto MakeReplacer(ReplacerPolicy policy, size_t num_frames, size_t k) -> std::unique_ptr<Replacer> {
+  switch (policy) {
+    case ReplacerPolicy::LRUK:
+      return std::make_unique<LRUKReplacer>(num_frames, k);
+    case ReplacerPolicy::ARC:
+      return std::make_unique<ArcReplacer>(num_frames);
+    case ReplacerPolicy::TwoQueue:
+      return std::make_unique<TwoQueueReplacer>(num_frames);
+    case ReplacerPolicy::ClockPro:
+      return std::make_unique<ClockProReplacer>(num_frames);
+  }
+  throw Exception("unknown replacer policy");
+}
+
+auto ReplacerPolicyFromString(const std::string &name) -> std::optional<ReplacerPolicy> {
+  if (name == "lru-k") {
+    return ReplacerPolicy::LRUK;
+  }
+  if (name == "arc") {
+    return ReplacerPolicy::ARC;
+  }
+  if (name == "2q") {
+    return ReplacerPolicy::TwoQueue;
+  }
+  if (name == "clock-pro") {
+    return ReplacerPolicy::ClockPro;
+  }
+  return std::nullopt;
+}
+
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> std::string {
+  switch (policy) {
+    case ReplacerPolicy::LRUK:
+      return "lru-k";
+    case ReplacerPolicy::ARC:
+      return "arc";
+    case ReplacerPolicy::TwoQueue:
+      return "2q";
+    case ReplacerPolicy::ClockPro:
+      return "clock-pro";
+  }
+  return "unknown";
+}
+
+}  // namespace bustub
@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+    : capacity_(num_frames),
+      a1in_share_(std::max<size_t>(num_frames / 4, 1)),
+      a1out_size_(std::max<size_t>(num_frames / 2, 1)),
+      frames_(num_frames) {}
+
+auto TwoQueueReplacer::PreferredQueue() -> QueueId {
+  return a1in_.size() > a1in_share_ || am_.empty() ? QueueId::A1In : QueueId::Am;
+}
+
+auto TwoQueueReplacer::Evict(frame_id_t *frame_id) -> bool {
+  return Evict(frame_id, [](frame_id_t) { return true; });
+}
+
+auto TwoQueueReplacer::Evict(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &try_evict) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  QueueId first = PreferredQueue();
+  for (QueueId queue_id : {first, first == QueueId::A1In ? QueueId::Am : QueueId::A1In}) {
+    auto &queue = QueueOf(queue_id);
+    for (auto it = queue.rbegin(); it != queue.rend(); ++it) {
+      frame_id_t victim = *it;
+      FrameNode &node = frames_[victim];
+      if (!node.is_evictable_ || !try_evict(victim)) {
+        continue;
+      }
+      queue.erase(node.pos_);
+      // Only pages that leave A1in are remembered; a page evicted from Am had its chance.
+      if (queue_id == QueueId::A1In && node.page_id_ != INVALID_PAGE_ID && a1out_index_.count(node.page_id_) == 0) {
+        a1out_.push_front(node.page_id_);
+        a1out_index_[node.page_id_] = a1out_.begin();
+        if (a1out_.size() > a1out_size_) {
+          a1out_index_.erase(a1out_.back());
+          a1out_.pop_back();
+        }
+      }
+      node = FrameNode();
+      curr_size_--;
+      *frame_id = victim;
+      return true;
+    }
+  }
+  return false;
+}
+
+auto TwoQueueReplacer::GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  QueueId first = PreferredQueue();
+  for (QueueId queue_id : {first, first == QueueId::A1In ? QueueId::Am : QueueId::A1In}) {
+    auto &queue = QueueOf(queue_id);
+    for (auto it = queue.rbegin(); it != queue.rend() && candidates.size() < max_frames; ++it) {
+      if (frames_[*it].is_evictable_) {
+        candidates.push_back(*it);
+      }
+    }
+  }
+  return candidates;
+}
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type,
+                                    page_id_t page_id) {
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < capacity_, "frame id is out of range");
+  std::scoped_lock<std::mutex> lock(latch_);
+  FrameNode &node = frames_[frame_id];
+  if (page_id != INVALID_PAGE_ID) {
+    node.page_id_ = page_id;
+  }
+
+  if (node.queue_ == QueueId::Am) {
+    am_.splice(am_.begin(), am_, node.pos_);
+    return;
+  }
+  if (node.queue_ == QueueId::A1In) {
+    return;
+  }
+
+  auto ghost = page_id == INVALID_PAGE_ID ? a1out_index_.end() : a1out_index_.find(page_id);
+  if (ghost != a1out_index_.end()) {
+    a1out_.erase(ghost->second);
+    a1out_index_.erase(ghost);
+    am_.push_front(frame_id);
+    node.queue_ = QueueId::Am;
+    node.pos_ = am_.begin();
+  } else {
+    a1in_.push_front(frame_id);
+    node.queue_ = QueueId::A1In;
+    node.pos_ = a1in_.begin();
+  }
+}
+
+void TwoQueueReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ENSURE(static_cast<size_t>(frame_id) < capacity_, "frame id is out of range");
+  std::scoped_lock<std::mutex> lock(latch_);
+  FrameNode &node = frames_[frame_id];
+  if (node.queue_ == QueueId::None || node.is_evictable_ == set_evictable) {
+    return;
+  }
+  node.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  FrameNode &node = frames_[frame_id];
+  if (node.queue_ == QueueId::None) {
+    return;
+  }
+  BUSTUB_ENSURE(node.is_evictable_, "cannot remove a non-evictable frame");
+  QueueOf(node.queue_).erase(node.pos_);
+  node = FrameNode();
+  curr_size_--;
+}
+
+auto TwoQueueReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+}  // namespace bustub
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -12,6 +13,7 @@
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
 #include "common/bustub_instance.h"
@@ -37,11 +39,36 @@
 
 namespace bustub {
 
+/**
+ * Create the buffer pool of the instance. With more than one shard, the frames are split evenly across the
+ * instances of a ParallelBufferPoolManager. Deleted pages are reused through the free space map.
+ */
+static auto MakeBufferPoolManager(size_t bpm_size, size_t bpm_shards, ReplacerPolicy replacer_policy,
+                                  DiskManager *disk_manager, LogManager *log_manager) -> BufferPoolManager * {
+  BufferPoolManager *bpm;
+  if (bpm_shards <= 1) {
+    bpm = new BufferPoolManager(bpm_size, disk_manager, LRUK_REPLACER_K, log_manager, DISK_SCHEDULER_NUM_WORKERS,
+                                replacer_policy);
+  } else {
+    size_t shard_size = std::max<size_t>(1, (bpm_size + bpm_shards - 1) / bpm_shards);
+    bpm = new ParallelBufferPoolManager(bpm_shards, shard_size, disk_manager, LRUK_REPLACER_K, log_manager,
+                                        DISK_SCHEDULER_NUM_WORKERS, replacer_policy);
+  }
+  bpm->EnableFreeSpaceMap();
+  return bpm;
+}
+
+/** @return the file the resident pages of the buffer pool are saved to, next to the database file like its log */
+static auto WarmRestartFileName(const std::string &db_file_name) -> std::string {
+  return db_file_name.substr(0, db_file_name.rfind('.')) + ".warm";
+}
+
 auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext> {
   return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+BustubInstance::BustubInstance(const std::string &db_file_name, size_t bpm_size, size_t bpm_shards,
+                               ReplacerPolicy replacer_policy) {
   enable_logging = false;
 
   // Storage related.
@@ -53,7 +80,9 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
   // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ = MakeBufferPoolManager(bpm_size, bpm_shards, replacer_policy, disk_manager_, log_manager_);
+    // Bring back the pages that were resident when the database was last shut down.
+    buffer_pool_manager_->EnableWarmRestart(WarmRestartFileName(db_file_name));
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -73,7 +102,7 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
-BustubInstance::BustubInstance() {
+BustubInstance::BustubInstance(size_t bpm_size, size_t bpm_shards, ReplacerPolicy replacer_policy) {
   enable_logging = false;
 
   // Storage related.
@@ -85,7 +114,7 @@ BustubInstance::BustubInstance() {
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
   // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_ = MakeBufferPoolManager(bpm_size, bpm_shards, replacer_policy, disk_manager_, log_manager_);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -34,8 +34,10 @@ auto TransactionManager::Begin(Transaction *txn, IsolationLevel isolation_level)
 
   if (enable_logging) {
     LogRecord record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::BEGIN);
+    std::scoped_lock lock(active_txns_latch_);
     lsn_t lsn = log_manager_->AppendLogRecord(&record);
     txn->SetPrevLSN(lsn);
+    active_txns_[txn->GetTransactionId()] = lsn;
   }
 
   std::unique_lock<std::shared_mutex> l(txn_map_mutex);
@@ -59,6 +61,15 @@ void TransactionManager::Commit(Transaction *txn) {
   }
   write_set->clear();
 
+  if (enable_logging) {
+    LogRecord record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::COMMIT);
+    lsn_t lsn = log_manager_->AppendLogRecord(&record);
+    txn->SetPrevLSN(lsn);
+    EndActiveTransaction(txn->GetTransactionId());
+    // The flush thread makes the commit record durable together with those of concurrent committers.
+    log_manager_->WaitUntilPersistent(lsn);
+  }
+
   // Release all the locks.
   ReleaseLocks(txn);
   // Release the global transaction latch.
@@ -109,12 +120,29 @@ void TransactionManager::Abort(Transaction *txn) {
   table_write_set->clear();
   index_write_set->clear();
 
+  if (enable_logging) {
+    LogRecord record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::ABORT);
+    lsn_t lsn = log_manager_->AppendLogRecord(&record);
+    txn->SetPrevLSN(lsn);
+    EndActiveTransaction(txn->GetTransactionId());
+  }
+
   // Release all the locks.
   ReleaseLocks(txn);
   // Release the global transaction latch.
   global_txn_latch_.RUnlock();
 }
 
+auto TransactionManager::GetActiveTransactions() -> std::vector<std::pair<txn_id_t, lsn_t>> {
+  std::scoped_lock lock(active_txns_latch_);
+  return {active_txns_.begin(), active_txns_.end()};
+}
+
+void TransactionManager::EndActiveTransaction(txn_id_t txn_id) {
+  std::scoped_lock lock(active_txns_latch_);
+  active_txns_.erase(txn_id);
+}
+
 void TransactionManager::BlockAllTransactions() { global_txn_latch_.WLock(); }
 
 void TransactionManager::ResumeTransactions() { global_txn_latch_.WUnlock(); }
@@ -1,27 +1,64 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// insert_executor.cpp
-//
-// Identification: src/execution/insert_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include <memory>
-
-#include "execution/executors/insert_executor.h"
-
-namespace bustub {
-
-InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
-                               std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
-
-void InsertExecutor::Init() { throw NotImplementedException("InsertExecutor is not implemented"); }
-
-auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// insert_executor.cpp
+//
+// Identification: src/execution/insert_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+
+#include "execution/executors/insert_executor.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
+                               std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
+  auto pool_size = exec_ctx_->GetBufferPoolManager()->GetPoolSize();
+  ring_ = std::make_unique<BufferRing>(std::min<size_t>(BUFFER_RING_SIZE, pool_size / 4));
+}
+
+void InsertExecutor::Init() {
+  child_executor_->Init();
+  done_ = false;
+}
+
+auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
+  if (done_) {
+    return false;
+  }
+  done_ = true;
+
+  auto *catalog = exec_ctx_->GetCatalog();
+  auto *txn = exec_ctx_->GetTransaction();
+  auto *table_info = catalog->GetTable(plan_->TableOid());
+  auto indexes = catalog->GetTableIndexes(table_info->name_);
+
+  int32_t count = 0;
+  Tuple child_tuple;
+  RID child_rid;
+  while (child_executor_->Next(&child_tuple, &child_rid)) {
+    RID new_rid;
+    if (!table_info->table_->InsertTuple(child_tuple, &new_rid, txn, ring_.get())) {
+      continue;
+    }
+    for (auto *index_info : indexes) {
+      auto key =
+          child_tuple.KeyFromTuple(table_info->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs());
+      index_info->index_->InsertEntry(key, new_rid, txn);
+    }
+    count++;
+  }
+
+  *tuple = Tuple{{ValueFactory::GetIntegerValue(count)}, &GetOutputSchema()};
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_trace.h
+//
+// Identification: src/include/buffer/access_trace.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * AccessTrace records the page accesses a buffer pool manager serves, so that they can be replayed against every
+ * replacement policy offline (see tools/replacer_replay).
+ *
+ * Tracing is meant for benchmarks: Record() takes a mutex, so it serializes the threads using the buffer pool.
+ */
+class AccessTrace {
+ public:
+  struct Access {
+    page_id_t page_id_;
+    AccessType access_type_;
+    /** Whether the page was created by this access, in which case it is not read from disk. */
+    bool is_new_;
+  };
+
+  /** @brief Append an access to the trace. */
+  void Record(page_id_t page_id, AccessType access_type, bool is_new = false);
+
+  /** @return the accesses recorded so far, oldest first. Not safe against concurrent Record() calls. */
+  auto GetAccesses() const -> const std::vector<Access> & { return accesses_; }
+
+  /**
+   * @brief Write the trace to a text file, one access per line: "<n|f> <access type> <page id>".
+   * @return false if the file cannot be written
+   */
+  auto Save(const std::string &file_name) -> bool;
+
+  /**
+   * @brief Append the accesses of a file written by Save() to the trace.
+   * @return false if the file cannot be read or is malformed
+   */
+  auto Load(const std::string &file_name) -> bool;
+
+ private:
+  std::vector<Access> accesses_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
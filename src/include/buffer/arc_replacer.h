@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ArcReplacer implements the Adaptive Replacement Cache policy (Megiddo and Modha, FAST 2003).
+ *
+ * Resident frames are split into T1, frames whose page was accessed once since it came in, and T2, frames whose page
+ * was accessed again. The pages of frames evicted from T1 and T2 are remembered in the ghost lists B1 and B2. A page
+ * that comes back while in B1 means T1 was too small, one in B2 that T2 was, and the target size p of T1 moves
+ * accordingly. Eviction takes the least recently used frame of T1 while T1 is larger than p, and of T2 otherwise.
+ *
+ * Scan accesses do not promote a page from T1 to T2, so a page read by a scan twice in a row is not mistaken for a
+ * frequently used one. Eviction is O(1), plus one step per pinned or non-evictable frame it has to skip.
+ */
+class ArcReplacer : public Replacer {
+ public:
+  /**
+   * @brief Creates a new ArcReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit ArcReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ArcReplacer);
+
+  ~ArcReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &try_evict) -> bool override;
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+  void Remove(frame_id_t frame_id) override;
+  auto Size() -> size_t override;
+
+  /** @return the current target size of T1, for testing */
+  auto GetTargetT1Size() -> size_t;
+
+ private:
+  enum class ListId { None, T1, T2 };
+
+  struct FrameNode {
+    ListId list_{ListId::None};
+    std::list<frame_id_t>::iterator pos_;
+    page_id_t page_id_{INVALID_PAGE_ID};
+    bool is_evictable_{false};
+  };
+
+  struct GhostNode {
+    bool in_b2_;
+    std::list<page_id_t>::iterator pos_;
+  };
+
+  /** @return the list Evict() should take the victim from first */
+  auto PreferredList() -> ListId;
+  auto ListOf(ListId list) -> std::list<frame_id_t> & { return list == ListId::T1 ? t1_ : t2_; }
+  /** Keep the ghost lists within the sizes ARC allows: |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c. */
+  void TrimGhosts();
+  void DropGhost(bool from_b2);
+
+  const size_t capacity_;
+  /** Per frame, where it is. */
+  std::vector<FrameNode> frames_;
+  /** Most recently used first. */
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  std::list<page_id_t> b1_;
+  std::list<page_id_t> b2_;
+  std::unordered_map<page_id_t, GhostNode> ghosts_;
+  /** The target size of T1. */
+  size_t p_{0};
+  size_t curr_size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -12,49 +12,96 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <future>              // NOLINT
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <optional>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
-#include "buffer/lru_k_replacer.h"
+#include "buffer/access_trace.h"
+#include "buffer/buffer_ring.h"
+#include "buffer/concurrent_page_table.h"
+#include "buffer/frame_arena.h"
+#include "buffer/free_space_map.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
 #include "storage/page/page.h"
 #include "storage/page/page_guard.h"
 
 namespace bustub {
 
 /**
- * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ * BufferPoolManager reads disk pages to and from its internal buffer pool. All disk I/O goes through a DiskScheduler,
+ * and the latch is released while a fetch waits for its read (or for the write-back of a dirty victim).
+ *
+ * Fetching a page that is already resident and fully read in, and unpinning it again, do not take the latch at all:
+ * the page is looked up in a lock-free page table and pinned with a compare-and-swap on its pin count. Everything that
+ * reuses a frame first claims it by swapping its pin count from 0 to -1, so a frame is never reused under a pin.
  */
 class BufferPoolManager {
+  friend class ParallelBufferPoolManager;
+
  public:
   /**
    * @brief Creates a new BufferPoolManager.
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
-   * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param log_manager the log manager, whose persistent LSN gates the write-back of dirty pages (nullptr = disable
+   * logging)
+   * @param num_io_workers the number of background threads of the disk scheduler
+   * @param replacer_policy the replacement policy
+   * @param use_frame_arena whether to keep the frames in one huge-page backed FrameArena instead of allocating each
    */
   BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                    LogManager *log_manager = nullptr);
+                    LogManager *log_manager = nullptr, size_t num_io_workers = DISK_SCHEDULER_NUM_WORKERS,
+                    ReplacerPolicy replacer_policy = ReplacerPolicy::LRUK, bool use_frame_arena = false);
+
+  /**
+   * @brief Creates a new BufferPoolManager that is one shard of a ParallelBufferPoolManager.
+   *
+   * A shard only ever allocates page ids that are congruent to instance_index modulo num_instances, so that the
+   * parallel buffer pool can route every page id back to the shard that owns it.
+   *
+   * @param pool_size the size of this shard
+   * @param num_instances the total number of shards in the parallel buffer pool
+   * @param instance_index the index of this shard, in [0, num_instances)
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager, whose persistent LSN gates the write-back of dirty pages (nullptr = disable
+   * logging)
+   * @param num_io_workers the number of background threads of the disk scheduler
+   * @param replacer_policy the replacement policy
+   * @param use_frame_arena whether to keep the frames in one huge-page backed FrameArena instead of allocating each
+   */
+  BufferPoolManager(size_t pool_size, uint32_t num_instances, uint32_t instance_index, DiskManager *disk_manager,
+                    size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                    size_t num_io_workers = DISK_SCHEDULER_NUM_WORKERS,
+                    ReplacerPolicy replacer_policy = ReplacerPolicy::LRUK, bool use_frame_arena = false);
 
   /**
    * @brief Destroy an existing BufferPoolManager.
    */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager();
 
   /** @brief Return the size (number of frames) of the buffer pool. */
-  auto GetPoolSize() -> size_t { return pool_size_; }
+  virtual auto GetPoolSize() -> size_t { return pool_size_; }
 
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Create a new page in the buffer pool. Set page_id to the new page's id, or nullptr if all frames
    * are currently in use and not evictable (in another word, pinned).
    *
@@ -66,14 +113,36 @@ class BufferPoolManager {
    * so that the replacer wouldn't evict the frame before the buffer pool manager "Unpin"s it.
    * Also, remember to record the access history of the frame in the replacer for the lru-k algorithm to work.
    *
+   * With the free space map enabled, the page id is a free page, the one closest to near_page_id if possible.
+   *
    * @param[out] page_id id of created page
+   * @param ring the buffer ring of a bulk insert, or nullptr to take the frame from the whole pool
+   * @param near_page_id a page the new page should be close to on disk, or INVALID_PAGE_ID
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  auto NewPage(page_id_t *page_id) -> Page *;
+  virtual auto NewPage(page_id_t *page_id, BufferRing *ring = nullptr, page_id_t near_page_id = INVALID_PAGE_ID)
+      -> Page *;
 
   /**
-   * TODO(P1): Add implementation
+   * @brief Reserve the ids of num_pages new pages that lie next to each other on disk among the pages of one instance,
+   * and the disk space for them. The pages are created with NewPageAt(); until then, they are neither in the buffer
+   * pool nor handed out by NewPage(). Reserved pages that are never created can be given back with DeletePage().
    *
+   * @param num_pages the number of pages to reserve
+   * @param near_page_id a page the reserved pages should be close to on disk, or INVALID_PAGE_ID
+   * @return the reserved page ids in ascending order, or none if the free space map could not be read
+   */
+  virtual auto AllocateExtent(size_t num_pages, page_id_t near_page_id = INVALID_PAGE_ID) -> std::vector<page_id_t>;
+
+  /**
+   * @brief Create a new page like NewPage(), with an id reserved by AllocateExtent().
+   * @param page_id the reserved id of the page
+   * @param ring the buffer ring of a bulk insert, or nullptr to take the frame from the whole pool
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual auto NewPageAt(page_id_t page_id, BufferRing *ring = nullptr) -> Page *;
+
+  /**
    * @brief PageGuard wrapper for NewPage
    *
    * Functionality should be the same as NewPage, except that
@@ -81,32 +150,34 @@ class BufferPoolManager {
    * BasicPageGuard structure.
    *
    * @param[out] page_id, the id of the new page
+   * @param near_page_id a page the new page should be close to on disk, or INVALID_PAGE_ID
    * @return BasicPageGuard holding a new page
    */
-  auto NewPageGuarded(page_id_t *page_id) -> BasicPageGuard;
+  virtual auto NewPageGuarded(page_id_t *page_id, page_id_t near_page_id = INVALID_PAGE_ID) -> BasicPageGuard;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Fetch the requested page from the buffer pool. Return nullptr if page_id needs to be fetched from the disk
    * but all frames are currently in use and not evictable (in another word, pinned).
    *
    * First search for page_id in the buffer pool. If not found, pick a replacement frame from either the free list or
-   * the replacer (always find from the free list first), read the page from disk by calling disk_manager_->ReadPage(),
-   * and replace the old page in the frame. Similar to NewPage(), if the old page is dirty, you need to write it back
+   * the replacer (always find from the free list first), read the page from disk through the disk scheduler, and
+   * replace the old page in the frame. Similar to NewPage(), if the old page is dirty, you need to write it back
    * to disk and update the metadata of the new page
    *
+   * The latch is not held while the read is in flight. Threads that fetch the same page in the meantime pin the frame
+   * and wait for the read already in progress rather than issuing their own.
+   *
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPage().
    *
    * @param page_id id of page to be fetched
    * @param access_type type of access to the page, only needed for leaderboard tests.
+   * @param ring the buffer ring of a large scan, or nullptr to take the frame from the whole pool
    * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
    */
-  auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
+  virtual auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown, BufferRing *ring = nullptr)
+      -> Page *;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief PageGuard wrappers for FetchPage
    *
    * Functionality should be the same as FetchPage, except
@@ -117,13 +188,28 @@ class BufferPoolManager {
    * @param page_id, the id of the page to fetch
    * @return PageGuard holding the fetched page
    */
-  auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard;
-  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
-  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
+  virtual auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard;
+  virtual auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
+  virtual auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
 
   /**
-   * TODO(P1): Add implementation
+   * @brief Start bringing a page into the buffer pool in the background, without pinning it and without waiting for
+   * the read. Used for read-ahead by sequential scans.
    *
+   * The frame is taken like in FetchPage(). If the victim is dirty this call waits for its write-back; otherwise it
+   * never blocks on I/O. The read counts as the page's next access for the replacer, so the first
+   * FetchPage() of a read-ahead page does not record a second one. The frame is not evictable until that first
+   * FetchPage(), unless the pool runs out of other frames or read-ahead pages make up half of it.
+   *
+   * Page ids that have not been allocated yet are ignored, so callers may read ahead speculatively.
+   *
+   * @param page_id id of the page to read ahead
+   * @param ring the buffer ring of the scan reading ahead, or nullptr
+   * @return true if the page was already resident and fully read in, i.e. a FetchPage() now would not wait for I/O
+   */
+  virtual auto PrefetchPage(page_id_t page_id, BufferRing *ring = nullptr) -> bool;
+
+  /**
    * @brief Unpin the target page from the buffer pool. If page_id is not in the buffer pool or its pin count is already
    * 0, return false.
    *
@@ -135,31 +221,30 @@ class BufferPoolManager {
    * @param access_type type of access to the page, only needed for leaderboard tests.
    * @return false if the page is not in the page table or its pin count is <= 0 before this call, true otherwise
    */
-  auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool;
+  virtual auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Flush the target page to disk.
    *
    * Use the DiskManager::WritePage() method to flush a page to disk, REGARDLESS of the dirty flag.
-   * Unset the dirty flag of the page after flushing.
+   * Unset the dirty flag of the page after flushing. The log is flushed up to the page's LSN first. A page that is
+   * write-latched right now may be half changed, so the flush waits for the latch; the caller must not hold it.
    *
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  auto FlushPage(page_id_t page_id) -> bool;
+  virtual auto FlushPage(page_id_t page_id) -> bool;
 
   /**
-   * TODO(P1): Add implementation
+   * @brief Flush all the dirty pages in the buffer pool to disk, and make them durable.
    *
-   * @brief Flush all the pages in the buffer pool to disk.
+   * The pages are written in page id order, runs of adjacent pages with one vectored write each, and synced once at
+   * the end. The latch is not held during the writes; the pages are pinned instead. Like FlushPage(), the log is
+   * flushed first, and pages that are write-latched right now stay dirty.
    */
-  void FlushAllPages();
+  virtual void FlushAllPages();
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, do nothing and return true. If the
    * page is pinned and cannot be deleted, return false immediately.
    *
@@ -167,30 +252,199 @@ class BufferPoolManager {
    * back to the free list. Also, reset the page's memory and metadata. Finally, you should call DeallocatePage() to
    * imitate freeing the page on the disk.
    *
+   * With the free space map enabled, the page is freed on disk too, whether it was in the buffer pool or not, and
+   * NewPage() may hand it out again. The pages of the free space map itself cannot be deleted.
+   *
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  auto DeletePage(page_id_t page_id) -> bool;
+  virtual auto DeletePage(page_id_t page_id) -> bool;
+
+  /** @return the number of FetchPage() calls of the given access type that found the page in the pool */
+  virtual auto GetHitCount(AccessType access_type) -> uint64_t;
+
+  /** @return the number of FetchPage() calls of the given access type that had to read the page from disk */
+  virtual auto GetMissCount(AccessType access_type) -> uint64_t;
+
+  /**
+   * @brief Start the page cleaner, a background thread that writes dirty pages back before they are evicted, so that
+   * a foreground FetchPage() or NewPage() rarely has to wait for the write-back of somebody else's page.
+   *
+   * Every interval, the cleaner looks at the frames the replacer would evict next: enough of them that, together
+   * with the free list, target_clean_percent of the pool is ready for reuse without a write. It writes back up to
+   * pages_per_round of the dirty ones, which bounds its write rate. With logging enabled, a page is only written
+   * once the log is persistent up to the page's LSN (the WAL rule); the cleaner skips it until then.
+   *
+   * @param pages_per_round the most pages to write per round
+   * @param interval the time between two rounds; a foreground write-back also wakes the cleaner up early
+   * @param target_clean_percent the share of the pool to keep free or clean, in percent
+   */
+  virtual void RunPageCleaner(size_t pages_per_round = PAGE_CLEANER_PAGES_PER_ROUND,
+                              std::chrono::milliseconds interval = std::chrono::milliseconds(PAGE_CLEANER_INTERVAL_MS),
+                              size_t target_clean_percent = PAGE_CLEANER_TARGET_CLEAN_PERCENT);
+
+  /** @brief Stop the page cleaner, if it is running. */
+  virtual void StopPageCleaner();
+
+  /** @return the number of pages evicted to make room for another page */
+  virtual auto GetEvictionCount() -> uint64_t;
+
+  /** @return the number of evictions that had to write the victim back in the foreground */
+  virtual auto GetForegroundWriteCount() -> uint64_t;
+
+  /** @return the number of pages written back by the page cleaner */
+  virtual auto GetCleanerWriteCount() -> uint64_t;
+
+  /**
+   * @brief Record every page fetched or created from now on into trace, or stop recording with nullptr. The trace must
+   * outlive the recording.
+   */
+  virtual void SetAccessTrace(AccessTrace *trace);
+
+  /**
+   * @brief Keep the set of resident pages across restarts. First loads the pages that a previous run saved to path into
+   * free frames, in the background and in page id order, while the buffer pool is in use. Then saves the resident
+   * pages to path every snapshot_interval, and once more in StopWarmRestart() or on destruction.
+   *
+   * The pages are saved in the order the replacer would evict them, which is how their access history carries over:
+   * once loaded, the pages nobody accessed during the warm-up get their accesses replayed in that order. Only pages
+   * below the next page id are loaded, so enable the free space map first.
+   *
+   * @param path the file to load the resident pages from and to save them to
+   * @param snapshot_interval the time between two snapshots
+   */
+  void EnableWarmRestart(const std::string &path, std::chrono::milliseconds snapshot_interval =
+                                                      std::chrono::milliseconds(WARM_RESTART_SNAPSHOT_INTERVAL_MS));
+
+  /** @brief Stop warming up and taking snapshots, and save the resident pages a last time, if warm restart is on. */
+  void StopWarmRestart();
+
+  /** @return whether the warm-up started by EnableWarmRestart() is still loading pages */
+  auto IsWarmingUp() const -> bool { return warming_up_; }
+
+  /** @return the resident pages, in the order the replacer would evict them */
+  virtual auto GetResidentPages() -> std::vector<page_id_t>;
+
+  /**
+   * @brief Snapshot the dirty page table for a fuzzy checkpoint, without blocking page accesses beyond the latch.
+   *
+   * Returns once the write-backs of pages evicted before the snapshot are complete, since those pages are no longer
+   * listed but may not be on disk yet.
+   * @return (page id, recovery LSN) of every page that may lack logged changes on disk
+   */
+  virtual auto GetDirtyPageTable() -> std::vector<std::pair<page_id_t, lsn_t>>;
+
+  /**
+   * @brief Load pages into the free frames, without evicting anything, and make the replacer evict them in the order
+   * they are listed in. If they do not all fit, the ones listed last are loaded.
+   * @param page_ids pages in eviction order, as returned by GetResidentPages(); pages of other instances are skipped
+   * @param running the warm-up stops early once this becomes false, or nullptr
+   * @return the number of pages loaded
+   */
+  virtual auto WarmUp(const std::vector<page_id_t> &page_ids, const std::atomic<bool> *running = nullptr) -> size_t;
+
+  /**
+   * @brief Keep track of the free pages of the database file in a FreeSpaceMap, so that DeletePage() returns pages
+   * for reuse instead of leaking them. Reads the map of an existing database, or starts one for a new database.
+   *
+   * Call this before creating any page, and for every use of the database file: the map claims pages that would
+   * otherwise hold data.
+   */
+  virtual void EnableFreeSpaceMap();
+
+ protected:
+  /**
+   * @brief Constructor for buffer pools that own no frames themselves and delegate to other instances.
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager
+   */
+  BufferPoolManager(DiskManager *disk_manager, LogManager *log_manager);
 
  private:
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
   /** The next page id to be allocated  */
   std::atomic<page_id_t> next_page_id_ = 0;
 
-  /** Array of buffer pool pages. */
-  Page *pages_;
+  /** Array of buffer pool pages: the metadata of every frame, cache-line aligned. */
+  Page *pages_{nullptr};
+  /** The data of all frames, if they are kept in one arena rather than allocated by each page. */
+  std::unique_ptr<FrameArena> frame_arena_;
   /** Pointer to the disk manager. */
-  DiskManager *disk_manager_ __attribute__((__unused__));
-  /** Pointer to the log manager. Please ignore this for P1. */
-  LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  DiskManager *disk_manager_;
+  /** Schedules all page reads and writes of this instance on background threads. */
+  std::unique_ptr<DiskScheduler> disk_scheduler_;
+  /** Pointer to the log manager: a dirty page is only written once its log records are persistent. */
+  LogManager *log_manager_;
+  /** Page table for keeping track of buffer pool pages. Written under the latch, read without it. */
+  ConcurrentPageTable page_table_;
+  /**
+   * Per frame, whether the frame may be pinned without the latch: its page is fully read in, was not read ahead, and
+   * does not belong to a buffer ring. Only set under the latch, and cleared when the frame is claimed for reuse.
+   */
+  std::unique_ptr<std::atomic<bool>[]> shared_;
+  /**
+   * Accesses of pages pinned without the latch, as a ring of frame ids that later accesses overwrite. They are handed
+   * to the replacer under the latch, before it picks a victim. access_head_ is the next access not handed over yet.
+   */
+  std::unique_ptr<std::atomic<frame_id_t>[]> access_log_;
+  size_t access_log_mask_{0};
+  std::atomic<uint64_t> access_tail_{0};
+  uint64_t access_head_{0};
   /** Replacer to find unpinned pages for replacement. */
-  std::unique_ptr<LRUKReplacer> replacer_;
+  std::unique_ptr<Replacer> replacer_;
+  /** The allocated pages of this instance, if the free space map is enabled. */
+  std::unique_ptr<FreeSpaceMap> free_space_map_;
+  /** Where to record the accesses, if they are being traced. */
+  std::atomic<AccessTrace *> access_trace_{nullptr};
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /**
+   * Per frame, the completion of the I/O that is bringing the frame's page in. Only valid while that I/O is in flight;
+   * fetchers that hit such a frame wait on it instead of reading the page again.
+   */
+  std::vector<std::shared_future<bool>> pending_io_;
+  /**
+   * Frames that were read ahead and not fetched since, oldest first. They are not evictable: the replacer would
+   * otherwise pick them before any page with a longer history, before the scan they were read for gets to them.
+   */
+  std::list<frame_id_t> read_ahead_;
+  /** Per frame, whether the frame is in read_ahead_. */
+  std::vector<bool> prefetched_;
+  /** Per frame, the ring that brought the page in and may recycle the frame, nullptr once the page is shared. */
+  std::vector<BufferRing *> ring_of_;
+  /** FetchPage() hits and misses, per AccessType. */
+  std::array<std::atomic<uint64_t>, 3> hits_{};
+  std::array<std::atomic<uint64_t>, 3> misses_{};
+  /** Evictions, and how many of them wrote the victim back in the foreground. */
+  std::atomic<uint64_t> evictions_{0};
+  std::atomic<uint64_t> foreground_writes_{0};
+
+  /** The page cleaner thread and its settings. */
+  std::thread cleaner_thread_;
+  std::atomic<bool> cleaner_running_{false};
+  std::atomic<bool> cleaner_wakeup_{false};
+  std::mutex cleaner_mutex_;
+  std::condition_variable cleaner_cv_;
+  size_t cleaner_pages_per_round_{0};
+  std::chrono::milliseconds cleaner_interval_{0};
+  size_t cleaner_target_clean_percent_{0};
+  std::atomic<uint64_t> cleaner_writes_{0};
+  /** Warm restart: the file of the resident page set, and the thread that warms up from it and then saves it. */
+  std::string warm_restart_path_;
+  std::thread warm_restart_thread_;
+  std::atomic<bool> warm_restart_running_{false};
+  std::atomic<bool> warming_up_{false};
+  std::mutex warm_restart_mutex_;
+  std::condition_variable warm_restart_cv_;
+  std::chrono::milliseconds warm_restart_interval_{0};
+  /** Per frame, whether its page was loaded by WarmUp() and not accessed since. */
+  std::vector<bool> warm_;
+  /** This latch protects page_table_, free_list_, the replacer and the frame metadata (page id, pin count, dirty). */
   std::mutex latch_;
 
   /**
@@ -200,13 +454,128 @@ class BufferPoolManager {
   auto AllocatePage() -> page_id_t;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Deallocate a page on disk. This only does something with the free space map enabled, which fetches its
+   * pages through this buffer pool: the caller must NOT hold the latch.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id);
+
+  /**
+   * @brief Put a new, zeroed page into a frame and pin it. The caller must not hold the latch.
+   * @param page_id the id of the page, or INVALID_PAGE_ID to allocate one with AllocatePage()
+   * @param ring the buffer ring of a bulk insert, or nullptr
+   * @return the page, or nullptr if every frame is pinned
+   */
+  auto CreatePage(page_id_t page_id, BufferRing *ring) -> Page *;
+
+  /** @brief Make sure next_page_id_ is past page_id, which the free space map allocated. */
+  void RaiseNextPageId(page_id_t page_id);
+
+  /**
+   * @brief Drop the page of a claimed frame without writing it back and put the frame on the free list. The caller
+   * must hold the latch.
+   */
+  void DiscardFrame(frame_id_t frame_id);
+
+  /**
+   * @brief Find a frame to hold a new page, taking it from the free list first and from the replacer otherwise. With a
+   * ring that already holds its share of frames, the ring's oldest frame is recycled instead if nobody else uses its
+   * page. The victim page is removed from the page table; if it is dirty, its write-back is scheduled and must
+   * complete before the frame's memory is reused. Dirty pages whose log records are not on disk yet are passed over,
+   * so the log is never waited for under the latch. The caller must hold the latch.
+   * @param[out] frame_id id of the frame that is now free to use
+   * @param[out] writeback set to the completion of the victim's write-back, if there is one
+   * @param[out] wait_lsn if every victim was passed over for the log, the LSN the log must reach for one of them to be
+   * written back; left alone otherwise
+   * @param ring the buffer ring the frame is for, or nullptr
+   * @return false if every frame is pinned or waits for the log
+   */
+  auto AcquireFrame(frame_id_t *frame_id, std::optional<std::future<bool>> *writeback, lsn_t *wait_lsn,
+                    BufferRing *ring = nullptr) -> bool;
+
+  /**
+   * @brief Let the log reach lsn without holding the latch, so that the dirty victims AcquireFrame() passed over can be
+   * written back. The latch is held again on return, but anything may have changed meanwhile.
+   */
+  void WaitForLog(std::unique_lock<std::mutex> *lock, lsn_t lsn);
+
+  /**
+   * @brief Schedule a read or write of page_id on the disk scheduler.
+   * @return a future that becomes ready when the request completes
+   */
+  auto ScheduleIO(bool is_write, page_id_t page_id, char *data) -> std::future<bool>;
+
+  /**
+   * @brief Mark the I/O that was bringing frame_id in as complete, waking up every thread waiting for it. Must be
+   * called without the latch.
+   */
+  void FinishPendingIO(frame_id_t frame_id, std::promise<bool> *loaded);
+
+  /**
+   * @brief Check whether the I/O bringing in the page of frame_id is still in flight, forgetting it if it completed.
+   * The caller must hold the latch.
+   */
+  auto IsLoading(frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Give up on a read-ahead page that was not fetched: wait for its read if needed and make the frame
+   * evictable. The caller must hold the latch.
+   */
+  void ReleaseReadAhead(frame_id_t frame_id);
+
+  /**
+   * @brief Pin the page in frame_id and record the access. The caller must hold the latch.
+   * @param ring the buffer ring of the caller; the access is not recorded if the page belongs to it
+   */
+  void PinFrame(frame_id_t frame_id, AccessType access_type, BufferRing *ring = nullptr);
+
+  /**
+   * @brief Pin page_id without the latch, if it is resident and shared.
+   * @return the pinned page, or nullptr if the caller has to take the latch
+   */
+  auto TryPinShared(page_id_t page_id) -> Page *;
+
+  /**
+   * @brief Take frame_id for reuse if it is unpinned, keeping anybody from pinning it without the latch from now on.
+   * The caller must hold the latch.
+   * @return false if the frame is pinned
+   */
+  auto TryClaim(frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Like TryClaim(), but leave a dirty page alone whose log records up to its LSN are not on disk yet: it cannot
+   * be written back without waiting for the log. The caller must hold the latch.
+   * @param[out] wait_lsn lowered to the LSN of such a page
+   * @return false if the frame is pinned or its page waits for the log
+   */
+  auto TryClaimVictim(frame_id_t frame_id, lsn_t *wait_lsn) -> bool;
+
+  /** @brief Let frame_id be pinned without the latch if nothing keeps it from that. The caller must hold the latch. */
+  void ShareFrame(frame_id_t frame_id);
+
+  /** @brief Hand the accesses in access_log_ to the replacer. The caller must hold the latch. */
+  void DrainAccessLog();
+
+  /**
+   * @brief Pin every dirty page that is not being read in, for a write-back by the caller.
+   * @return the pinned pages
+   */
+  auto PinDirtyPages() -> std::vector<Page *>;
+
+  /**
+   * @brief Write back pages pinned by PinDirtyPages() of this or other instances sharing the disk manager, sort them by
+   * page id, merge runs of adjacent pages into vectored writes, sync the disk manager once, and unpin the pages. Only
+   * the pages that can be read-latched right away are written and marked clean. Must be called without the latch.
+   */
+  void WriteBackPages(std::vector<Page *> *pages);
+
+  /**
+   * @brief One round of the page cleaner: write back the dirty pages among the next victims of the replacer.
+   * @return the number of pages written
+   */
+  auto CleanDirtyPages() -> size_t;
 
-  // TODO(student): You may add additional private members and helper functions
+  /** @brief Check that page_id belongs to this instance. */
+  void ValidatePageId(page_id_t page_id) const;
 };
 }  // namespace bustub
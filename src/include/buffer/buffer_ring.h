@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_ring.h
+//
+// Identification: src/include/buffer/buffer_ring.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <unordered_map>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+
+/**
+ * BufferRing is a buffer access strategy for large sequential scans and bulk inserts.
+ *
+ * Normally every page a query brings in takes a victim frame from the replacer, so a single scan over a big table
+ * flushes everybody else's working set out of the pool. A query that passes a ring to the buffer pool manager (along
+ * with AccessType::Scan) instead recycles the frames of the pages it brought in itself once it holds num_frames of
+ * them. The ring's own repeated accesses are not recorded by the replacer either, so its pages are the first to go
+ * once the query is done with them.
+ *
+ * A page is no longer the ring's to recycle once anybody else fetches it. A ring belongs to one query and must only be
+ * used by one thread at a time.
+ */
+class BufferRing {
+  friend class BufferPoolManager;
+
+ public:
+  /**
+   * @brief Creates a new ring.
+   * @param num_frames the number of frames the ring may hold on to, split evenly across the instances of a parallel
+   * buffer pool
+   */
+  explicit BufferRing(size_t num_frames) : num_frames_(num_frames) {}
+
+  DISALLOW_COPY_AND_MOVE(BufferRing);
+
+  /** @return the number of frames the ring may hold on to */
+  auto GetNumFrames() const -> size_t { return num_frames_; }
+
+ private:
+  const size_t num_frames_;
+  /** Per buffer pool instance, the frames the ring brought pages into, oldest first. */
+  std::unordered_map<const BufferPoolManager *, std::deque<frame_id_t>> frames_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_pro_replacer.h
+//
+// Identification: src/include/buffer/clock_pro_replacer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ClockProReplacer implements the CLOCK-Pro policy (Jiang, Chen and Zhang, USENIX ATC 2005).
+ *
+ * All frames sit on one clock, together with the pages of recently evicted frames. A page is either hot or cold, and
+ * a new page comes in cold and "in test": if it is accessed again before its test ends, it becomes hot. Three hands
+ * go round the clock:
+ * - hand_cold picks the victim among the cold pages. A cold page with its reference bit set gets another round
+ *   instead, and becomes hot if it was in test. A cold page that is evicted while in test stays on the clock as a
+ *   non-resident page, so that it becomes hot right away if it comes back.
+ * - hand_hot turns hot pages that were not referenced since its last visit cold, and ends the test of the cold pages
+ *   it passes.
+ * - hand_test keeps the number of non-resident pages at the number of frames.
+ *
+ * The number of frames given to cold pages adapts: it grows when a non-resident page comes back and shrinks when a
+ * test ends without one. Reference bits are set by RecordAccess() without moving anything, so a hit only takes the
+ * latch for a moment.
+ */
+class ClockProReplacer : public Replacer {
+ public:
+  /**
+   * @brief Creates a new ClockProReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit ClockProReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ClockProReplacer);
+
+  ~ClockProReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &try_evict) -> bool override;
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+  void Remove(frame_id_t frame_id) override;
+  auto Size() -> size_t override;
+
+  /** @return the current target number of cold frames, for testing */
+  auto GetColdTarget() -> size_t;
+
+ private:
+  struct Entry {
+    page_id_t page_id_;
+    /** -1 for a non-resident page. */
+    frame_id_t frame_id_;
+    bool hot_{false};
+    bool ref_{false};
+    bool test_{false};
+  };
+  using EntryIter = std::list<Entry>::iterator;
+
+  struct FrameNode {
+    bool tracked_{false};
+    bool is_evictable_{false};
+    EntryIter pos_;
+  };
+
+  /** @return the entry after it on the clock */
+  auto Next(EntryIter it) -> EntryIter;
+  /** Put an entry on the clock, right behind hand_hot. */
+  auto InsertAtHead(const Entry &entry) -> EntryIter;
+  void MoveToHead(EntryIter it);
+  /** Take an entry off the clock, moving the hands that point at it along. */
+  void RemoveEntry(EntryIter it);
+  /** Stop tracking the frame of a resident entry, keeping the entry as non-resident if it is cold and in test. */
+  void EvictEntry(EntryIter it);
+  /** Run hand_hot until it has turned one hot page cold. */
+  void RunHandHot();
+  /** Run hand_test until there are at most as many non-resident pages as frames. */
+  void RunHandTest();
+  void GrowColdTarget();
+  void ShrinkColdTarget();
+
+  const size_t capacity_;
+  std::vector<FrameNode> frames_;
+  std::list<Entry> clock_;
+  std::unordered_map<page_id_t, EntryIter> non_resident_;
+  EntryIter hand_hot_;
+  EntryIter hand_cold_;
+  EntryIter hand_test_;
+  size_t hot_count_{0};
+  /** The target number of cold frames. */
+  size_t cold_target_{1};
+  size_t curr_size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table.h
+//
+// Identification: src/include/buffer/concurrent_page_table.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ConcurrentPageTable maps the ids of the pages resident in a buffer pool to their frames.
+ *
+ * It is a fixed-size open-addressing hash table with linear probing. Each slot is a single atomic word holding both
+ * the page id and the frame id, so Find() needs no lock at all. Insert() and Erase() must be serialized by the caller
+ * (the buffer pool manager's latch).
+ *
+ * Erase() closes the gap it leaves by shifting later entries back instead of leaving a tombstone. A Find() racing with
+ * such a shift may miss an entry that is present, and a Find() racing with any writer may return an entry that was
+ * just erased. Lock-free readers must therefore validate what they find, and only trust a miss once they hold the
+ * writers' lock.
+ */
+class ConcurrentPageTable {
+ public:
+  /**
+   * @brief Creates a new page table.
+   * @param max_entries the most entries the table will hold at once, i.e. the number of frames of the buffer pool
+   */
+  explicit ConcurrentPageTable(size_t max_entries);
+
+  DISALLOW_COPY_AND_MOVE(ConcurrentPageTable);
+
+  /**
+   * @brief Look up the frame of a page. Safe to call concurrently with anything.
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame holding the page
+   * @return true if the page was found
+   */
+  auto Find(page_id_t page_id, frame_id_t *frame_id) const -> bool;
+
+  /**
+   * @brief Map page_id to frame_id, replacing any existing mapping of page_id.
+   * @param page_id the page
+   * @param frame_id the frame now holding the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * @brief Remove the mapping of page_id.
+   * @param page_id the page
+   * @return true if page_id was mapped
+   */
+  auto Erase(page_id_t page_id) -> bool;
+
+  /** @return the number of mapped pages */
+  auto Size() const -> size_t { return size_; }
+
+ private:
+  static constexpr uint64_t EMPTY_SLOT = ~static_cast<uint64_t>(0);
+
+  static auto MakeSlot(page_id_t page_id, frame_id_t frame_id) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static auto PageOf(uint64_t slot) -> page_id_t { return static_cast<page_id_t>(slot >> 32); }
+  static auto FrameOf(uint64_t slot) -> frame_id_t { return static_cast<frame_id_t>(slot & 0xFFFFFFFF); }
+
+  /** @return the slot page_id hashes to */
+  auto HomeOf(page_id_t page_id) const -> size_t;
+
+  /** Number of slots minus one; the number of slots is a power of two. */
+  size_t mask_;
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  size_t size_{0};
+};
+
+}  // namespace bustub
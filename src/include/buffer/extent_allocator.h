@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extent_allocator.h
+//
+// Identification: src/include/buffer/extent_allocator.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_ring.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+class Page;
+
+/**
+ * ExtentAllocator creates the pages of one table heap or index. It reserves page ids an extent at a time with
+ * BufferPoolManager::AllocateExtent() and hands them out in order, so that the pages of its owner lie next to each
+ * other on disk and a scan over them reads the file sequentially, however many owners grow at the same time.
+ *
+ * Every extent after the first is reserved close to the last page of the previous one. The pages of the current
+ * extent that were not used yet are given back when the allocator is destroyed.
+ */
+class ExtentAllocator {
+ public:
+  /**
+   * @brief Creates a new ExtentAllocator.
+   * @param bpm the buffer pool to create the pages in
+   * @param near_page_id a page the first extent should be close to, e.g. the first page of an existing table
+   * @param extent_size the number of pages to reserve at a time
+   */
+  explicit ExtentAllocator(BufferPoolManager *bpm, page_id_t near_page_id = INVALID_PAGE_ID,
+                           size_t extent_size = EXTENT_SIZE);
+
+  DISALLOW_COPY_AND_MOVE(ExtentAllocator);
+
+  ~ExtentAllocator();
+
+  /**
+   * @brief Create a new page with the next id of the current extent, reserving a new extent if it is used up.
+   * @param[out] page_id id of the created page
+   * @param ring the buffer ring of a bulk insert, or nullptr
+   * @return nullptr if no new page could be created, otherwise pointer to the new page
+   */
+  auto NewPage(page_id_t *page_id, BufferRing *ring = nullptr) -> Page *;
+
+ private:
+  BufferPoolManager *bpm_;
+  const size_t extent_size_;
+  /** The reserved ids of the current extent, and the next one to hand out. */
+  std::vector<page_id_t> extent_;
+  size_t next_{0};
+  /** The page the next extent should be close to. */
+  page_id_t last_page_id_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
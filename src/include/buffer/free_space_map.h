@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/buffer/free_space_map.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+class Page;
+
+/**
+ * FreeSpaceMap keeps track of which pages of a buffer pool instance are allocated, so that deleted pages are handed
+ * out again instead of growing the database file.
+ *
+ * The map is a bitmap stored in FreeSpaceMapPages that live in the database file and go through the buffer pool like
+ * any other page. The pages of an instance are split into groups of FreeSpaceMapPage::NUM_BITS; the first page of
+ * every group is the map page of that group and is marked allocated in it. Groups are only added once all earlier
+ * groups are full, so on restart the map is found by reading map pages until the first one that was never written.
+ *
+ * Allocation takes the free page closest to a hint page in the hint's group, and otherwise the lowest free page,
+ * which keeps the file dense. The number of free pages per group is kept in memory so full groups are never read.
+ *
+ * The map pages are not logged: the map is only guaranteed to be consistent with the data after a clean shutdown. The
+ * map must be used for a database file from its creation on, since it claims the first page of every group.
+ */
+class FreeSpaceMap {
+ public:
+  /**
+   * @brief Creates a new FreeSpaceMap for a buffer pool instance.
+   * @param bpm the buffer pool instance whose pages are tracked, and through which the map pages are read and written
+   * @param num_instances the total number of instances of the parallel buffer pool, 1 if there is none
+   * @param instance_index the index of the instance
+   */
+  FreeSpaceMap(BufferPoolManager *bpm, uint32_t num_instances, uint32_t instance_index);
+
+  DISALLOW_COPY_AND_MOVE(FreeSpaceMap);
+
+  /**
+   * @brief Read the map pages of an existing database, initializing the first one for a new database.
+   * @return the page id that follows the last allocated page of the instance
+   */
+  auto Open() -> page_id_t;
+
+  /**
+   * @brief Allocate a page.
+   * @param near_page_id a page of this instance to allocate close to, or INVALID_PAGE_ID
+   * @return the id of the allocated page, or INVALID_PAGE_ID if a map page could not be brought into the buffer pool
+   */
+  auto Allocate(page_id_t near_page_id = INVALID_PAGE_ID) -> page_id_t;
+
+  /**
+   * @brief Allocate a run of pages that are next to each other among the pages of this instance, after near_page_id
+   * if possible and at the lowest free run otherwise.
+   * @param num_pages the length of the run, less than FreeSpaceMapPage::NUM_BITS
+   * @param near_page_id a page of this instance to allocate close to, or INVALID_PAGE_ID
+   * @return the ids of the allocated pages in order, or none if a map page could not be brought into the buffer pool
+   */
+  auto AllocateRun(size_t num_pages, page_id_t near_page_id = INVALID_PAGE_ID) -> std::vector<page_id_t>;
+
+  /**
+   * @brief Mark a page free. Freeing a map page or a page that is not allocated does nothing.
+   * @return false if the map page could not be brought into the buffer pool, true otherwise
+   */
+  auto Free(page_id_t page_id) -> bool;
+
+  /** @return whether page_id is allocated */
+  auto IsAllocated(page_id_t page_id) -> bool;
+
+  /** @return whether page_id is the map page of a group */
+  auto IsMapPage(page_id_t page_id) const -> bool;
+
+  /** @return the number of groups, i.e. of map pages */
+  auto GetGroupCount() -> size_t;
+
+ private:
+  /** @return the number of page_id among the pages of this instance */
+  auto ToLocal(page_id_t page_id) const -> int64_t;
+  auto ToPageId(int64_t local) const -> page_id_t;
+
+  /** @return the id of the map page of group */
+  auto MapPageId(size_t group) const -> page_id_t;
+
+  /**
+   * Fetch and write-latch the map page of group, initializing it if the group is the next one to be added.
+   * @return the map page, or nullptr if it could not be fetched
+   */
+  auto FetchMapPage(size_t group) -> Page *;
+
+  /**
+   * Allocate the free page of group closest to bit (or the lowest one for bit 0), adding the group if it does not
+   * exist yet.
+   * @return the id of the allocated page, or INVALID_PAGE_ID if the map page could not be fetched
+   */
+  auto AllocateInGroup(size_t group, int bit) -> page_id_t;
+
+  /**
+   * Allocate the first run of num_pages free pages of group from bit on, or from the start of the group if there is
+   * none after bit, adding the group if it does not exist yet.
+   * @return whether a run was found and appended to page_ids
+   */
+  auto AllocateRunInGroup(size_t group, int bit, int num_pages, std::vector<page_id_t> *page_ids) -> bool;
+
+  BufferPoolManager *bpm_;
+  const uint32_t num_instances_;
+  const uint32_t instance_index_;
+  /** The number of free pages of every group. */
+  std::vector<int> free_counts_;
+  /** Serializes all changes of the map. Taken before, never while holding, the buffer pool latch. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -12,28 +12,35 @@
 
 #pragma once
 
+#include <functional>
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
 namespace bustub {
 
-enum class AccessType { Unknown = 0, Get, Scan };
-
 class LRUKNode {
- private:
-  /** History of last seen K timestamps of this page. Least recent timestamp stored in front. */
-  // Remove maybe_unused if you start using them. Feel free to change the member variables as you want.
+  friend class LRUKReplacer;
+
+ public:
+  LRUKNode() = default;
 
-  [[maybe_unused]] std::list<size_t> history_;
-  [[maybe_unused]] size_t k_;
-  [[maybe_unused]] frame_id_t fid_;
-  [[maybe_unused]] bool is_evictable_{false};
+ private:
+  /** Number of timestamps in the history of this frame, at most k. */
+  size_t history_size_{0};
+  /** Once the history is full, the slot of its least recent timestamp; the next access overwrites it. */
+  size_t history_head_{0};
+  /** Neighbours in the list of frames with fewer than k accesses. */
+  frame_id_t prev_{INVALID_PAGE_ID};
+  frame_id_t next_{INVALID_PAGE_ID};
+  /** Position in the heap of evictable frames with k accesses, if it is in there. */
+  size_t heap_pos_{std::numeric_limits<size_t>::max()};
+  bool is_tracked_{false};
+  bool is_evictable_{false};
 };
 
 /**
@@ -46,13 +53,16 @@ class LRUKNode {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multipe frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * The last k timestamps of every frame are kept in a ring of k slots of one flat array, so recording an access never
+ * allocates. Frames with fewer than k accesses are kept in a list in order of their first access, which is the order
+ * they are evicted in. Evictable frames with k accesses are kept in a binary heap on their k-th most recent access.
+ * Evict() is O(1) for a frame of the list, plus a step per non-evictable frame in front of it, and O(log n) for a
+ * frame of the heap; RecordAccess() and SetEvictable() are O(log n).
  */
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief a new LRUKReplacer.
    * @param num_frames the maximum number of frames the LRUReplacer will be required to store
    */
@@ -61,15 +71,11 @@ class LRUKReplacer {
   DISALLOW_COPY_AND_MOVE(LRUKReplacer);
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Find the frame with largest backward k-distance and evict that frame. Only frames
    * that are marked as 'evictable' are candidates for eviction.
    *
@@ -83,11 +89,29 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
-   * TODO(P1): Add implementation
+   * @brief Like Evict(), but only evict a frame if try_evict(frame_id) agrees; otherwise move on to the next best
+   * evictable frame. The buffer pool manager pins resident pages without telling the replacer, and uses this to
+   * claim a victim that is really unpinned, atomically with respect to those pins.
    *
+   * @param[out] frame_id id of frame that is evicted.
+   * @param try_evict called with each candidate in eviction order until it returns true
+   * @return true if a frame is evicted successfully, false if try_evict refused every evictable frame.
+   */
+  auto Evict(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &try_evict) -> bool override;
+
+  /**
+   * @brief Return the frames that Evict() would pick next, in the order it would pick them, without evicting
+   * anything. Used by the page cleaner to write dirty pages back before they are needed.
+   *
+   * @param max_frames the maximum number of frames to return
+   * @return up to max_frames evictable frames, the next victim first
+   */
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+
+  /**
    * @brief Record the event that the given frame id is accessed at current timestamp.
    * Create a new entry for access history if frame id has not been seen before.
    *
@@ -97,12 +121,12 @@ class LRUKReplacer {
    * @param frame_id id of frame that received a new access.
    * @param access_type type of access that was received. This parameter is only needed for
    * leaderboard tests.
+   * @param page_id the page in the frame, unused by LRU-K.
    */
-  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown);
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Toggle whether a frame is evictable or non-evictable. This function also
    * controls replacer's size. Note that size is equal to number of evictable entries.
    *
@@ -117,11 +141,9 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Remove an evictable frame from replacer, along with its access history.
    * This function should also decrement replacer's size if removal is successful.
    *
@@ -136,26 +158,47 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Return replacer's size, which tracks the number of evictable frames.
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  [[maybe_unused]] std::unordered_map<frame_id_t, LRUKNode> node_store_;
-  [[maybe_unused]] size_t current_timestamp_{0};
-  [[maybe_unused]] size_t curr_size_{0};
-  [[maybe_unused]] size_t replacer_size_;
-  [[maybe_unused]] size_t k_;
-  [[maybe_unused]] std::mutex latch_;
+  /** @return the timestamp that orders the frame: its first access with +inf k-distance, its k-th last otherwise */
+  auto OrderingTimestamp(frame_id_t frame_id) const -> size_t;
+  /** Stop tracking a frame, which must be evictable. */
+  void RemoveFrame(frame_id_t frame_id);
+
+  void ListPushBack(frame_id_t frame_id);
+  void ListErase(frame_id_t frame_id);
+
+  void HeapPush(frame_id_t frame_id);
+  void HeapErase(size_t pos);
+  void HeapSiftUp(size_t pos);
+  void HeapSiftDown(size_t pos);
+  void HeapSwap(size_t a, size_t b);
+  auto HeapLess(size_t a, size_t b) const -> bool {
+    return OrderingTimestamp(heap_[a]) < OrderingTimestamp(heap_[b]);
+  }
+
+  /** Per frame, its history and where it is kept. */
+  std::vector<LRUKNode> node_store_;
+  /** The histories: k timestamps per frame, frame i at [i * k, (i + 1) * k). */
+  std::vector<size_t> history_;
+  /** Frames with fewer than k accesses, evictable or not, in order of their first access. */
+  frame_id_t inf_head_{INVALID_PAGE_ID};
+  frame_id_t inf_tail_{INVALID_PAGE_ID};
+  /** Evictable frames with k accesses, as a min-heap on their k-th most recent access. */
+  std::vector<frame_id_t> heap_;
+  size_t current_timestamp_{0};
+  size_t curr_size_{0};
+  size_t replacer_size_;
+  size_t k_;
+  std::mutex latch_;
 };
 
 }  // namespace bustub
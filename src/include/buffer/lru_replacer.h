@@ -16,15 +16,17 @@
 #include <mutex>  // NOLINT
 #include <vector>
 
-#include "buffer/replacer.h"
 #include "common/config.h"
 
 namespace bustub {
 
 /**
  * LRUReplacer implements the Least Recently Used replacement policy.
+ *
+ * It keeps the pin/unpin interface of the original project. The buffer pool manager takes any policy that implements
+ * Replacer instead (see MakeReplacer()).
  */
-class LRUReplacer : public Replacer {
+class LRUReplacer {
  public:
   /**
    * Create a new LRUReplacer.
@@ -35,15 +37,29 @@ class LRUReplacer : public Replacer {
   /**
    * Destroys the LRUReplacer.
    */
-  ~LRUReplacer() override;
+  ~LRUReplacer();
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  /**
+   * Remove the victim frame as defined by the replacement policy.
+   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
+   * @return true if a victim frame was found, false otherwise
+   */
+  auto Victim(frame_id_t *frame_id) -> bool;
 
-  void Pin(frame_id_t frame_id) override;
+  /**
+   * Pins a frame, indicating that it should not be victimized until it is unpinned.
+   * @param frame_id the id of the frame to pin
+   */
+  void Pin(frame_id_t frame_id);
 
-  void Unpin(frame_id_t frame_id) override;
+  /**
+   * Unpins a frame, indicating that it can now be victimized.
+   * @param frame_id the id of the frame to unpin
+   */
+  void Unpin(frame_id_t frame_id);
 
-  auto Size() -> size_t override;
+  /** @return the number of elements in the replacer that can be victimized */
+  auto Size() -> size_t;
 
  private:
   // TODO(student): implement me!
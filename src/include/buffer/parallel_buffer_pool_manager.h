@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager hashes page ids across several independent BufferPoolManager instances. Each instance
+ * owns its own frames, page table, replacer and latch, so threads working on pages of different instances never
+ * contend with each other.
+ *
+ * Page ids are routed by `page_id % num_instances`: every instance only allocates page ids that map back to itself.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * @brief Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManager instances to create
+   * @param pool_size the pool size of each BufferPoolManager instance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of every instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param num_io_workers the number of disk scheduler threads of each instance
+   * @param replacer_policy the replacement policy of every instance
+   * @param use_frame_arena whether every instance keeps its frames in a huge-page backed FrameArena
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            size_t num_io_workers = DISK_SCHEDULER_NUM_WORKERS,
+                            ReplacerPolicy replacer_policy = ReplacerPolicy::LRUK, bool use_frame_arena = false);
+
+  /**
+   * @brief Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @brief Return the total number of frames across all instances. */
+  auto GetPoolSize() -> size_t override;
+
+  /** @brief Return the number of instances in this pool. */
+  auto GetNumInstances() const -> size_t { return instances_.size(); }
+
+  /**
+   * @brief Create a new page. Instances are tried round-robin, starting from a different instance on every call,
+   * until one of them has a frame available. With a near_page_id, its instance is tried first.
+   * @param[out] page_id id of the created page
+   * @param ring the buffer ring of a bulk insert, or nullptr
+   * @param near_page_id a page the new page should be close to on disk, or INVALID_PAGE_ID
+   * @return nullptr if every instance is full of pinned pages, otherwise pointer to the new page
+   */
+  auto NewPage(page_id_t *page_id, BufferRing *ring = nullptr, page_id_t near_page_id = INVALID_PAGE_ID)
+      -> Page * override;
+
+  auto NewPageGuarded(page_id_t *page_id, page_id_t near_page_id = INVALID_PAGE_ID) -> BasicPageGuard override;
+
+  /**
+   * @brief Reserve an extent in one instance: the instance of near_page_id if there is one, the next one round-robin
+   * otherwise.
+   */
+  auto AllocateExtent(size_t num_pages, page_id_t near_page_id = INVALID_PAGE_ID) -> std::vector<page_id_t> override;
+
+  auto NewPageAt(page_id_t page_id, BufferRing *ring = nullptr) -> Page * override;
+
+  /**
+   * @brief Fetch the requested page from the instance responsible for it.
+   * @param page_id id of page to be fetched
+   * @param access_type type of access to the page
+   * @param ring the buffer ring of a large scan, or nullptr
+   * @return the requested page, or nullptr if it cannot be fetched
+   */
+  auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown, BufferRing *ring = nullptr)
+      -> Page * override;
+
+  auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard override;
+  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard override;
+  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard override;
+
+  /**
+   * @brief Read the page ahead in the instance responsible for it.
+   * @return true if the page was already resident and fully read in
+   */
+  auto PrefetchPage(page_id_t page_id, BufferRing *ring = nullptr) -> bool override;
+
+  /**
+   * @brief Unpin the page in the instance responsible for it.
+   * @return false if the page is not in the page table or its pin count is <= 0 before this call, true otherwise
+   */
+  auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool override;
+
+  /**
+   * @brief Flush the page in the instance responsible for it.
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  auto FlushPage(page_id_t page_id) -> bool override;
+
+  /**
+   * @brief Flush the dirty pages of every instance together, so that a run of adjacent pages is written with one call
+   * even though its pages alternate between instances.
+   */
+  void FlushAllPages() override;
+
+  /**
+   * @brief Delete the page from the instance responsible for it.
+   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   */
+  auto DeletePage(page_id_t page_id) -> bool override;
+
+  /** @return the number of hits of the given access type, summed over all instances */
+  auto GetHitCount(AccessType access_type) -> uint64_t override;
+
+  /** @return the number of misses of the given access type, summed over all instances */
+  auto GetMissCount(AccessType access_type) -> uint64_t override;
+
+  /** @brief Start a page cleaner on every instance, each keeping target_clean_percent of its own frames clean. */
+  void RunPageCleaner(size_t pages_per_round = PAGE_CLEANER_PAGES_PER_ROUND,
+                      std::chrono::milliseconds interval = std::chrono::milliseconds(PAGE_CLEANER_INTERVAL_MS),
+                      size_t target_clean_percent = PAGE_CLEANER_TARGET_CLEAN_PERCENT) override;
+
+  /** @brief Stop the page cleaners of all instances. */
+  void StopPageCleaner() override;
+
+  /** @return the number of evictions, summed over all instances */
+  auto GetEvictionCount() -> uint64_t override;
+
+  /** @return the number of foreground write-backs, summed over all instances */
+  auto GetForegroundWriteCount() -> uint64_t override;
+
+  /** @return the number of page cleaner writes, summed over all instances */
+  auto GetCleanerWriteCount() -> uint64_t override;
+
+  /** @brief Record the accesses of all instances into trace. */
+  void SetAccessTrace(AccessTrace *trace) override;
+
+  /** @brief Give every instance a free space map of its own pages. */
+  void EnableFreeSpaceMap() override;
+
+  /**
+   * @return the resident pages of every instance, one instance after the other, each in the order its replacer would
+   * evict them
+   */
+  auto GetResidentPages() -> std::vector<page_id_t> override;
+
+  /** @return the dirty page tables of all instances, one after the other */
+  auto GetDirtyPageTable() -> std::vector<std::pair<page_id_t, lsn_t>> override;
+
+  /** @brief Warm up all instances at the same time, each with its own pages. */
+  auto WarmUp(const std::vector<page_id_t> &page_ids, const std::atomic<bool> *running = nullptr) -> size_t override;
+
+  /**
+   * @brief Return the instance responsible for page_id.
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManager *;
+
+ private:
+  /** The individual buffer pool instances. */
+  std::vector<std::unique_ptr<BufferPoolManager>> instances_;
+  /** The instance NewPage starts probing from; advanced on every call. */
+  std::atomic<size_t> next_instance_{0};
+};
+
+}  // namespace bustub
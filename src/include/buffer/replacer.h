@@ -12,12 +12,28 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+enum class AccessType { Unknown = 0, Get, Scan };
+
+/** The replacement policies the buffer pool manager can use. */
+enum class ReplacerPolicy { LRUK = 0, ARC, TwoQueue, ClockPro };
+
 /**
- * Replacer is an abstract class that tracks page usage.
+ * Replacer is the interface between the buffer pool manager and a replacement policy. It tracks the frames that hold
+ * pages and picks the frame to reuse when the buffer pool needs one.
+ *
+ * A frame is tracked from its first RecordAccess() until it is evicted or removed. Only frames marked evictable are
+ * candidates for eviction. The buffer pool manager does not tell the replacer about pins: it refuses pinned victims
+ * through the try_evict callback of Evict() instead.
  */
 class Replacer {
  public:
@@ -25,26 +41,65 @@ class Replacer {
   virtual ~Replacer() = default;
 
   /**
-   * Remove the victim frame as defined by the replacement policy.
-   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
-   * @return true if a victim frame was found, false otherwise
+   * @brief Evict the frame the policy picks among the evictable frames, and stop tracking it.
+   * @param[out] frame_id id of frame that is evicted.
+   * @return true if a frame is evicted successfully, false if no frames can be evicted.
+   */
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * @brief Like Evict(), but only evict a frame if try_evict(frame_id) agrees; otherwise move on to the frame the
+   * policy would pick next.
+   * @param[out] frame_id id of frame that is evicted.
+   * @param try_evict called with each candidate in eviction order until it returns true
+   * @return true if a frame is evicted successfully, false if try_evict refused every evictable frame.
+   */
+  virtual auto Evict(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &try_evict) -> bool = 0;
+
+  /**
+   * @brief Return the frames that Evict() would pick next, in about the order it would pick them, without evicting
+   * anything.
+   * @param max_frames the maximum number of frames to return
    */
-  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+  virtual auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> = 0;
 
   /**
-   * Pins a frame, indicating that it should not be victimized until it is unpinned.
-   * @param frame_id the id of the frame to pin
+   * @brief Record an access to the given frame, and start tracking it (as non-evictable) if it is not tracked yet.
+   * @param frame_id id of frame that received a new access.
+   * @param access_type type of access that was received.
+   * @param page_id the page in the frame. Policies that remember evicted pages use it to recognize a page that comes
+   * back; it may be INVALID_PAGE_ID if unknown.
    */
-  virtual void Pin(frame_id_t frame_id) = 0;
+  virtual void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                            page_id_t page_id = INVALID_PAGE_ID) = 0;
 
   /**
-   * Unpins a frame, indicating that it can now be victimized.
-   * @param frame_id the id of the frame to unpin
+   * @brief Toggle whether a frame is evictable. Untracked frames are ignored.
    */
-  virtual void Unpin(frame_id_t frame_id) = 0;
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
 
-  /** @return the number of elements in the replacer that can be victimized */
+  /**
+   * @brief Stop tracking an evictable frame without evicting it, e.g. because its page was deleted. Untracked frames
+   * are ignored.
+   */
+  virtual void Remove(frame_id_t frame_id) = 0;
+
+  /** @return the number of evictable frames */
   virtual auto Size() -> size_t = 0;
 };
 
+/**
+ * @brief Create a replacer.
+ * @param policy the replacement policy
+ * @param num_frames the number of frames of the buffer pool
+ * @param k the lookback constant, for LRU-K
+ */
+auto MakeReplacer(ReplacerPolicy policy, size_t num_frames, size_t k) -> std::unique_ptr<Replacer>;
+
+/** @return the policy called name ("lru-k", "arc", "2q" or "clock-pro"), if there is one */
+auto ReplacerPolicyFromString(const std::string &name) -> std::optional<ReplacerPolicy>;
+
+/** @return the name of the policy */
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> std::string;
+
 }  // namespace bustub
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the full version of the 2Q policy (Johnson and Shasha, VLDB 1994).
+ *
+ * A page that comes in goes to A1in, a FIFO queue of about a quarter of the frames; accessing it again there does not
+ * change anything, since such accesses are usually correlated (e.g. several tuples of one page). When it falls out of
+ * A1in, its page id is remembered in the ghost queue A1out, sized for about half the frames. Only a page that comes
+ * back while in A1out is considered hot and goes to Am, which is managed as LRU. Eviction takes the oldest frame of
+ * A1in while A1in is above its share, and the least recently used frame of Am otherwise.
+ *
+ * Pages used by a single scan never get past A1in. Eviction is O(1), plus one step per pinned or non-evictable frame
+ * it has to skip.
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * @brief Creates a new TwoQueueReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit TwoQueueReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(TwoQueueReplacer);
+
+  ~TwoQueueReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id, const std::function<bool(frame_id_t)> &try_evict) -> bool override;
+  auto GetEvictionCandidates(size_t max_frames) -> std::vector<frame_id_t> override;
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+  void Remove(frame_id_t frame_id) override;
+  auto Size() -> size_t override;
+
+ private:
+  enum class QueueId { None, A1In, Am };
+
+  struct FrameNode {
+    QueueId queue_{QueueId::None};
+    std::list<frame_id_t>::iterator pos_;
+    page_id_t page_id_{INVALID_PAGE_ID};
+    bool is_evictable_{false};
+  };
+
+  /** @return A1in if it is above its share, Am otherwise */
+  auto PreferredQueue() -> QueueId;
+  auto QueueOf(QueueId queue) -> std::list<frame_id_t> & { return queue == QueueId::A1In ? a1in_ : am_; }
+
+  const size_t capacity_;
+  /** The number of frames A1in may hold before it is evicted from first. */
+  const size_t a1in_share_;
+  /** The number of page ids A1out remembers. */
+  const size_t a1out_size_;
+  /** Per frame, where it is. */
+  std::vector<FrameNode> frames_;
+  /** Newest or most recently used first. */
+  std::list<frame_id_t> a1in_;
+  std::list<frame_id_t> am_;
+  std::list<page_id_t> a1out_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> a1out_index_;
+  size_t curr_size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
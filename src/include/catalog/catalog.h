@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -228,11 +229,20 @@ class Catalog {
     // TODO(chi): support both hash index and btree index
     auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap: collect and sort their keys, then build the tree bottom-up
+    // from them rather than inserting them one by one. The scan goes through a buffer ring, like a sequential scan.
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+    std::vector<std::pair<KeyType, ValueType>> entries;
+    BufferRing ring(std::min<size_t>(BUFFER_RING_SIZE, bpm_->GetPoolSize() / 4));
+    for (auto tuple = heap->Begin(txn, &ring); tuple != heap->End(); ++tuple) {
+      KeyType key;
+      key.SetFromKey(tuple->KeyFromTuple(schema, key_schema, key_attrs));
+      entries.emplace_back(key, tuple->GetRid());
+    }
+    if (!index->BulkLoad(&entries)) {
+      // The buffer pool ran out of frames for the index pages.
+      return NULL_INDEX_INFO;
     }
 
     // Get the next OID for the new index
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "catalog/catalog.h"
 #include "common/config.h"
 #include "common/util/string_util.h"
@@ -217,9 +218,24 @@ class BustubInstance {
   auto MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext>;
 
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  /**
+   * Create a BusTub instance backed by a database file.
+   * @param db_file_name the database file
+   * @param bpm_size the total number of frames in the buffer pool
+   * @param bpm_shards the number of independent buffer pool instances the frames are split across
+   * @param replacer_policy the replacement policy of the buffer pool
+   */
+  explicit BustubInstance(const std::string &db_file_name, size_t bpm_size = 128, size_t bpm_shards = 1,
+                          ReplacerPolicy replacer_policy = ReplacerPolicy::LRUK);
 
-  BustubInstance();
+  /**
+   * Create an in-memory BusTub instance.
+   * @param bpm_size the total number of frames in the buffer pool
+   * @param bpm_shards the number of independent buffer pool instances the frames are split across
+   * @param replacer_policy the replacement policy of the buffer pool
+   */
+  explicit BustubInstance(size_t bpm_size = 128, size_t bpm_shards = 1,
+                          ReplacerPolicy replacer_policy = ReplacerPolicy::LRUK);
 
   ~BustubInstance();
 
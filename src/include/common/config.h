@@ -36,6 +36,24 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int DISK_SCHEDULER_NUM_WORKERS = 4;  // number of background I/O threads per disk scheduler
+static constexpr int TABLE_READ_AHEAD_MIN_PAGES = 2;   // initial read-ahead window of a table scan
+static constexpr int TABLE_READ_AHEAD_MAX_PAGES = 64;  // read-ahead window cap of a table scan (also <= pool size / 4)
+static constexpr int BUFFER_RING_SIZE = 32;  // frames recycled by a large scan or bulk insert (also <= pool size / 4)
+static constexpr int PAGE_CLEANER_INTERVAL_MS = 10;          // how often the page cleaner wakes up
+static constexpr int PAGE_CLEANER_PAGES_PER_ROUND = 16;      // most dirty pages the page cleaner writes per wake-up
+static constexpr int PAGE_CLEANER_TARGET_CLEAN_PERCENT = 25;  // share of frames the page cleaner keeps free or clean
+static constexpr int CACHE_LINE_SIZE = 64;                    // alignment of per-frame metadata
+static constexpr int HUGE_PAGE_SIZE = 2 * 1024 * 1024;       // transparent huge page size the frame arena aligns to
+static constexpr int EXTENT_SIZE = 64;  // pages a table heap or index reserves at a time, and the file grows by
+static constexpr int WRITEBACK_MAX_RUN_PAGES = 64;  // most adjacent pages FlushAllPages merges into one vectored write
+static constexpr int WARM_RESTART_SNAPSHOT_INTERVAL_MS = 60000;  // how often the resident page set is saved
+static constexpr int WARM_RESTART_BATCH_PAGES = 32;  // pages a warm-up reads, and holds pinned, at a time
+static constexpr int RECOVERY_NUM_WORKERS = 4;  // threads that redo the log by page and undo it by transaction
+static constexpr int64_t LOG_SEGMENT_SIZE = 16 * 1024 * 1024;  // size of a WAL segment file in byte
+static constexpr int LOG_MAX_SPARE_SEGMENTS = 4;  // WAL segments before the redo point kept for reuse
+static constexpr double INDEX_BULK_LOAD_FILL_FACTOR = 0.9;  // share of a B+ tree page a bulk load fills
+static constexpr int INDEX_OPTIMISTIC_READ_ATTEMPTS = 4;     // unlatched descents of a B+ tree lookup before it latches
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -13,9 +13,12 @@
 #pragma once
 
 #include <atomic>
+#include <mutex>  // NOLINT
 #include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "concurrency/lock_manager.h"
@@ -77,6 +80,13 @@ class TransactionManager {
     return res;
   }
 
+  /**
+   * The active transaction table of a fuzzy checkpoint. Every transaction whose BEGIN record was appended before this
+   * call, and that has not appended its COMMIT or ABORT record yet, is listed. Only kept while logging is enabled.
+   * @return (transaction id, LSN of the BEGIN record) of the running transactions
+   */
+  auto GetActiveTransactions() -> std::vector<std::pair<txn_id_t, lsn_t>>;
+
   /** Prevents all transactions from performing operations, used for checkpointing. */
   void BlockAllTransactions();
 
@@ -84,6 +94,9 @@ class TransactionManager {
   void ResumeTransactions();
 
  private:
+  /** Remove a transaction from the active transaction table once its COMMIT or ABORT record is appended. */
+  void EndActiveTransaction(txn_id_t txn_id);
+
   /**
    * Releases all the locks held by the given transaction.
    * @param txn the transaction whose locks should be released
@@ -138,6 +151,11 @@ class TransactionManager {
   LockManager *lock_manager_ __attribute__((__unused__));
   LogManager *log_manager_ __attribute__((__unused__));
 
+  /** The LSN of the BEGIN record of every running transaction, while logging is enabled. */
+  std::unordered_map<txn_id_t, lsn_t> active_txns_;
+  /** Protects active_txns_, and makes appending a BEGIN record and listing its transaction one step. */
+  std::mutex active_txns_latch_;
+
   /** The global transaction latch is used for checkpointing. */
   ReaderWriterLatch global_txn_latch_;
 };
@@ -15,6 +15,7 @@
 #include <memory>
 #include <utility>
 
+#include "buffer/buffer_ring.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/insert_plan.h"
@@ -57,6 +58,15 @@ class InsertExecutor : public AbstractExecutor {
  private:
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
+
+  /** The child executor from which inserted tuples are pulled */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The frames the insert recycles, so that loading a big table does not push everything else out of the pool */
+  std::unique_ptr<BufferRing> ring_;
+
+  /** Whether the number of inserted rows has been emitted yet */
+  bool done_{false};
 };
 
 }  // namespace bustub
@@ -12,11 +12,14 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "buffer/buffer_ring.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -50,5 +53,14 @@ class SeqScanExecutor : public AbstractExecutor {
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+
+  /** The table being scanned */
+  TableInfo *table_info_{nullptr};
+
+  /** The frames the scan recycles, so that it does not push everything else out of the buffer pool */
+  std::unique_ptr<BufferRing> ring_;
+
+  /** The position of the scan; reads the table ahead as it goes */
+  std::unique_ptr<TableIterator> iter_;
 };
 }  // namespace bustub
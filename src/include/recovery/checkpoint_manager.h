@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/transaction_manager.h"
 #include "recovery/log_manager.h"
@@ -19,7 +21,12 @@
 namespace bustub {
 
 /**
- * CheckpointManager creates consistent checkpoints by blocking all other transactions temporarily.
+ * CheckpointManager takes ARIES-style fuzzy checkpoints while transactions keep running. Nothing is flushed and
+ * nothing is blocked: BeginCheckpoint() logs a BEGIN_CHECKPOINT record, snapshots the active transaction table and
+ * the dirty page table with the recovery LSN of every dirty page, and logs them in END_CHECKPOINT records.
+ * EndCheckpoint() makes those records durable and points the master record at them. Recovery then starts scanning the
+ * log at the oldest of the BEGIN_CHECKPOINT record, the dirty pages' recovery LSNs and the active transactions' BEGIN
+ * records, instead of at the beginning of the log, and the log segments before that redo point are recycled.
  */
 class CheckpointManager {
  public:
@@ -35,9 +42,18 @@ class CheckpointManager {
   void EndCheckpoint();
 
  private:
-  TransactionManager *transaction_manager_ __attribute__((__unused__));
-  LogManager *log_manager_ __attribute__((__unused__));
-  BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
+  /** A larger checkpoint is split across several END_CHECKPOINT records, so that each fits in a log buffer. */
+  static constexpr size_t MAX_ENTRIES_PER_RECORD = 1024;
+
+  TransactionManager *transaction_manager_;
+  LogManager *log_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+
+  /** The LSNs of the BEGIN_CHECKPOINT record and of the last END_CHECKPOINT record of the checkpoint in progress. */
+  lsn_t begin_lsn_{INVALID_LSN};
+  lsn_t end_lsn_{INVALID_LSN};
+  /** Where recovery starts scanning the log once the checkpoint in progress is complete. */
+  int64_t scan_offset_{0};
 };
 
 }  // namespace bustub
@@ -16,6 +16,9 @@
 #include <condition_variable>  // NOLINT
 #include <future>              // NOLINT
 #include <mutex>               // NOLINT
+#include <thread>              // NOLINT
+#include <utility>
+#include <vector>
 
 #include "recovery/log_record.h"
 #include "storage/disk/disk_manager.h"
@@ -23,22 +26,39 @@
 namespace bustub {
 
 /**
- * LogManager maintains a separate thread that is awakened whenever the log buffer is full or whenever a timeout
- * happens. When the thread is awakened, the log buffer's content is written into the disk log file.
+ * LogManager maintains a separate thread that is awakened whenever the log buffer is full, whenever a timeout
+ * happens, or whenever a committing transaction waits for its records. When the thread is awakened, the log buffer is
+ * swapped with the flush buffer and the latter is written into the disk log file while new records keep going into
+ * the former.
+ *
+ * Committers never write the log themselves: they wait until the persistent LSN covers their commit record. Every
+ * commit that arrives while one log write is in flight is made durable by the next write, so the number of log
+ * flushes per commit drops as the number of concurrent committers rises (group commit).
+ *
+ * Appending takes no lock. The LSN, the active buffer and the offset in it are packed into one atomic word (the log
+ * tail); a writer reserves its LSN and byte range with a single compare-and-swap, copies the record in parallel with
+ * other writers, and then publishes the copied bytes in the buffer's completion counter. The flush thread seals the
+ * active buffer by switching the tail to the other one, waits until the completed bytes reach the sealed offset and
+ * only then writes the buffer, so a record is never written before it has been fully copied.
  */
 class LogManager {
  public:
   explicit LogManager(DiskManager *disk_manager)
-      : next_lsn_(0), persistent_lsn_(INVALID_LSN), disk_manager_(disk_manager) {
-    log_buffer_ = new char[LOG_BUFFER_SIZE];
-    flush_buffer_ = new char[LOG_BUFFER_SIZE];
+      : persistent_lsn_(INVALID_LSN), disk_manager_(disk_manager) {
+    for (auto &buffer : buffers_) {
+      buffer = new char[LOG_BUFFER_SIZE];
+    }
+    FindLogEnd();
   }
 
   ~LogManager() {
-    delete[] log_buffer_;
-    delete[] flush_buffer_;
-    log_buffer_ = nullptr;
-    flush_buffer_ = nullptr;
+    if (flush_thread_ != nullptr) {
+      StopFlushThread();
+    }
+    for (auto &buffer : buffers_) {
+      delete[] buffer;
+      buffer = nullptr;
+    }
   }
 
   void RunFlushThread();
@@ -46,29 +66,95 @@ class LogManager {
 
   auto AppendLogRecord(LogRecord *log_record) -> lsn_t;
 
-  inline auto GetNextLSN() -> lsn_t { return next_lsn_; }
+  /**
+   * Block until every log record up to and including lsn is on disk. The flush thread is asked for an early flush
+   * instead of waiting for the timeout; without a flush thread the caller writes the log buffer itself.
+   * @param lsn the LSN that must become persistent
+   */
+  void WaitUntilPersistent(lsn_t lsn);
+
+  /**
+   * @return an offset in the log file at or before the record with the given LSN; the LSN must have been assigned
+   * by this log manager
+   */
+  auto GetLogOffset(lsn_t lsn) -> int64_t;
+
+  /**
+   * Point recovery at a completed checkpoint. The checkpoint's records must already be persistent.
+   * @param begin_lsn LSN of the BEGIN_CHECKPOINT record
+   * @param end_lsn LSN of the last END_CHECKPOINT record
+   */
+  void WriteMasterRecord(lsn_t begin_lsn, lsn_t end_lsn);
+
+  /**
+   * Recycle the log segments before the redo point of a completed checkpoint.
+   * @param offset the log offset recovery starts scanning at
+   */
+  void TruncateLog(int64_t offset);
+
+  inline auto GetNextLSN() -> lsn_t { return TailLSN(log_tail_); }
   inline auto GetPersistentLSN() -> lsn_t { return persistent_lsn_; }
   inline void SetPersistentLSN(lsn_t lsn) { persistent_lsn_ = lsn; }
-  inline auto GetLogBuffer() -> char * { return log_buffer_; }
+  inline auto GetLogBuffer() -> char * { return buffers_[TailBuffer(log_tail_)]; }
 
  private:
-  // TODO(students): you may add your own member variables
+  /**
+   * Swap the log buffer with the flush buffer and write the latter to disk. The latch is released during the write.
+   * @param lock the caller's lock on latch_; no other flush may be in progress
+   */
+  void FlushLogBuffer(std::unique_lock<std::mutex> *lock);
+
+  /**
+   * Find the end of the log on disk, so that new records continue its LSNs and are written after its last record
+   * rather than after stale records of a recycled segment.
+   */
+  void FindLogEnd();
+
+  /** Block until the active buffer has room for size more bytes, flushing it if there is no flush thread. */
+  void WaitForSpace(int size);
+
+  /** Log tail layout: | next LSN (32 bits) | active buffer (1 bit) | offset in the active buffer (31 bits) | */
+  static constexpr int LOG_TAIL_OFFSET_BITS = 31;
+
+  static inline auto MakeTail(lsn_t lsn, size_t buffer, uint64_t offset) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(lsn)) << 32) | (static_cast<uint64_t>(buffer) << 31) | offset;
+  }
+  static inline auto TailLSN(uint64_t tail) -> lsn_t { return static_cast<lsn_t>(tail >> 32); }
+  static inline auto TailBuffer(uint64_t tail) -> size_t { return (tail >> LOG_TAIL_OFFSET_BITS) & 1; }
+  static inline auto TailOffset(uint64_t tail) -> int {
+    return static_cast<int>(tail & ((uint64_t{1} << LOG_TAIL_OFFSET_BITS) - 1));
+  }
 
-  /** The atomic counter which records the next log sequence number. */
-  std::atomic<lsn_t> next_lsn_;
+  /** The next LSN, the active buffer and the number of bytes reserved in it. */
+  std::atomic<uint64_t> log_tail_{0};
   /** The log records before and including the persistent lsn have been written to disk. */
   std::atomic<lsn_t> persistent_lsn_;
 
-  char *log_buffer_;
-  char *flush_buffer_;
+  /** The active buffer takes new records while the other one is written. */
+  char *buffers_[2];
+  /** Number of bytes fully copied into each buffer since it last became active. */
+  std::atomic<int> completed_bytes_[2]{};
+
+  /** (first LSN, log offset) of every buffer written since startup or the last truncation, in LSN order. */
+  std::vector<std::pair<lsn_t, int64_t>> buffer_offsets_;
 
+  /** Protects the flush state and the buffer offsets; appenders only take it when the active buffer is full. */
   std::mutex latch_;
 
-  std::thread *flush_thread_ __attribute__((__unused__));
+  std::thread *flush_thread_{nullptr};
+  bool flush_running_{false};
+  /** Whether a committer or a full log buffer asked the flush thread not to wait for the timeout. */
+  bool flush_requested_{false};
+  /** Whether a sealed buffer is being written, and the last LSN it holds. */
+  bool flushing_{false};
+  lsn_t flushing_lsn_{INVALID_LSN};
 
+  /** Wakes up the flush thread. */
   std::condition_variable cv_;
+  /** Signalled after every buffer swap and every completed write, for appenders and committers. */
+  std::condition_variable flushed_cv_;
 
-  DiskManager *disk_manager_ __attribute__((__unused__));
+  DiskManager *disk_manager_;
 };
 
 }  // namespace bustub
@@ -14,6 +14,8 @@
 
 #include <cassert>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "storage/table/tuple.h"
@@ -32,6 +34,14 @@ enum class LogRecordType {
   ABORT,
   /** Creating a new page in the table heap. */
   NEWPAGE,
+  /** Start of a fuzzy checkpoint. */
+  BEGIN_CHECKPOINT,
+  /** End of a fuzzy checkpoint, with (a part of) its active transaction table and dirty page table. */
+  END_CHECKPOINT,
+  /** An update that logs only the bytes between the common prefix and suffix of the old and new tuple. */
+  DELTAUPDATE,
+  /** A compensation log record: the undo of a tuple record during recovery, logged as the tuple record redoing it. */
+  CLR,
 };
 
 /**
@@ -53,10 +63,24 @@ enum class LogRecordType {
  *-----------------------------------------------------------------------------------
  * | HEADER | tuple_rid | tuple_size | old_tuple_data | tuple_size | new_tuple_data |
  *-----------------------------------------------------------------------------------
+ * For delta update type log record: the old and new tuple are old_prefix + old_delta + suffix and
+ * old_prefix + new_delta + suffix, so the before and after images of the changed bytes are enough to redo and undo
+ *------------------------------------------------------------------------------------------------
+ * | HEADER | tuple_rid | delta_offset | delta_size | old_delta_data | delta_size | new_delta_data |
+ *------------------------------------------------------------------------------------------------
  * For new page type log record
- *--------------------------
- * | HEADER | prev_page_id |
- *--------------------------
+ *-------------------------------------
+ * | HEADER | prev_page_id | page_id |
+ *-------------------------------------
+ * For compensation log record: the LSN of the undone record, then a tuple record of the inverse operation without its
+ * header, e.g. an APPLYDELETE body for an undone INSERT
+ *-------------------------------------------------------------
+ * | HEADER | undo_lsn | redo_type | tuple record of redo_type |
+ *-------------------------------------------------------------
+ * For end checkpoint type log record (a large checkpoint is split across several of them)
+ *---------------------------------------------------------------------------------------------------------
+ * | HEADER | begin_lsn | scan_offset | txn_count | (txn_id, begin_lsn)... | page_count | (page_id, rec_lsn)... |
+ *---------------------------------------------------------------------------------------------------------
  */
 class LogRecord {
   friend class LogManager;
@@ -65,7 +89,7 @@ class LogRecord {
  public:
   LogRecord() = default;
 
-  // constructor for Transaction type(BEGIN/COMMIT/ABORT)
+  // constructor for Transaction type(BEGIN/COMMIT/ABORT) and BEGIN_CHECKPOINT
   LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type)
       : size_(HEADER_SIZE), txn_id_(txn_id), prev_lsn_(prev_lsn), log_record_type_(log_record_type) {}
 
@@ -98,6 +122,29 @@ class LogRecord {
     size_ = HEADER_SIZE + sizeof(RID) + old_tuple.GetLength() + new_tuple.GetLength() + 2 * sizeof(int32_t);
   }
 
+  // constructor for DELTAUPDATE type
+  LogRecord(txn_id_t txn_id, lsn_t prev_lsn, const RID &update_rid, const Tuple &old_tuple, const Tuple &new_tuple)
+      : txn_id_(txn_id), prev_lsn_(prev_lsn), log_record_type_(LogRecordType::DELTAUPDATE), update_rid_(update_rid) {
+    const char *old_data = old_tuple.GetData();
+    const char *new_data = new_tuple.GetData();
+    uint32_t old_size = old_tuple.GetLength();
+    uint32_t new_size = new_tuple.GetLength();
+    uint32_t prefix = 0;
+    while (prefix < old_size && prefix < new_size && old_data[prefix] == new_data[prefix]) {
+      prefix++;
+    }
+    uint32_t suffix = 0;
+    while (suffix < old_size - prefix && suffix < new_size - prefix &&
+           old_data[old_size - suffix - 1] == new_data[new_size - suffix - 1]) {
+      suffix++;
+    }
+    delta_offset_ = prefix;
+    old_delta_.assign(old_data + prefix, old_data + old_size - suffix);
+    new_delta_.assign(new_data + prefix, new_data + new_size - suffix);
+    // calculate log record size
+    size_ = HEADER_SIZE + sizeof(RID) + 3 * sizeof(uint16_t) + old_delta_.size() + new_delta_.size();
+  }
+
   // constructor for NEWPAGE type
   LogRecord(txn_id_t txn_id, lsn_t prev_lsn, LogRecordType log_record_type, page_id_t prev_page_id, page_id_t page_id)
       : size_(HEADER_SIZE),
@@ -110,6 +157,81 @@ class LogRecord {
     size_ = HEADER_SIZE + sizeof(page_id_t) * 2;
   }
 
+  // constructor for END_CHECKPOINT type
+  LogRecord(lsn_t begin_checkpoint_lsn, int64_t scan_offset, std::vector<std::pair<txn_id_t, lsn_t>> active_txns,
+            std::vector<std::pair<page_id_t, lsn_t>> dirty_pages)
+      : txn_id_(INVALID_TXN_ID),
+        log_record_type_(LogRecordType::END_CHECKPOINT),
+        begin_checkpoint_lsn_(begin_checkpoint_lsn),
+        scan_offset_(scan_offset),
+        active_txns_(std::move(active_txns)),
+        dirty_pages_(std::move(dirty_pages)) {
+    size_ = HEADER_SIZE + sizeof(lsn_t) + sizeof(int64_t) + 2 * sizeof(uint32_t) +
+            active_txns_.size() * (sizeof(txn_id_t) + sizeof(lsn_t)) +
+            dirty_pages_.size() * (sizeof(page_id_t) + sizeof(lsn_t));
+  }
+
+  // constructor for CLR type: the undo of the given tuple record. Its prev LSN is the undone record's, the next record
+  // of the transaction to undo.
+  LogRecord(LogRecordType log_record_type, const LogRecord &undone)
+      : txn_id_(undone.txn_id_),
+        prev_lsn_(undone.prev_lsn_),
+        log_record_type_(log_record_type),
+        undo_lsn_(undone.lsn_) {
+    assert(log_record_type == LogRecordType::CLR);
+    switch (undone.log_record_type_) {
+      case LogRecordType::INSERT:
+        redo_type_ = LogRecordType::APPLYDELETE;
+        delete_rid_ = undone.insert_rid_;
+        delete_tuple_ = undone.insert_tuple_;
+        break;
+      case LogRecordType::APPLYDELETE:
+        redo_type_ = LogRecordType::INSERT;
+        insert_rid_ = undone.delete_rid_;
+        insert_tuple_ = undone.delete_tuple_;
+        break;
+      case LogRecordType::MARKDELETE:
+        redo_type_ = LogRecordType::ROLLBACKDELETE;
+        delete_rid_ = undone.delete_rid_;
+        break;
+      case LogRecordType::ROLLBACKDELETE:
+        redo_type_ = LogRecordType::MARKDELETE;
+        delete_rid_ = undone.delete_rid_;
+        break;
+      case LogRecordType::UPDATE:
+        redo_type_ = LogRecordType::UPDATE;
+        update_rid_ = undone.update_rid_;
+        old_tuple_ = undone.new_tuple_;
+        new_tuple_ = undone.old_tuple_;
+        break;
+      case LogRecordType::DELTAUPDATE:
+        redo_type_ = LogRecordType::DELTAUPDATE;
+        update_rid_ = undone.update_rid_;
+        delta_offset_ = undone.delta_offset_;
+        old_delta_ = undone.new_delta_;
+        new_delta_ = undone.old_delta_;
+        break;
+      default:
+        assert(false);
+    }
+    // calculate log record size, header size + sizeof(undo_lsn) + sizeof(redo_type) + the redo record without header
+    size_ = HEADER_SIZE + sizeof(lsn_t) + sizeof(LogRecordType) + sizeof(RID);
+    switch (redo_type_) {
+      case LogRecordType::INSERT:
+        size_ += sizeof(int32_t) + insert_tuple_.GetLength();
+        break;
+      case LogRecordType::UPDATE:
+        size_ += old_tuple_.GetLength() + new_tuple_.GetLength() + 2 * sizeof(int32_t);
+        break;
+      case LogRecordType::DELTAUPDATE:
+        size_ += 3 * sizeof(uint16_t) + old_delta_.size() + new_delta_.size();
+        break;
+      default:
+        size_ += sizeof(int32_t) + delete_tuple_.GetLength();
+        break;
+    }
+  }
+
   ~LogRecord() = default;
 
   inline auto GetDeleteTuple() -> Tuple & { return delete_tuple_; }
@@ -126,8 +248,22 @@ class LogRecord {
 
   inline auto GetUpdateRID() -> RID & { return update_rid_; }
 
+  inline auto GetDeltaOffset() -> uint16_t { return delta_offset_; }
+
+  inline auto GetOldDelta() -> std::vector<char> & { return old_delta_; }
+
+  inline auto GetNewDelta() -> std::vector<char> & { return new_delta_; }
+
   inline auto GetNewPageRecord() -> page_id_t { return prev_page_id_; }
 
+  inline auto GetBeginCheckpointLSN() -> lsn_t { return begin_checkpoint_lsn_; }
+
+  inline auto GetScanOffset() -> int64_t { return scan_offset_; }
+
+  inline auto GetActiveTxns() -> std::vector<std::pair<txn_id_t, lsn_t>> & { return active_txns_; }
+
+  inline auto GetDirtyPages() -> std::vector<std::pair<page_id_t, lsn_t>> & { return dirty_pages_; }
+
   inline auto GetSize() -> int32_t { return size_; }
 
   inline auto GetLSN() -> lsn_t { return lsn_; }
@@ -138,6 +274,10 @@ class LogRecord {
 
   inline auto GetLogRecordType() -> LogRecordType & { return log_record_type_; }
 
+  inline auto GetUndoLSN() -> lsn_t { return undo_lsn_; }
+
+  inline auto GetRedoType() -> LogRecordType { return redo_type_; }
+
   // For debug purpose
   inline auto ToString() const -> std::string {
     std::ostringstream os;
@@ -173,9 +313,26 @@ class LogRecord {
   Tuple old_tuple_;
   Tuple new_tuple_;
 
+  // case3': for delta update operation, the update_rid_ and the bytes that differ from delta_offset_ on
+  uint16_t delta_offset_{0};
+  std::vector<char> old_delta_;
+  std::vector<char> new_delta_;
+  static_assert(BUSTUB_PAGE_SIZE <= UINT16_MAX, "tuple offsets and sizes must fit in 16 bits");
+
   // case4: for new page operation
   page_id_t prev_page_id_{INVALID_PAGE_ID};
   page_id_t page_id_{INVALID_PAGE_ID};
+
+  // case5: for end checkpoint, where recovery starts scanning the log and the tables it starts from
+  lsn_t begin_checkpoint_lsn_{INVALID_LSN};
+  int64_t scan_offset_{0};
+  std::vector<std::pair<txn_id_t, lsn_t>> active_txns_;
+  std::vector<std::pair<page_id_t, lsn_t>> dirty_pages_;
+
+  // case6: for compensation log record, the undone record and the type of the tuple record that redoes its undo, whose
+  // fields above are set
+  lsn_t undo_lsn_{INVALID_LSN};
+  LogRecordType redo_type_{LogRecordType::INVALID};
   static const int HEADER_SIZE = 20;
 };  // namespace bustub
 
@@ -13,22 +13,54 @@
 #pragma once
 
 #include <algorithm>
-#include <mutex>  // NOLINT
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/channel.h"
 #include "concurrency/lock_manager.h"
+#include "recovery/log_manager.h"
 #include "recovery/log_record.h"
 
 namespace bustub {
 
+class TablePage;
+
 /**
  * Read log file from disk, redo and undo.
+ *
+ * Redo scans the log once and hands every record, still serialized and in batches, to the worker that owns the page
+ * it changes (page id modulo the number of workers), so the records of one page are deserialized and replayed in LSN
+ * order while different pages are replayed in parallel. Undo rolls back the transactions that never finished the same
+ * way: their records go newest first to the worker that owns the page, so every page is rolled back in reverse LSN
+ * order, as if the losers were undone one record at a time.
+ *
+ * Every undo is logged as a compensation log record (CLR) before its page can reach the disk, and every loser ends
+ * with an ABORT record, so recovery can crash and run again: redo replays the CLRs like any other change, and undo
+ * skips the records a CLR already undid.
+ *
+ * If the master record points at a fuzzy checkpoint, the scan starts where the checkpoint says rather than at the
+ * beginning of the log: at the oldest recovery LSN of its dirty pages or BEGIN record of its active transactions.
+ * Records older than the checkpoint are only replayed against the pages its dirty page table lists, from their
+ * recovery LSNs on.
  */
 class LogRecovery {
  public:
-  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager)
-      : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), offset_(0) {
+  /**
+   * @param disk_manager the disk manager to read the log from
+   * @param buffer_pool_manager the buffer pool the pages are recovered in, which must write back a page only once
+   * log_manager persisted its records
+   * @param log_manager the log manager to append the CLRs and ABORT records of undo to
+   * @param num_workers the number of threads that redo and undo pages
+   */
+  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, LogManager *log_manager,
+              size_t num_workers = RECOVERY_NUM_WORKERS)
+      : disk_manager_(disk_manager),
+        buffer_pool_manager_(buffer_pool_manager),
+        log_manager_(log_manager),
+        num_workers_(std::max<size_t>(num_workers, 1)),
+        offset_(0) {
     log_buffer_ = new char[LOG_BUFFER_SIZE];
   }
 
@@ -42,15 +74,54 @@ class LogRecovery {
   auto DeserializeLogRecord(const char *data, LogRecord *log_record) -> bool;
 
  private:
-  DiskManager *disk_manager_ __attribute__((__unused__));
-  BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
+  /**
+   * Serialized log records for one redo worker, with the page each one is replayed against. A NEWPAGE record goes
+   * both to the new page and to the previous page, which it links to the new one.
+   */
+  struct RedoBatch {
+    std::vector<char> records_;
+    std::vector<page_id_t> page_ids_;
+  };
+
+  /** Replay a record against the page if the page LSN shows it is not reflected there yet. */
+  void RedoRecord(page_id_t page_id, LogRecord *log_record);
+
+  /**
+   * Redo or undo a DELTAUPDATE record: splice its after (redo) or before (undo) image of the changed bytes into the
+   * tuple as it currently is on the page.
+   * @return false if the tuple is gone or the page has no room for it to grow
+   */
+  auto ApplyDelta(TablePage *table_page, LogRecord *log_record, bool redo) -> bool;
+
+  /**
+   * Roll back the change of a tuple record to the tuple at rid, and log the CLR for it.
+   * @return false if the page has no room for the tuple as it was, or the tuple is gone, leaving the page unchanged
+   */
+  auto UndoRecord(const RID &rid, LogRecord *log_record) -> bool;
+
+  /**
+   * Read the last complete checkpoint: seed the active transaction table from it and collect its dirty page table.
+   * @param[out] dirty_pages the recovery LSN of every page that was dirty at the checkpoint
+   * @param[out] begin_lsn the LSN of the BEGIN_CHECKPOINT record
+   * @param[out] scan_offset the log file offset to start the redo scan at
+   * @return false if there is no complete checkpoint
+   */
+  auto ReadCheckpoint(std::unordered_map<page_id_t, lsn_t> *dirty_pages, lsn_t *begin_lsn,
+                      int64_t *scan_offset) -> bool;
+
+  /** Read the log record at the given log file offset. */
+  auto ReadLogRecord(int64_t offset, LogRecord *log_record) -> bool;
+
+  DiskManager *disk_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+  LogManager *log_manager_;
+  size_t num_workers_;
 
-  /** Maintain active transactions and its corresponding latest lsn. */
-  std::unordered_map<txn_id_t, lsn_t> active_txn_;
-  /** Mapping the log sequence number to log file offset for undos. */
-  std::unordered_map<lsn_t, int> lsn_mapping_;
+  /** Maintain active transactions and the log file offsets of the records they wrote, for undo. */
+  std::unordered_map<txn_id_t, std::vector<int64_t>> active_txn_;
 
-  int offset_ __attribute__((__unused__));  // NOLINT
+  /** Offset of log_buffer_ in the log. */
+  int64_t offset_;
   char *log_buffer_;
 };
 
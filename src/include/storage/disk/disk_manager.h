@@ -15,8 +15,10 @@
 #include <atomic>
 #include <fstream>
 #include <future>  // NOLINT
-#include <mutex>   // NOLINT
+#include <map>
+#include <mutex>  // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 
@@ -25,19 +27,26 @@ namespace bustub {
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * Pages are read and written with positional I/O (pread/pwrite) on a plain file descriptor, so there is no shared file
+ * cursor and no latch: any number of threads may read and write distinct pages concurrently.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param direct_io bypass the OS page cache (O_DIRECT) for page I/O, since the buffer pool already caches pages.
+   * Falls back to buffered I/O if the file system does not support it.
+   * @param log_segment_size size of the log segment files; must stay the same for the life of the database
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, bool direct_io = false,
+                       int64_t log_segment_size = LOG_SEGMENT_SIZE);
 
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
   DiskManager() = default;
 
-  virtual ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
@@ -51,6 +60,27 @@ class DiskManager {
    */
   virtual void WritePage(page_id_t page_id, const char *page_data);
 
+  /**
+   * Write a run of consecutive pages to the database file with a single vectored write (pwritev).
+   * @param first_page_id id of the first page of the run
+   * @param pages raw data of the pages first_page_id, first_page_id + 1, ...
+   */
+  virtual void WritePages(page_id_t first_page_id, const std::vector<const char *> &pages);
+
+  /**
+   * Make the page writes so far durable with one fdatasync(). Page writes are not synced individually.
+   */
+  virtual void SyncPages();
+
+  /**
+   * Reserve the disk space of a range of pages with a single fallocate(), extending the file if needed, so that the
+   * pages are laid out contiguously and writing them later does not extend the file page by page. Space that is
+   * already reserved is left alone.
+   * @param first_page_id the first page of the range
+   * @param num_pages the number of pages in the range
+   */
+  virtual void AllocateExtent(page_id_t first_page_id, size_t num_pages);
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -59,7 +89,7 @@ class DiskManager {
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
   /**
-   * Flush the entire log buffer into disk.
+   * Append the contents of a log buffer to the log, and make it durable with fdatasync().
    * @param log_data raw log data
    * @param size size of log entry
    */
@@ -69,10 +99,43 @@ class DiskManager {
    * Read a log entry from the log file.
    * @param[out] log_data output buffer
    * @param size size of the log entry
-   * @param offset offset of the log entry in the file
-   * @return true if the read was successful, false otherwise
+   * @param offset offset of the log entry in the log
+   * @return true if the read was successful, false if the offset is past the end of the log or was truncated
    */
-  auto ReadLog(char *log_data, int size, int offset) -> bool;
+  auto ReadLog(char *log_data, int size, int64_t offset) -> bool;
+
+  /** @return the offset of the oldest log byte that was not truncated */
+  auto GetLogStart() -> int64_t;
+
+  /**
+   * Set where the next WriteLog() goes. On startup the log manager finds the end of the last log record; the bytes of
+   * a recycled segment after it are stale.
+   * @param offset the end of the log
+   */
+  void SetLogEnd(int64_t offset);
+
+  /**
+   * Recycle the segments that lie entirely before offset: up to LOG_MAX_SPARE_SEGMENTS of them are kept, renamed, to
+   * become later segments without the cost of creating and allocating a file; the others are deleted.
+   * @param offset the redo point of the last complete checkpoint
+   */
+  void TruncateLog(int64_t offset);
+
+  /**
+   * Replace the master record, which points recovery at the last complete checkpoint. The record is written to a
+   * temporary file that is then renamed over the old one, so a crash leaves either the old or the new record.
+   * @param log_offset offset in the log at or before the checkpoint's records
+   * @param checkpoint_lsn LSN of the checkpoint's last END_CHECKPOINT record
+   */
+  void WriteMasterRecord(int64_t log_offset, lsn_t checkpoint_lsn);
+
+  /**
+   * Read the master record.
+   * @param[out] log_offset offset in the log at or before the checkpoint's records
+   * @param[out] checkpoint_lsn LSN of the checkpoint's last END_CHECKPOINT record
+   * @return false if no checkpoint was ever completed
+   */
+  auto ReadMasterRecord(int64_t *log_offset, lsn_t *checkpoint_lsn) -> bool;
 
   /** @return the number of disk flushes */
   auto GetNumFlushes() const -> int;
@@ -80,9 +143,12 @@ class DiskManager {
   /** @return true iff the in-memory content has not been flushed yet */
   auto GetFlushState() const -> bool;
 
-  /** @return the number of disk writes */
+  /** @return the number of disk writes, counting every page of a vectored write */
   auto GetNumWrites() const -> int;
 
+  /** @return true iff page I/O bypasses the OS page cache */
+  auto IsDirectIO() const -> bool { return direct_io_; }
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -94,18 +160,42 @@ class DiskManager {
 
  protected:
   auto GetFileSize(const std::string &file_name) -> int;
-  // stream to write log file
-  std::fstream log_io_;
+
+  /** @return the file name of a log segment; segment 0 keeps the name of the unsegmented log */
+  auto LogSegmentName(int64_t segment) -> std::string;
+
+  auto GetLogStartLocked() -> int64_t;
+
+  /** @return the file descriptor of a log segment, recycling a spare or creating the file if needed, or -1 */
+  auto OpenLogSegment(int64_t segment) -> int;
+
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // The log is split into segment files of log_segment_size_ bytes: segment k holds the log bytes from
+  // k * log_segment_size_ on. Segments before the redo point are renamed to spares (log_name_.spare.k) for reuse.
+  int64_t log_segment_size_{LOG_SEGMENT_SIZE};
+  // file descriptors of the segments that are not truncated, by segment number
+  std::map<int64_t, int> log_segments_;
+  std::vector<std::string> spare_segments_;
+  // where the next WriteLog() goes
+  int64_t log_end_{0};
+  // the end of the segment files, past which nothing can be read
+  int64_t log_extent_{0};
+  // protects the log segments and offsets
+  std::mutex log_latch_;
+  // file holding the master record, next to the log file
+  std::string master_name_;
+  // file descriptor of the db file, read and written with positional I/O only
+  int db_fd_{-1};
   std::string file_name_;
+  // size of the db file, maintained by WritePage so that ReadPage never has to stat the file
+  std::atomic<int64_t> db_file_size_{0};
+  // serializes the extensions of the db file
+  std::mutex extend_latch_;
+  bool direct_io_{false};
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
-  // With multiple buffer pool instances, need to protect file access
-  std::mutex db_io_latch_;
 };
 
 }  // namespace bustub
@@ -100,12 +100,10 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     }
 
     std::unique_lock<std::mutex> l(mutex_);
-    if (page_id >= static_cast<int>(data_.size()) || page_id < 0) {
-      LOG_WARN("page not exist");
-      return;
-    }
-    if (data_[page_id] == nullptr) {
-      LOG_WARN("page not exist");
+    // Like reading past the end of a database file, reading a page that was never written yields zeros.
+    if (page_id >= static_cast<int>(data_.size()) || page_id < 0 || data_[page_id] == nullptr) {
+      LOG_DEBUG("page not exist");
+      memset(page_data, 0, BUSTUB_PAGE_SIZE);
       return;
     }
     std::shared_ptr<ProtectedPage> ptr = data_[page_id];
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.h
+//
+// Identification: src/include/storage/disk/disk_scheduler.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <future>  // NOLINT
+#include <memory>
+#include <optional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/channel.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * @brief Represents a Write or Read request for the DiskManager to execute.
+ */
+struct DiskRequest {
+  /** Flag indicating whether the request is a write or a read. */
+  bool is_write_;
+
+  /**
+   *  Pointer to the start of the memory location where a page is either:
+   *   1. being read into from disk (on a read).
+   *   2. being written out to disk (on a write).
+   */
+  char *data_;
+
+  /** ID of the page being read from / written to disk. */
+  page_id_t page_id_;
+
+  /** Callback used to signal to the request issuer when the request has been completed. */
+  std::promise<bool> callback_;
+
+  /**
+   * For a write, the data of further pages to write right after the page, to page_id_ + 1, page_id_ + 2, ..., with one
+   * vectored write.
+   */
+  std::vector<const char *> run_{};
+};
+
+/**
+ * @brief The DiskScheduler schedules disk read and write operations.
+ *
+ * A request is scheduled by calling DiskScheduler::Schedule() with an appropriate DiskRequest object. The scheduler
+ * maintains a pool of background worker threads that process the scheduled requests using the disk manager. Requests
+ * are partitioned across workers by page id, so all requests for the same page are executed in the order they were
+ * scheduled, while requests for different pages proceed in parallel. A vectored write is ordered with the requests of
+ * its first page only; its issuer keeps the other pages from being read or written meanwhile.
+ */
+class DiskScheduler {
+ public:
+  /**
+   * @brief Creates a new DiskScheduler and starts its worker threads.
+   * @param disk_manager the disk manager that executes the requests
+   * @param num_workers the number of background worker threads
+   * @param page_id_stride the distance between the ids of the pages this scheduler sees, e.g. the number of instances
+   * of a parallel buffer pool, each of which only has every num_instances-th page id
+   */
+  explicit DiskScheduler(DiskManager *disk_manager, size_t num_workers = DISK_SCHEDULER_NUM_WORKERS,
+                         size_t page_id_stride = 1);
+
+  /**
+   * @brief Stops and joins all worker threads. Requests that were already scheduled are completed first.
+   */
+  ~DiskScheduler();
+
+  DISALLOW_COPY_AND_MOVE(DiskScheduler);
+
+  /**
+   * @brief Schedules a request for the DiskManager to execute.
+   *
+   * @param r The request to be scheduled.
+   */
+  void Schedule(DiskRequest r);
+
+  /**
+   * @brief Create a Promise object. If you want to implement your own version of promise, you can change this function
+   * so that our test cases can use your promise implementation.
+   *
+   * @return std::promise<bool>
+   */
+  using DiskSchedulerPromise = std::promise<bool>;
+  auto CreatePromise() -> DiskSchedulerPromise { return {}; };
+
+  /** @return the number of background worker threads */
+  auto GetNumWorkers() const -> size_t { return workers_.size(); }
+
+ private:
+  /**
+   * @brief Background worker loop. Processes requests from its queue until it receives std::nullopt.
+   */
+  void StartWorkerThread(size_t worker_id);
+
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_;
+  /** One shared queue per worker; a request goes to the queue picked by its page id. */
+  std::vector<std::unique_ptr<Channel<std::optional<DiskRequest>>>> request_queues_;
+  /** Page ids are divided by this before picking a queue, so that page ids of one residue spread over all queues. */
+  size_t page_id_stride_;
+  /** The background threads responsible for issuing scheduled requests to the disk manager. */
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <deque>
 #include <iostream>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <queue>
 #include <shared_mutex>
@@ -65,9 +66,14 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
+  /**
+   * @param optimistic whether inserts and removes first try to latch only the leaf for writing, descending with read
+   * latches, and only latch the path from the root down for writing if the leaf turns out to split or merge; and
+   * whether lookups first try to go down without latching at all, validating the page versions instead
+   */
   explicit BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
                      const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
-                     int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int internal_max_size = INTERNAL_PAGE_SIZE, bool optimistic = true);
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
@@ -81,6 +87,19 @@ class BPlusTree {
   // Return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
 
+  /**
+   * @brief Build an empty tree bottom-up from key/value pairs sorted by key, instead of inserting them one by one.
+   *
+   * The leaves are filled left to right and the internal levels above them the same way, each page up to the fill
+   * factor and written once, in the order of its page id. Of several pairs with the same key, the first is kept.
+   *
+   * @param entries the pairs to load, sorted by key
+   * @param fill_factor the share of a page's max size to fill, leaving room for later inserts
+   * @return false if the tree is not empty, or if the buffer pool ran out of frames for its pages, which leaves the
+   * tree empty
+   */
+  auto BulkLoad(const std::vector<MappingType> &entries, double fill_factor = INDEX_BULK_LOAD_FILL_FACTOR) -> bool;
+
   // Return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
@@ -117,6 +136,65 @@ class BPlusTree {
   void RemoveFromFile(const std::string &file_name, Transaction *txn = nullptr);
 
  private:
+  /** Descend to the leaf that key belongs to, or the leftmost leaf if key is nullptr, with read latch crabbing. */
+  auto FindLeafRead(const KeyType *key) -> std::optional<ReadPageGuard>;
+
+  /**
+   * Look key up without latching any page: every page is read between Page::TryReadVersion() and
+   * Page::ValidateVersion(), and nothing read is used before it is validated. Returns std::nullopt if a writer got in
+   * the way or the buffer pool had no frame left, with result unchanged.
+   */
+  auto TryGetValueOptimistic(const KeyType &key, std::vector<ValueType> *result) -> std::optional<bool>;
+
+  /**
+   * Descend to the leaf that key belongs to with read latch crabbing like FindLeafRead(), but latch the leaf for
+   * writing. Nobody can split or merge the leaf under this latch, so it can take a key or lose one as long as it does
+   * not fill up or fall below its min size.
+   */
+  auto FindLeafWrite(const KeyType &key) -> std::optional<WritePageGuard>;
+
+  /**
+   * Latch a page of the tree for writing, or return std::nullopt if the buffer pool has no frame left to bring it in,
+   * e.g. because other operations on the tree pinned them all while they wait for latches this one holds.
+   */
+  auto TryFetchWrite(page_id_t page_id) -> std::optional<WritePageGuard>;
+
+  /** Pin a page of the tree, waiting for a frame to come free if the buffer pool has none left. */
+  auto PinPage(page_id_t page_id) -> Page *;
+
+  /** Latch a page of the tree, waiting for a frame to come free if the buffer pool has none left. */
+  auto FetchRead(page_id_t page_id) -> ReadPageGuard;
+  auto FetchWrite(page_id_t page_id) -> WritePageGuard;
+
+  /** Create num_pages pages for the tree in new_pages, or none at all if the buffer pool has no frame left for them. */
+  auto NewTreePages(size_t num_pages, std::vector<BasicPageGuard> *new_pages) -> bool;
+
+  /**
+   * Give pages the tree no longer links to back to the buffer pool, with those an earlier call could not: a page that
+   * somebody still has pinned, e.g. a lookup that got to it before it was unlinked, is tried again later.
+   */
+  void FreeTreePages(const std::vector<page_id_t> &page_ids);
+
+  /**
+   * Insert like Insert(), or return std::nullopt without having changed the tree if the buffer pool ran out of frames.
+   */
+  auto TryInsert(const KeyType &key, const ValueType &value) -> std::optional<bool>;
+
+  /**
+   * Link the new right half of a split page into the parent, splitting the parent and up as they fill. The split page
+   * is the last one in ctx.write_set_, under its latched ancestors. Pages split further come from new_pages.
+   */
+  void InsertIntoParent(Context &ctx, KeyType key, page_id_t right_page_id, std::vector<BasicPageGuard> *new_pages);
+
+  /** Remove like Remove(), or return false without having changed the tree if the buffer pool ran out of frames. */
+  auto TryRemove(const KeyType &key) -> bool;
+
+  /**
+   * Merge or redistribute the last page in ctx.write_set_ with a sibling if it fell below its min size, and go on with
+   * the parent as long as merges leave it below its own.
+   */
+  void HandleUnderflow(Context &ctx);
+
   /* Debug Routines for FREE!! */
   void ToGraph(page_id_t page_id, const BPlusTreePage *page, std::ofstream &out);
 
@@ -138,6 +216,10 @@ class BPlusTree {
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+  bool optimistic_;
+  /** The pages FreeTreePages() could not give back yet. */
+  std::vector<page_id_t> pages_to_free_;
+  std::mutex free_latch_;
 };
 
 /**
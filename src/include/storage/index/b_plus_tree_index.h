@@ -14,6 +14,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
@@ -35,6 +36,14 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /**
+   * Fill the empty index with keys and their RIDs in one bottom-up pass, see BPlusTree::BulkLoad().
+   * @param entries the keys and RIDs in any order, sorted in place; of equal keys the first one is kept, and keys with
+   * a NULL column are dropped
+   * @return false if the index is not empty, or if the buffer pool ran out of frames for its pages
+   */
+  auto BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries) -> bool;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
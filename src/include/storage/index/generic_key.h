@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cstring>
+#include <vector>
 
 #include "storage/table/tuple.h"
 #include "type/value.h"
@@ -72,35 +73,136 @@ class GenericKey {
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * Columns of a fixed-size type are compared straight from the bytes of the keys, at offsets and with types taken from
+ * the key schema once, on construction. Only VARCHAR columns are still compared as Values. Either way a NULL column is
+ * neither less nor greater than the other key's, like Value::CompareLessThan() has it.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
-    uint32_t column_count = key_schema_->GetColumnCount();
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
-
-      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
-        return -1;
+    for (const auto &column : columns_) {
+      const char *lhs_data = lhs.data_ + column.offset_;
+      const char *rhs_data = rhs.data_ + column.offset_;
+      int cmp;
+      switch (column.type_) {
+        case TypeId::BOOLEAN:
+          cmp = CompareInlined<int8_t>(lhs_data, rhs_data, BUSTUB_BOOLEAN_NULL);
+          break;
+        case TypeId::TINYINT:
+          cmp = CompareInlined<int8_t>(lhs_data, rhs_data, BUSTUB_INT8_NULL);
+          break;
+        case TypeId::SMALLINT:
+          cmp = CompareInlined<int16_t>(lhs_data, rhs_data, BUSTUB_INT16_NULL);
+          break;
+        case TypeId::INTEGER:
+          cmp = CompareInlined<int32_t>(lhs_data, rhs_data, BUSTUB_INT32_NULL);
+          break;
+        case TypeId::BIGINT:
+          cmp = CompareInlined<int64_t>(lhs_data, rhs_data, BUSTUB_INT64_NULL);
+          break;
+        case TypeId::DECIMAL:
+          cmp = CompareInlined<double>(lhs_data, rhs_data, BUSTUB_DECIMAL_NULL);
+          break;
+        case TypeId::TIMESTAMP:
+          cmp = CompareInlined<uint64_t>(lhs_data, rhs_data, BUSTUB_TIMESTAMP_NULL);
+          break;
+        default:
+          cmp = CompareValues(lhs, rhs, column.column_idx_);
+          break;
       }
-      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
-        return 1;
+      if (cmp != 0) {
+        return cmp;
       }
     }
     // equals
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, columns_{other.columns_}, integer_key_size_{other.integer_key_size_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema)
+      : key_schema_(key_schema), columns_(KeyColumns(key_schema)), integer_key_size_(IntegerKeySize(key_schema)) {}
+
+  /**
+   * @return the size of the integer the keys start with if they are a single integer column, and so compare like that
+   * integer, or 0 otherwise. NULL is the least integer of its type then, rather than equal to every key.
+   */
+  auto GetIntegerKeySize() const -> size_t { return integer_key_size_; }
 
  private:
+  /** Where a column of the key schema lies in a key, and how to compare it. */
+  struct KeyColumn {
+    uint32_t column_idx_;
+    uint32_t offset_;
+    TypeId type_;
+  };
+
+  /** Compare two values of type T, or call them equal if either is NULL. */
+  template <typename T>
+  static auto CompareInlined(const char *lhs_data, const char *rhs_data, T null) -> int {
+    T lhs_value;
+    T rhs_value;
+    memcpy(&lhs_value, lhs_data, sizeof(T));
+    memcpy(&rhs_value, rhs_data, sizeof(T));
+    if (lhs_value == null || rhs_value == null) {
+      return 0;
+    }
+    if (lhs_value < rhs_value) {
+      return -1;
+    }
+    return rhs_value < lhs_value ? 1 : 0;
+  }
+
+  auto CompareValues(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs, uint32_t column_idx) const
+      -> int {
+    Value lhs_value = (lhs.ToValue(key_schema_, column_idx));
+    Value rhs_value = (rhs.ToValue(key_schema_, column_idx));
+
+    if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
+      return 1;
+    }
+    return 0;
+  }
+
+  static auto KeyColumns(Schema *key_schema) -> std::vector<KeyColumn> {
+    std::vector<KeyColumn> columns;
+    if (key_schema == nullptr) {
+      return columns;
+    }
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      const auto &col = key_schema->GetColumn(i);
+      columns.push_back({i, col.GetOffset(), col.GetType()});
+    }
+    return columns;
+  }
+
+  static auto IntegerKeySize(Schema *key_schema) -> size_t {
+    if (key_schema == nullptr || key_schema->GetColumnCount() != 1 || key_schema->GetColumn(0).GetOffset() != 0) {
+      return 0;
+    }
+    switch (key_schema->GetColumn(0).GetType()) {
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT: {
+        size_t size = Type::GetTypeSize(key_schema->GetColumn(0).GetType());
+        return size <= KeySize ? size : 0;
+      }
+      default:
+        return 0;
+    }
+  }
+
   Schema *key_schema_;
+  std::vector<KeyColumn> columns_;
+  size_t integer_key_size_;
 };
 
 }  // namespace bustub
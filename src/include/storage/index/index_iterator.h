@@ -14,30 +14,57 @@
  */
 #pragma once
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * IndexIterator walks the leaves of a B+ tree from left to right. It holds a read latch on the leaf it is on, and
+ * latches the next leaf before it lets go of the current one.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
  public:
   // you may define your own constructor based on your member variables
   IndexIterator();
+
+  /**
+   * @param bpm the buffer pool of the tree
+   * @param guard the latched leaf to start on
+   * @param index the index in the leaf to start at; may be the size of the leaf, to start on the next one
+   */
+  IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index);
+
   ~IndexIterator();  // NOLINT
 
+  IndexIterator(IndexIterator &&that) noexcept = default;
+  auto operator=(IndexIterator &&that) noexcept -> IndexIterator & = default;
+
   auto IsEnd() -> bool;
 
   auto operator*() -> const MappingType &;
 
   auto operator++() -> IndexIterator &;
 
-  auto operator==(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator==(const IndexIterator &itr) const -> bool {
+    return page_id_ == itr.page_id_ && index_ == itr.index_;
+  }
 
-  auto operator!=(const IndexIterator &itr) const -> bool { throw std::runtime_error("unimplemented"); }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  /** Move on to the next leaf while the index is past the end of the current one. */
+  void SkipToValid();
+
+  BufferPoolManager *bpm_{nullptr};
+  ReadPageGuard guard_;
+  /** The leaf the iterator is on, or INVALID_PAGE_ID at the end. */
+  page_id_t page_id_{INVALID_PAGE_ID};
+  int index_{0};
 };
 
 }  // namespace bustub
@@ -73,6 +73,36 @@ class BPlusTreeInternalPage : public BPlusTreePage {
    */
   auto ValueAt(int index) const -> ValueType;
 
+  /**
+   * @param index the index
+   * @param value the new value
+   */
+  void SetValueAt(int index, const ValueType &value);
+
+  /**
+   * @param key the key to search for
+   * @param comparator the comparator of the tree
+   * @return the child whose subtree key belongs to
+   */
+  auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> ValueType;
+
+  /**
+   * Insert a key and child at index, shifting the ones from index on to the right. The page must not be full.
+   */
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+
+  /**
+   * Remove the key and child at index, shifting the ones after it to the left.
+   */
+  void RemoveAt(int index);
+
+  /**
+   * Move the keys and children from index on to the end of recipient, for a split or a merge. The key at index is
+   * moved too: the caller sets it to the separator of the two pages first for a merge, and pushes it up to the parent
+   * after a split.
+   */
+  void MoveTailTo(int index, BPlusTreeInternalPage *recipient);
+
   /**
    * @brief For test only, return a string representing all keys in
    * this internal page, formatted as "(key1,key2,key3,...)"
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.h
+//
+// Identification: src/include/storage/page/b_plus_tree_key_search.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/**
+ * Find a bound among the sorted signed integers that start every entry of an array, stride bytes apart.
+ *
+ * The range is narrowed down by binary search, then what is left is counted off in one sweep: with AVX2 vector
+ * compares if the CPU has them, checked at runtime, or one key at a time otherwise.
+ *
+ * @param entries the first entry of the array
+ * @param stride the size of an entry
+ * @param key_size the size of the integers, 1, 2, 4 or 8 bytes
+ * @param begin the first index to search
+ * @param end one past the last index to search
+ * @param key the integer to search for
+ * @param upper whether to find the first integer greater than key instead of the first not less than key
+ * @return the index of the bound in [begin, end]
+ */
+auto IntegerKeyBound(const char *entries, size_t stride, size_t key_size, int begin, int end, int64_t key, bool upper)
+    -> int;
+
+/** @return the signed integer of key_size bytes at data */
+auto ReadIntegerKey(const char *data, size_t key_size) -> int64_t;
+
+/** @return the integer of key_size bytes that stands for NULL, the least one of its type */
+auto IntegerKeyNull(size_t key_size) -> int64_t;
+
+/**
+ * Find a bound among the sorted keys of a B+ tree page, each the first of a pair of a key and a value, by binary search
+ * with the comparator of the tree.
+ *
+ * @return the index of the first key in [begin, end) that is not less than key, or greater than key if upper, or end
+ * if there is none
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto ComparatorKeyBound(const std::pair<KeyType, ValueType> *array, int begin, int end, const KeyType &key,
+                        const KeyComparator &comparator, bool upper) -> int {
+  while (begin < end) {
+    int mid = begin + (end - begin) / 2;
+    int cmp = comparator(array[mid].first, key);
+    if (cmp < 0 || (upper && cmp == 0)) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin;
+}
+
+/** KeySearch picks how the pages of a B+ tree search their keys, see ComparatorKeyBound(). */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+struct KeySearch {
+  static auto Bound(const std::pair<KeyType, ValueType> *array, int begin, int end, const KeyType &key,
+                    const KeyComparator &comparator, bool upper) -> int {
+    return ComparatorKeyBound(array, begin, end, key, comparator, upper);
+  }
+};
+
+/**
+ * Keys of a single integer column compare like the integers at their start, which are searched for directly instead
+ * of through the comparator. Composite and other keys take the comparator's way as before.
+ */
+template <size_t KeySize, typename ValueType>
+struct KeySearch<GenericKey<KeySize>, ValueType, GenericComparator<KeySize>> {
+  static auto Bound(const std::pair<GenericKey<KeySize>, ValueType> *array, int begin, int end,
+                    const GenericKey<KeySize> &key, const GenericComparator<KeySize> &comparator, bool upper) -> int {
+    size_t key_size = comparator.GetIntegerKeySize();
+    if (key_size == 0) {
+      return ComparatorKeyBound(array, begin, end, key, comparator, upper);
+    }
+    // The comparator takes NULL as equal to any key, and the tree checks what it finds with the comparator. A NULL
+    // probe, or a page whose first key is NULL, which the integers sort first, is searched the comparator's way too.
+    int64_t probe = ReadIntegerKey(key.data_, key_size);
+    int64_t null_key = IntegerKeyNull(key_size);
+    if (probe == null_key || (begin < end && ReadIntegerKey(array[begin].first.data_, key_size) == null_key)) {
+      return ComparatorKeyBound(array, begin, end, key, comparator, upper);
+    }
+    return IntegerKeyBound(reinterpret_cast<const char *>(array), sizeof(array[0]), key_size, begin, end, probe, upper);
+  }
+};
+
+}  // namespace bustub
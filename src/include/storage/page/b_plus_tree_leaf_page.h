@@ -58,6 +58,30 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
   auto KeyAt(int index) const -> KeyType;
+  auto ValueAt(int index) const -> ValueType;
+  auto ItemAt(int index) const -> const MappingType &;
+
+  /**
+   * @param key the key to search for
+   * @param comparator the comparator of the tree
+   * @return the index of the first key that is not less than key, or the size of the page if there is none
+   */
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /**
+   * Insert a key and value at index, shifting the ones from index on to the right. The page must not be full.
+   */
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+
+  /**
+   * Remove the key and value at index, shifting the ones after it to the left.
+   */
+  void RemoveAt(int index);
+
+  /**
+   * Move the keys and values from index on to the end of recipient, for a split or a merge.
+   */
+  void MoveTailTo(int index, BPlusTreeLeafPage *recipient);
 
   /**
    * @brief for test only return a string representing all keys in
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.h
+//
+// Identification: src/include/storage/page/free_space_map_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * One page of the free space map: a bitmap with one bit per page of its group, set if the page is allocated.
+ *
+ * Page format (size in byte):
+ * ----------------------------------------------
+ * | Magic (4) | LSN (4) | Bitmap (4088) |
+ * ----------------------------------------------
+ *
+ * The magic number tells an initialized map page apart from a page that was never written, which reads as zeros.
+ */
+class FreeSpaceMapPage {
+ public:
+  static constexpr uint32_t MAGIC = 0x46534D31;  // "FSM1"
+  static constexpr int NUM_WORDS = (BUSTUB_PAGE_SIZE - 2 * sizeof(uint32_t)) / sizeof(uint64_t);
+  /** The number of pages a map page keeps track of, itself included. */
+  static constexpr int NUM_BITS = NUM_WORDS * 64;
+
+  // Delete all constructor / destructor to ensure memory safety
+  FreeSpaceMapPage() = delete;
+  FreeSpaceMapPage(const FreeSpaceMapPage &other) = delete;
+
+  /** @return whether the page was initialized as a map page */
+  auto IsInitialized() const -> bool { return magic_ == MAGIC; }
+
+  /** Initialize the page with all bits clear. */
+  void Init() {
+    magic_ = MAGIC;
+    for (auto &word : bitmap_) {
+      word = 0;
+    }
+  }
+
+  auto IsSet(int bit) const -> bool { return (bitmap_[bit / 64] >> (bit % 64) & 1) != 0; }
+  void Set(int bit) { bitmap_[bit / 64] |= uint64_t{1} << (bit % 64); }
+  void Clear(int bit) { bitmap_[bit / 64] &= ~(uint64_t{1} << (bit % 64)); }
+
+  /** @return the first clear bit at or after bit, or -1 if there is none */
+  auto FindClearFrom(int bit) const -> int {
+    for (int word = bit / 64; word < NUM_WORDS; word++) {
+      uint64_t clear = ~bitmap_[word];
+      if (word == bit / 64) {
+        clear &= ~uint64_t{0} << (bit % 64);
+      }
+      if (clear != 0) {
+        return word * 64 + __builtin_ctzll(clear);
+      }
+    }
+    return -1;
+  }
+
+  /** @return the last clear bit before bit, or -1 if there is none */
+  auto FindClearBefore(int bit) const -> int {
+    for (int word = (bit - 1) / 64; bit > 0 && word >= 0; word--) {
+      uint64_t clear = ~bitmap_[word];
+      if (word == (bit - 1) / 64 && bit % 64 != 0) {
+        clear &= (uint64_t{1} << (bit % 64)) - 1;
+      }
+      if (clear != 0) {
+        return word * 64 + 63 - __builtin_clzll(clear);
+      }
+    }
+    return -1;
+  }
+
+  /** @return the first bit at or after bit that starts a run of length clear bits, or -1 if there is none */
+  auto FindClearRun(int bit, int length) const -> int {
+    int run = 0;
+    for (int i = bit; i < NUM_BITS; i++) {
+      if (i % 64 == 0 && bitmap_[i / 64] == ~uint64_t{0}) {
+        run = 0;
+        i += 63;
+        continue;
+      }
+      run = IsSet(i) ? 0 : run + 1;
+      if (run == length) {
+        return i - length + 1;
+      }
+    }
+    return -1;
+  }
+
+  /** @return the last set bit, or -1 if there is none */
+  auto FindLastSet() const -> int {
+    for (int word = NUM_WORDS - 1; word >= 0; word--) {
+      if (bitmap_[word] != 0) {
+        return word * 64 + 63 - __builtin_clzll(bitmap_[word]);
+      }
+    }
+    return -1;
+  }
+
+  /** @return the number of set bits */
+  auto CountSet() const -> int {
+    int count = 0;
+    for (auto word : bitmap_) {
+      count += __builtin_popcountll(word);
+    }
+    return count;
+  }
+
+ private:
+  uint32_t magic_;
+  lsn_t lsn_;
+  uint64_t bitmap_[NUM_WORDS];
+};
+
+static_assert(sizeof(FreeSpaceMapPage) <= BUSTUB_PAGE_SIZE);
+
+}  // namespace bustub
@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <new>
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -24,20 +27,30 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * Pages are cache-line aligned, so that pinning one frame never contends with the metadata of its neighbours.
  */
-class Page {
+class alignas(CACHE_LINE_SIZE) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManager;
 
  public:
   /** Constructor. Zeros out the page data. */
   Page() {
-    data_ = new char[BUSTUB_PAGE_SIZE];
+    // Page-aligned so that the frame can be the target of direct I/O.
+    data_ = new (std::align_val_t{BUSTUB_PAGE_SIZE}) char[BUSTUB_PAGE_SIZE];
     ResetMemory();
   }
 
+  /** Wrap a frame of memory owned by somebody else, e.g. a FrameArena. The data must be zeroed already. */
+  explicit Page(char *data) : data_(data), owns_data_(false) {}
+
   /** Default destructor. */
-  ~Page() { delete[] data_; }
+  ~Page() {
+    if (owns_data_) {
+      operator delete[](data_, std::align_val_t{BUSTUB_PAGE_SIZE});
+    }
+  }
 
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
@@ -46,29 +59,71 @@ class Page {
   inline auto GetPageId() -> page_id_t { return page_id_; }
 
   /** @return the pin count of this page */
-  inline auto GetPinCount() -> int { return pin_count_; }
+  inline auto GetPinCount() -> int { return std::max(pin_count_.load(), 0); }
 
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline auto IsDirty() -> bool { return is_dirty_; }
 
   /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.fetch_add(1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
 
+  /** Try to acquire the page read latch without blocking. @return true if it was acquired */
+  inline auto TryRLatch() -> bool { return rwlatch_.TryRLock(); }
+
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * Start an optimistic read of the pinned page: read it without the latch, then check with ValidateVersion() that no
+   * writer latched it in between before using anything read.
+   * @return false if a writer holds the latch right now
+   */
+  inline auto TryReadVersion(uint64_t *version) -> bool {
+    *version = version_.load(std::memory_order_acquire);
+    return (*version & 1) == 0;
+  }
+
+  /** @return true if the page was not write latched since TryReadVersion() returned version */
+  inline auto ValidateVersion(uint64_t version) -> bool {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
   /** @return the page LSN. */
   inline auto GetLSN() -> lsn_t { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
   /** Sets the page LSN. */
   inline void SetLSN(lsn_t lsn) { memcpy(GetData() + OFFSET_LSN, &lsn, sizeof(lsn_t)); }
 
+  /**
+   * Note that a change to the page is about to be logged. Call this before appending the log record, with the next
+   * LSN of the log: the first change since the page was last clean makes it the page's recovery LSN, so a checkpoint
+   * never misses a page whose change is logged but not applied yet.
+   */
+  inline void MarkDirty(lsn_t next_lsn) {
+    lsn_t invalid = INVALID_LSN;
+    rec_lsn_.compare_exchange_strong(invalid, next_lsn);
+  }
+
+  /**
+   * @return the recovery LSN: no change logged before it is missing from the page on disk. INVALID_LSN if the page
+   * has no logged change that is not on disk.
+   */
+  inline auto GetRecLSN() -> lsn_t { return rec_lsn_; }
+
  protected:
   static_assert(sizeof(page_id_t) == 4);
   static_assert(sizeof(lsn_t) == 4);
@@ -85,14 +140,23 @@ class Page {
   // Usually this should be stored as `char data_[BUSTUB_PAGE_SIZE]{};`. But to enable ASAN to detect page overflow,
   // we store it as a ptr.
   char *data_;
+  /** Whether data_ was allocated by this page. */
+  bool owns_data_{true};
   /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  std::atomic<page_id_t> page_id_ = INVALID_PAGE_ID;
+  /**
+   * The pin count of this page. The buffer pool manager pins resident pages without its latch, so this is -1 while
+   * the frame holds no page or is being reassigned, and may only be raised from 0 or more.
+   */
+  std::atomic<int> pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_ = false;
+  /** The LSN of the oldest logged change that may not be on disk, for the dirty page table of a checkpoint. */
+  std::atomic<lsn_t> rec_lsn_ = INVALID_LSN;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped whenever the write latch is taken and again when it is released, so it is odd while the page changes. */
+  std::atomic<uint64_t> version_ = 0;
 };
 
 }  // namespace bustub
@@ -84,6 +84,15 @@ class TablePage : public Page {
   auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager)
       -> bool;
 
+  /**
+   * Insert a tuple into the given slot, for recovery to replay an insert or roll back a delete where the log says.
+   * Nothing is logged.
+   * @param tuple tuple to insert
+   * @param rid rid of the tuple, whose slot must be empty or not exist yet
+   * @return true if the insert is successful (i.e. the slot is free and there is enough space)
+   */
+  auto InsertTupleAt(const Tuple &tuple, const RID &rid) -> bool;
+
   /**
    * Mark a tuple as deleted. This does not actually delete the tuple.
    * @param rid rid of the tuple to mark as deleted
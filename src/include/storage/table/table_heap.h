@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/extent_allocator.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
@@ -22,7 +25,8 @@ namespace bustub {
 
 /**
  * TableHeap represents a physical table on disk.
- * This is just a doubly-linked list of pages.
+ * This is just a doubly-linked list of pages. Its pages are reserved in extents, so that the list mostly runs through
+ * consecutive pages and a TableIterator reads the file sequentially.
  */
 class TableHeap {
   friend class TableIterator;
@@ -52,12 +56,17 @@ class TableHeap {
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   *
+   * A bulk insert (one with a buffer ring) appends: instead of looking for free space from the first page on, it
+   * starts at the page the last bulk insert went into, so that it does not read the whole table for every tuple.
+   *
    * @param tuple tuple to insert
    * @param[out] rid the rid of the inserted tuple
    * @param txn the transaction performing the insert
+   * @param ring the buffer ring of a bulk insert, or nullptr
    * @return true iff the insert is successful
    */
-  auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
+  auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, BufferRing *ring = nullptr) -> bool;
 
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
@@ -99,8 +108,12 @@ class TableHeap {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
 
-  /** @return the begin iterator of this table */
-  auto Begin(Transaction *txn) -> TableIterator;
+  /**
+   * @param txn the transaction performing the scan
+   * @param ring the buffer ring of a large scan, or nullptr
+   * @return the begin iterator of this table
+   */
+  auto Begin(Transaction *txn, BufferRing *ring = nullptr) -> TableIterator;
 
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
@@ -113,6 +126,10 @@ class TableHeap {
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  /** The page the last bulk insert went into; only a hint. */
+  std::atomic<page_id_t> last_page_id_{INVALID_PAGE_ID};
+  /** Creates the pages of this table, an extent at a time, so that they lie next to each other on disk. */
+  ExtentAllocator page_allocator_;
 };
 
 }  // namespace bustub
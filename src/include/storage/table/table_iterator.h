@@ -14,6 +14,8 @@
 
 #include <cassert>
 
+#include "buffer/buffer_ring.h"
+#include "common/config.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
@@ -24,15 +26,33 @@ class TableHeap;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
+ *
+ * While it moves from page to page, the iterator reads the upcoming pages ahead through
+ * BufferPoolManager::PrefetchPage(). Table pages are chained by GetNextPageId(), so the successor of a page is only
+ * known once that page is in memory; the iterator instead predicts the next pages from the distance between the last
+ * two pages of the chain (pages of a table that grows on its own are allocated at a fixed stride) and checks every
+ * prediction against the real link when it gets there. The window of pages read ahead doubles whenever the scan
+ * reaches a page that is not in memory yet, and shrinks back by one page for every full window that was. With a
+ * buffer ring, the window is kept to half of the ring so that read-ahead pages are not recycled before the scan gets to
+ * them.
  */
 class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, BufferRing *ring = nullptr);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        ring_(other.ring_),
+        read_ahead_max_(other.read_ahead_max_),
+        read_ahead_window_(other.read_ahead_window_),
+        read_ahead_pages_(other.read_ahead_pages_),
+        read_ahead_hits_(other.read_ahead_hits_),
+        read_ahead_stride_(other.read_ahead_stride_),
+        read_ahead_frontier_(other.read_ahead_frontier_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -54,13 +74,41 @@ class TableIterator {
     table_heap_ = other.table_heap_;
     *tuple_ = *other.tuple_;
     txn_ = other.txn_;
+    ring_ = other.ring_;
+    read_ahead_max_ = other.read_ahead_max_;
+    read_ahead_window_ = other.read_ahead_window_;
+    read_ahead_pages_ = other.read_ahead_pages_;
+    read_ahead_hits_ = other.read_ahead_hits_;
+    read_ahead_stride_ = other.read_ahead_stride_;
+    read_ahead_frontier_ = other.read_ahead_frontier_;
     return *this;
   }
 
  private:
+  /**
+   * Called when the scan moves from cur_page_id to next_page_id: adapt the window and read ahead the pages that are
+   * expected to follow next_page_id.
+   */
+  void ReadAhead(page_id_t cur_page_id, page_id_t next_page_id);
+
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** The buffer ring of the scan, or nullptr */
+  BufferRing *ring_;
+
+  /** The largest read-ahead window, 0 if the buffer pool is too small to read ahead at all. */
+  size_t read_ahead_max_{0};
+  /** The number of pages to keep read ahead of the scan. */
+  size_t read_ahead_window_{0};
+  /** The number of predicted pages between the current page and read_ahead_frontier_ that were read ahead. */
+  size_t read_ahead_pages_{0};
+  /** The number of consecutive pages that were in memory by the time the scan reached them. */
+  size_t read_ahead_hits_{0};
+  /** The distance between two consecutive pages of the chain, as last observed. */
+  page_id_t read_ahead_stride_{0};
+  /** The last page read ahead. */
+  page_id_t read_ahead_frontier_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
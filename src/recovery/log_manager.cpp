@@ -12,43 +12,308 @@
 
 #include "recovery/log_manager.h"
 
+#include <cstring>
+
+#include "common/macros.h"
+
 namespace bustub {
 /*
  * set enable_logging = true
  * Start a separate thread to execute flush to disk operation periodically
- * The flush can be triggered when timeout or the log buffer is full or buffer
- * pool manager wants to force flush (it only happens when the flushed page has
- * a larger LSN than persistent LSN)
+ * The flush can be triggered when timeout or the log buffer is full or a
+ * committing transaction (or the buffer pool manager) waits for an LSN that
+ * is not persistent yet
  *
  * This thread runs forever until system shutdown/StopFlushThread
  */
-void LogManager::RunFlushThread() {}
+void LogManager::RunFlushThread() {
+  std::unique_lock<std::mutex> lock(latch_);
+  if (flush_thread_ != nullptr) {
+    return;
+  }
+  enable_logging = true;
+  flush_running_ = true;
+  flush_thread_ = new std::thread([this] {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (flush_running_) {
+      cv_.wait_for(lock, log_timeout, [this] { return flush_requested_ || !flush_running_; });
+      if (TailOffset(log_tail_) > 0) {
+        FlushLogBuffer(&lock);
+      } else {
+        flush_requested_ = false;
+      }
+    }
+    // Whatever was appended before the stop request still goes to disk.
+    if (TailOffset(log_tail_) > 0) {
+      FlushLogBuffer(&lock);
+    }
+  });
+}
 
 /*
  * Stop and join the flush thread, set enable_logging = false
  */
-void LogManager::StopFlushThread() {}
+void LogManager::StopFlushThread() {
+  std::thread *flush_thread;
+  {
+    std::scoped_lock lock(latch_);
+    if (flush_thread_ == nullptr) {
+      return;
+    }
+    flush_running_ = false;
+    flush_thread = flush_thread_;
+  }
+  cv_.notify_one();
+  flush_thread->join();
+  delete flush_thread;
+  std::scoped_lock lock(latch_);
+  flush_thread_ = nullptr;
+  enable_logging = false;
+}
+
+void LogManager::FlushLogBuffer(std::unique_lock<std::mutex> *lock) {
+  BUSTUB_ASSERT(!flushing_, "only one log write may be in flight");
+  // Seal the active buffer. New reservations go to the other one, which is free since no write is in flight.
+  uint64_t tail = log_tail_.load();
+  while (!log_tail_.compare_exchange_weak(tail, MakeTail(TailLSN(tail), 1 - TailBuffer(tail), 0))) {
+  }
+  size_t buffer = TailBuffer(tail);
+  int size = TailOffset(tail);
+  lsn_t lsn = TailLSN(tail) - 1;
+  buffer_offsets_.emplace_back(TailLSN(tail), buffer_offsets_.back().second + size);
+  flush_requested_ = false;
+  flushing_ = true;
+  flushing_lsn_ = lsn;
+  // Appenders blocked on a full buffer can continue in the swapped-in one.
+  flushed_cv_.notify_all();
+
+  lock->unlock();
+  // Writers that reserved space in the sealed buffer may still be copying their records into it.
+  while (completed_bytes_[buffer].load(std::memory_order_acquire) != size) {
+    std::this_thread::yield();
+  }
+  disk_manager_->WriteLog(buffers_[buffer], size);
+  completed_bytes_[buffer].store(0, std::memory_order_relaxed);
+  lock->lock();
+
+  persistent_lsn_ = lsn;
+  flushing_ = false;
+  flushed_cv_.notify_all();
+}
+
+void LogManager::WaitForSpace(int size) {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (TailOffset(log_tail_) + size > LOG_BUFFER_SIZE) {
+    if (flushing_) {
+      flushed_cv_.wait(lock);
+    } else if (flush_thread_ != nullptr) {
+      flush_requested_ = true;
+      cv_.notify_one();
+      flushed_cv_.wait(lock);
+    } else {
+      FlushLogBuffer(&lock);
+    }
+  }
+}
+
+void LogManager::WaitUntilPersistent(lsn_t lsn) {
+  std::unique_lock<std::mutex> lock(latch_);
+  // Nothing beyond the last appended record can ever become persistent.
+  lsn = std::min<lsn_t>(lsn, GetNextLSN() - 1);
+  while (persistent_lsn_ < lsn) {
+    if (flushing_ && lsn <= flushing_lsn_) {
+      // The write in flight covers the record; do not ask for another one.
+      flushed_cv_.wait(lock);
+    } else if (flush_thread_ != nullptr) {
+      flush_requested_ = true;
+      cv_.notify_one();
+      flushed_cv_.wait(lock);
+    } else if (!flushing_) {
+      FlushLogBuffer(&lock);
+    } else {
+      flushed_cv_.wait(lock);
+    }
+  }
+}
+
+void LogManager::FindLogEnd() {
+  // Records after the last checkpoint are all there is to scan: everything before it is older.
+  int64_t offset = disk_manager_->GetLogStart();
+  int64_t checkpoint_offset;
+  lsn_t checkpoint_lsn;
+  if (disk_manager_->ReadMasterRecord(&checkpoint_offset, &checkpoint_lsn)) {
+    offset = std::max(offset, checkpoint_offset);
+  }
+  lsn_t next_lsn = INVALID_LSN;
+  char *data = buffers_[0];
+  bool end_of_log = false;
+  while (!end_of_log && disk_manager_->ReadLog(data, LOG_BUFFER_SIZE, offset)) {
+    int pos = 0;
+    while (pos + LogRecord::HEADER_SIZE <= LOG_BUFFER_SIZE) {
+      int32_t size;
+      lsn_t lsn;
+      LogRecordType type;
+      memcpy(&size, data + pos, sizeof(int32_t));
+      memcpy(&lsn, data + pos + 4, sizeof(lsn_t));
+      memcpy(&type, data + pos + 16, sizeof(LogRecordType));
+      // The log ends with zeros, or with the stale records of a recycled segment, whose LSNs do not follow.
+      if (size < LogRecord::HEADER_SIZE || size > LOG_BUFFER_SIZE || type == LogRecordType::INVALID ||
+          type > LogRecordType::CLR || (next_lsn != INVALID_LSN && lsn != next_lsn)) {
+        end_of_log = true;
+        break;
+      }
+      if (pos + size > LOG_BUFFER_SIZE) {
+        break;
+      }
+      next_lsn = lsn + 1;
+      pos += size;
+    }
+    offset += pos;
+  }
+
+  next_lsn = std::max(next_lsn, 0);
+  log_tail_ = MakeTail(next_lsn, 0, 0);
+  persistent_lsn_ = next_lsn - 1;
+  buffer_offsets_.emplace_back(next_lsn, offset);
+  disk_manager_->SetLogEnd(offset);
+}
+
+auto LogManager::GetLogOffset(lsn_t lsn) -> int64_t {
+  std::scoped_lock lock(latch_);
+  auto it = std::upper_bound(buffer_offsets_.begin(), buffer_offsets_.end(), lsn,
+                             [](lsn_t lsn, const std::pair<lsn_t, int64_t> &entry) { return lsn < entry.first; });
+  BUSTUB_ASSERT(it != buffer_offsets_.begin(), "LSN precedes this log manager");
+  return std::prev(it)->second;
+}
+
+void LogManager::WriteMasterRecord(lsn_t begin_lsn, lsn_t end_lsn) {
+  BUSTUB_ASSERT(persistent_lsn_ >= end_lsn, "checkpoint records must be persistent");
+  disk_manager_->WriteMasterRecord(GetLogOffset(begin_lsn), end_lsn);
+}
+
+void LogManager::TruncateLog(int64_t offset) {
+  {
+    std::scoped_lock lock(latch_);
+    // Keep the entry of the buffer holding the offset.
+    auto it = std::upper_bound(buffer_offsets_.begin(), buffer_offsets_.end(), offset,
+                               [](int64_t offset, const std::pair<lsn_t, int64_t> &entry) {
+                                 return offset < entry.second;
+                               });
+    if (it != buffer_offsets_.begin()) {
+      buffer_offsets_.erase(buffer_offsets_.begin(), std::prev(it));
+    }
+  }
+  disk_manager_->TruncateLog(offset);
+}
 
 /*
  * append a log record into log buffer
  * you MUST set the log record's lsn within this method
  * @return: lsn that is assigned to this log record
- *
- *
- * example below
- * // First, serialize the must have fields(20 bytes in total)
- * log_record.lsn_ = next_lsn_++;
- * memcpy(log_buffer_ + offset_, &log_record, 20);
- * int pos = offset_ + 20;
- *
- * if (log_record.log_record_type_ == LogRecordType::INSERT) {
- *    memcpy(log_buffer_ + pos, &log_record.insert_rid_, sizeof(RID));
- *    pos += sizeof(RID);
- *    // we have provided serialize function for tuple class
- *    log_record.insert_tuple_.SerializeTo(log_buffer_ + pos);
- *  }
- *
  */
-auto LogManager::AppendLogRecord(LogRecord *log_record) -> lsn_t { return INVALID_LSN; }
+auto LogManager::AppendLogRecord(LogRecord *log_record) -> lsn_t {
+  const int size = log_record->size_;
+  BUSTUB_ASSERT(size <= LOG_BUFFER_SIZE, "log record larger than the log buffer");
+
+  // Reserve the LSN and the byte range together, so that records lie in the buffer in LSN order.
+  uint64_t tail = log_tail_.load();
+  while (true) {
+    if (TailOffset(tail) + size > LOG_BUFFER_SIZE) {
+      WaitForSpace(size);
+      tail = log_tail_.load();
+      continue;
+    }
+    auto reserved = MakeTail(TailLSN(tail) + 1, TailBuffer(tail), TailOffset(tail) + size);
+    if (log_tail_.compare_exchange_weak(tail, reserved)) {
+      break;
+    }
+  }
+  size_t buffer = TailBuffer(tail);
+  char *data = buffers_[buffer] + TailOffset(tail);
+
+  // First, serialize the must have fields (20 bytes in total).
+  log_record->lsn_ = TailLSN(tail);
+  memcpy(data, log_record, LogRecord::HEADER_SIZE);
+  int pos = LogRecord::HEADER_SIZE;
+
+  // A compensation log record is the tuple record that redoes the undo, behind the LSN of the undone record.
+  LogRecordType type = log_record->log_record_type_;
+  if (type == LogRecordType::CLR) {
+    memcpy(data + pos, &log_record->undo_lsn_, sizeof(lsn_t));
+    pos += sizeof(lsn_t);
+    memcpy(data + pos, &log_record->redo_type_, sizeof(LogRecordType));
+    pos += sizeof(LogRecordType);
+    type = log_record->redo_type_;
+  }
+
+  switch (type) {
+    case LogRecordType::INSERT:
+      memcpy(data + pos, &log_record->insert_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->insert_tuple_.SerializeTo(data + pos);
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      memcpy(data + pos, &log_record->delete_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->delete_tuple_.SerializeTo(data + pos);
+      break;
+    case LogRecordType::UPDATE:
+      memcpy(data + pos, &log_record->update_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->old_tuple_.SerializeTo(data + pos);
+      pos += sizeof(int32_t) + log_record->old_tuple_.GetLength();
+      log_record->new_tuple_.SerializeTo(data + pos);
+      break;
+    case LogRecordType::DELTAUPDATE: {
+      memcpy(data + pos, &log_record->update_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      memcpy(data + pos, &log_record->delta_offset_, sizeof(uint16_t));
+      pos += sizeof(uint16_t);
+      for (const auto *delta : {&log_record->old_delta_, &log_record->new_delta_}) {
+        auto delta_size = static_cast<uint16_t>(delta->size());
+        memcpy(data + pos, &delta_size, sizeof(uint16_t));
+        pos += sizeof(uint16_t);
+        memcpy(data + pos, delta->data(), delta_size);
+        pos += delta_size;
+      }
+      break;
+    }
+    case LogRecordType::NEWPAGE:
+      memcpy(data + pos, &log_record->prev_page_id_, sizeof(page_id_t));
+      pos += sizeof(page_id_t);
+      memcpy(data + pos, &log_record->page_id_, sizeof(page_id_t));
+      break;
+    case LogRecordType::END_CHECKPOINT: {
+      memcpy(data + pos, &log_record->begin_checkpoint_lsn_, sizeof(lsn_t));
+      pos += sizeof(lsn_t);
+      memcpy(data + pos, &log_record->scan_offset_, sizeof(int64_t));
+      pos += sizeof(int64_t);
+      auto txn_count = static_cast<uint32_t>(log_record->active_txns_.size());
+      memcpy(data + pos, &txn_count, sizeof(uint32_t));
+      pos += sizeof(uint32_t);
+      for (const auto &[txn_id, begin_lsn] : log_record->active_txns_) {
+        memcpy(data + pos, &txn_id, sizeof(txn_id_t));
+        memcpy(data + pos + sizeof(txn_id_t), &begin_lsn, sizeof(lsn_t));
+        pos += sizeof(txn_id_t) + sizeof(lsn_t);
+      }
+      auto page_count = static_cast<uint32_t>(log_record->dirty_pages_.size());
+      memcpy(data + pos, &page_count, sizeof(uint32_t));
+      pos += sizeof(uint32_t);
+      for (const auto &[page_id, rec_lsn] : log_record->dirty_pages_) {
+        memcpy(data + pos, &page_id, sizeof(page_id_t));
+        memcpy(data + pos + sizeof(page_id_t), &rec_lsn, sizeof(lsn_t));
+        pos += sizeof(page_id_t) + sizeof(lsn_t);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  // Publish the record; the flush thread writes a sealed buffer only once all of its bytes are complete.
+  completed_bytes_[buffer].fetch_add(size, std::memory_order_release);
+  return log_record->lsn_;
+}
 
 }  // namespace bustub
@@ -12,6 +12,14 @@
 
 #include "recovery/log_recovery.h"
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <utility>
+
 #include "storage/page/table_page.h"
 
 namespace bustub {
@@ -20,21 +28,518 @@ namespace bustub {
  * @return: true means deserialize succeed, otherwise can't deserialize cause
  * incomplete log record
  */
-auto LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record) -> bool { return false; }
+auto LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record) -> bool {
+  int32_t size;
+  memcpy(&size, data, sizeof(int32_t));
+  // The log file is zero-filled past its end.
+  if (size < LogRecord::HEADER_SIZE || size > LOG_BUFFER_SIZE) {
+    return false;
+  }
+  log_record->size_ = size;
+  memcpy(&log_record->lsn_, data + 4, sizeof(lsn_t));
+  memcpy(&log_record->txn_id_, data + 8, sizeof(txn_id_t));
+  memcpy(&log_record->prev_lsn_, data + 12, sizeof(lsn_t));
+  memcpy(&log_record->log_record_type_, data + 16, sizeof(LogRecordType));
+  int pos = LogRecord::HEADER_SIZE;
+
+  LogRecordType type = log_record->log_record_type_;
+  if (type == LogRecordType::CLR) {
+    memcpy(&log_record->undo_lsn_, data + pos, sizeof(lsn_t));
+    pos += sizeof(lsn_t);
+    memcpy(&log_record->redo_type_, data + pos, sizeof(LogRecordType));
+    pos += sizeof(LogRecordType);
+    type = log_record->redo_type_;
+  }
+
+  switch (type) {
+    case LogRecordType::INSERT:
+      memcpy(&log_record->insert_rid_, data + pos, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->insert_tuple_.DeserializeFrom(data + pos);
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      memcpy(&log_record->delete_rid_, data + pos, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->delete_tuple_.DeserializeFrom(data + pos);
+      break;
+    case LogRecordType::UPDATE:
+      memcpy(&log_record->update_rid_, data + pos, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->old_tuple_.DeserializeFrom(data + pos);
+      pos += sizeof(int32_t) + log_record->old_tuple_.GetLength();
+      log_record->new_tuple_.DeserializeFrom(data + pos);
+      break;
+    case LogRecordType::DELTAUPDATE:
+      memcpy(&log_record->update_rid_, data + pos, sizeof(RID));
+      pos += sizeof(RID);
+      memcpy(&log_record->delta_offset_, data + pos, sizeof(uint16_t));
+      pos += sizeof(uint16_t);
+      for (auto *delta : {&log_record->old_delta_, &log_record->new_delta_}) {
+        uint16_t delta_size;
+        memcpy(&delta_size, data + pos, sizeof(uint16_t));
+        pos += sizeof(uint16_t);
+        delta->assign(data + pos, data + pos + delta_size);
+        pos += delta_size;
+      }
+      break;
+    case LogRecordType::NEWPAGE:
+      memcpy(&log_record->prev_page_id_, data + pos, sizeof(page_id_t));
+      pos += sizeof(page_id_t);
+      memcpy(&log_record->page_id_, data + pos, sizeof(page_id_t));
+      break;
+    case LogRecordType::END_CHECKPOINT: {
+      memcpy(&log_record->begin_checkpoint_lsn_, data + pos, sizeof(lsn_t));
+      pos += sizeof(lsn_t);
+      memcpy(&log_record->scan_offset_, data + pos, sizeof(int64_t));
+      pos += sizeof(int64_t);
+      uint32_t txn_count;
+      memcpy(&txn_count, data + pos, sizeof(uint32_t));
+      pos += sizeof(uint32_t);
+      log_record->active_txns_.resize(txn_count);
+      for (auto &[txn_id, begin_lsn] : log_record->active_txns_) {
+        memcpy(&txn_id, data + pos, sizeof(txn_id_t));
+        memcpy(&begin_lsn, data + pos + sizeof(txn_id_t), sizeof(lsn_t));
+        pos += sizeof(txn_id_t) + sizeof(lsn_t);
+      }
+      uint32_t page_count;
+      memcpy(&page_count, data + pos, sizeof(uint32_t));
+      pos += sizeof(uint32_t);
+      log_record->dirty_pages_.resize(page_count);
+      for (auto &[page_id, rec_lsn] : log_record->dirty_pages_) {
+        memcpy(&page_id, data + pos, sizeof(page_id_t));
+        memcpy(&rec_lsn, data + pos + sizeof(page_id_t), sizeof(lsn_t));
+        pos += sizeof(page_id_t) + sizeof(lsn_t);
+      }
+      break;
+    }
+    case LogRecordType::BEGIN:
+    case LogRecordType::COMMIT:
+    case LogRecordType::ABORT:
+    case LogRecordType::BEGIN_CHECKPOINT:
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+void LogRecovery::RedoRecord(page_id_t page_id, LogRecord *log_record) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  BUSTUB_ASSERT(page != nullptr, "every recovery worker pins one page at a time");
+  auto *table_page = reinterpret_cast<TablePage *>(page);
+  bool is_dirty = false;
+  // Skip the records whose changes made it to disk before the crash.
+  if (table_page->GetLSN() < log_record->lsn_) {
+    // A CLR is replayed like the tuple record of the inverse operation that it holds.
+    LogRecordType type = log_record->log_record_type_;
+    if (type == LogRecordType::CLR) {
+      type = log_record->redo_type_;
+    }
+    switch (type) {
+      case LogRecordType::INSERT:
+        table_page->InsertTupleAt(log_record->insert_tuple_, log_record->insert_rid_);
+        break;
+      case LogRecordType::MARKDELETE:
+        table_page->MarkDelete(log_record->delete_rid_, nullptr, nullptr, nullptr);
+        break;
+      case LogRecordType::APPLYDELETE:
+        table_page->ApplyDelete(log_record->delete_rid_, nullptr, nullptr);
+        break;
+      case LogRecordType::ROLLBACKDELETE:
+        table_page->RollbackDelete(log_record->delete_rid_, nullptr, nullptr);
+        break;
+      case LogRecordType::UPDATE: {
+        Tuple old_tuple;
+        table_page->UpdateTuple(log_record->new_tuple_, &old_tuple, log_record->update_rid_, nullptr, nullptr,
+                                nullptr);
+        break;
+      }
+      case LogRecordType::DELTAUPDATE:
+        ApplyDelta(table_page, log_record, true);
+        break;
+      case LogRecordType::NEWPAGE:
+        if (page_id == log_record->page_id_) {
+          table_page->Init(page_id, BUSTUB_PAGE_SIZE, log_record->prev_page_id_, nullptr, nullptr);
+        } else {
+          table_page->SetNextPageId(log_record->page_id_);
+        }
+        break;
+      default:
+        break;
+    }
+    table_page->SetLSN(log_record->lsn_);
+    // Until the page is written back, a checkpoint must keep the log from this record on.
+    page->MarkDirty(log_record->lsn_);
+    is_dirty = true;
+  }
+  buffer_pool_manager_->UnpinPage(page_id, is_dirty);
+}
+
+auto LogRecovery::ReadCheckpoint(std::unordered_map<page_id_t, lsn_t> *dirty_pages, lsn_t *begin_lsn,
+                                 int64_t *scan_offset) -> bool {
+  int64_t offset;
+  lsn_t end_lsn;
+  if (!disk_manager_->ReadMasterRecord(&offset, &end_lsn)) {
+    return false;
+  }
+  // The master record points at or before the BEGIN_CHECKPOINT record; the END_CHECKPOINT records follow it.
+  std::vector<LogRecord> parts;
+  LogRecord log_record;
+  while (ReadLogRecord(offset, &log_record)) {
+    offset += log_record.size_;
+    if (log_record.log_record_type_ == LogRecordType::END_CHECKPOINT) {
+      parts.push_back(std::move(log_record));
+      if (parts.back().lsn_ == end_lsn) {
+        break;
+      }
+    }
+    log_record = LogRecord();
+  }
+  if (parts.empty() || parts.back().lsn_ != end_lsn) {
+    return false;
+  }
+
+  *begin_lsn = parts.back().begin_checkpoint_lsn_;
+  *scan_offset = parts.back().scan_offset_;
+  for (auto &part : parts) {
+    if (part.begin_checkpoint_lsn_ != *begin_lsn) {
+      continue;
+    }
+    for (const auto &[txn_id, lsn] : part.active_txns_) {
+      active_txn_[txn_id];
+    }
+    dirty_pages->insert(part.dirty_pages_.begin(), part.dirty_pages_.end());
+  }
+  return true;
+}
 
 /*
- *redo phase on TABLE PAGE level(table/table_page.h)
- *read log file from the beginning to end (you must prefetch log records into
- *log buffer to reduce unnecessary I/O operations), remember to compare page's
- *LSN with log_record's sequence number, and also build active_txn_ table &
- *lsn_mapping_ table
+ * redo phase on TABLE PAGE level(table/table_page.h)
+ * read log file from the last checkpoint's scan offset (or the beginning) to
+ * end, a log buffer at a time, hand every record that may be missing from its
+ * page to the worker owning the page (which compares the page's LSN with the
+ * record's), and build the active_txn_ table for undo
  */
-void LogRecovery::Redo() {}
+void LogRecovery::Redo() {
+  BUSTUB_ASSERT(!enable_logging, "recovery must run before logging is enabled");
+  std::vector<Channel<std::optional<RedoBatch>>> queues(num_workers_);
+  std::vector<std::thread> workers;
+  workers.reserve(num_workers_);
+  for (size_t i = 0; i < num_workers_; i++) {
+    workers.emplace_back([this, queue = &queues[i]] {
+      std::optional<RedoBatch> batch;
+      while ((batch = queue->Get()).has_value()) {
+        const char *data = batch->records_.data();
+        for (page_id_t page_id : batch->page_ids_) {
+          LogRecord log_record;
+          DeserializeLogRecord(data, &log_record);
+          RedoRecord(page_id, &log_record);
+          data += log_record.size_;
+        }
+      }
+    });
+  }
+
+  std::unordered_map<page_id_t, lsn_t> dirty_pages;
+  lsn_t begin_checkpoint_lsn = INVALID_LSN;
+  offset_ = disk_manager_->GetLogStart();
+  ReadCheckpoint(&dirty_pages, &begin_checkpoint_lsn, &offset_);
+
+  std::vector<RedoBatch> batches(num_workers_);
+  auto dispatch = [&](page_id_t page_id, lsn_t lsn, const char *data, int32_t size) {
+    // A change logged before the checkpoint is on disk unless the page was dirty at the checkpoint and the change is
+    // not older than the page's recovery LSN.
+    if (lsn < begin_checkpoint_lsn) {
+      auto it = dirty_pages.find(page_id);
+      if (it == dirty_pages.end() || lsn < it->second) {
+        return;
+      }
+    }
+    size_t worker = static_cast<size_t>(page_id) % num_workers_;
+    RedoBatch &batch = batches[worker];
+    batch.records_.insert(batch.records_.end(), data, data + size);
+    batch.page_ids_.push_back(page_id);
+    if (batch.records_.size() >= static_cast<size_t>(LOG_BUFFER_SIZE)) {
+      queues[worker].Put(std::move(batch));
+      batch = RedoBatch{};
+    }
+  };
+
+  lsn_t next_lsn = INVALID_LSN;
+  bool end_of_log = false;
+  while (!end_of_log && disk_manager_->ReadLog(log_buffer_, LOG_BUFFER_SIZE, offset_)) {
+    int pos = 0;
+    // Stop at a record cut off by the end of the buffer; the next read starts with it.
+    while (pos + LogRecord::HEADER_SIZE <= LOG_BUFFER_SIZE) {
+      const char *data = log_buffer_ + pos;
+      int32_t size;
+      lsn_t lsn;
+      txn_id_t txn_id;
+      LogRecordType type;
+      memcpy(&size, data, sizeof(int32_t));
+      memcpy(&lsn, data + 4, sizeof(lsn_t));
+      memcpy(&txn_id, data + 8, sizeof(txn_id_t));
+      memcpy(&type, data + 16, sizeof(LogRecordType));
+      // The log is zero-filled past its end, or holds the stale records of a recycled segment, whose LSNs do not
+      // follow.
+      if (size < LogRecord::HEADER_SIZE || type == LogRecordType::INVALID ||
+          (next_lsn != INVALID_LSN && lsn != next_lsn)) {
+        end_of_log = true;
+        break;
+      }
+      if (pos + size > LOG_BUFFER_SIZE) {
+        break;
+      }
+
+      // Only the header is decoded here: the workers deserialize the records they replay.
+      page_id_t page_id;
+      switch (type) {
+        case LogRecordType::BEGIN:
+          active_txn_[txn_id];
+          break;
+        case LogRecordType::COMMIT:
+        case LogRecordType::ABORT:
+          active_txn_.erase(txn_id);
+          break;
+        case LogRecordType::INSERT:
+        case LogRecordType::MARKDELETE:
+        case LogRecordType::APPLYDELETE:
+        case LogRecordType::ROLLBACKDELETE:
+        case LogRecordType::UPDATE:
+        case LogRecordType::DELTAUPDATE:
+          // The RID follows the header in every tuple record.
+          memcpy(&page_id, data + LogRecord::HEADER_SIZE, sizeof(page_id_t));
+          dispatch(page_id, lsn, data, size);
+          active_txn_[txn_id].push_back(offset_ + pos);
+          break;
+        case LogRecordType::CLR:
+          // Undo needs the CLRs of a loser too, to skip the records they undid.
+          memcpy(&page_id, data + LogRecord::HEADER_SIZE + sizeof(lsn_t) + sizeof(LogRecordType), sizeof(page_id_t));
+          dispatch(page_id, lsn, data, size);
+          active_txn_[txn_id].push_back(offset_ + pos);
+          break;
+        case LogRecordType::NEWPAGE: {
+          page_id_t prev_page_id;
+          memcpy(&prev_page_id, data + LogRecord::HEADER_SIZE, sizeof(page_id_t));
+          memcpy(&page_id, data + LogRecord::HEADER_SIZE + sizeof(page_id_t), sizeof(page_id_t));
+          dispatch(page_id, lsn, data, size);
+          if (prev_page_id != INVALID_PAGE_ID) {
+            dispatch(prev_page_id, lsn, data, size);
+          }
+          break;
+        }
+        case LogRecordType::BEGIN_CHECKPOINT:
+        case LogRecordType::END_CHECKPOINT:
+          break;
+        default:
+          end_of_log = true;
+          break;
+      }
+      if (end_of_log) {
+        break;
+      }
+      next_lsn = lsn + 1;
+      pos += size;
+    }
+    BUSTUB_ASSERT(end_of_log || pos > 0, "log record larger than the log buffer");
+    offset_ += pos;
+  }
+
+  for (size_t i = 0; i < num_workers_; i++) {
+    if (!batches[i].page_ids_.empty()) {
+      queues[i].Put(std::move(batches[i]));
+    }
+    queues[i].Put(std::nullopt);
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+auto LogRecovery::ApplyDelta(TablePage *table_page, LogRecord *log_record, bool redo) -> bool {
+  const RID &rid = log_record->update_rid_;
+  Tuple current;
+  if (!table_page->GetTuple(rid, &current, nullptr, nullptr)) {
+    return false;
+  }
+  const auto &from = redo ? log_record->old_delta_ : log_record->new_delta_;
+  const auto &to = redo ? log_record->new_delta_ : log_record->old_delta_;
+  uint32_t offset = log_record->delta_offset_;
+  BUSTUB_ASSERT(offset + from.size() <= current.GetLength(), "delta does not fit the tuple it was logged for");
+
+  // Build the serialized tuple, | size | prefix | delta | suffix |, and update the page with it.
+  auto size = static_cast<int32_t>(current.GetLength() - from.size() + to.size());
+  std::vector<char> image(sizeof(int32_t) + size);
+  memcpy(image.data(), &size, sizeof(int32_t));
+  char *dst = image.data() + sizeof(int32_t);
+  dst = std::copy(current.GetData(), current.GetData() + offset, dst);
+  dst = std::copy(to.begin(), to.end(), dst);
+  std::copy(current.GetData() + offset + from.size(), current.GetData() + current.GetLength(), dst);
+  Tuple tuple;
+  tuple.DeserializeFrom(image.data());
+  Tuple replaced;
+  return table_page->UpdateTuple(tuple, &replaced, rid, nullptr, nullptr, nullptr);
+}
+
+auto LogRecovery::ReadLogRecord(int64_t offset, LogRecord *log_record) -> bool {
+  int32_t size;
+  if (!disk_manager_->ReadLog(reinterpret_cast<char *>(&size), sizeof(int32_t), offset) ||
+      size < LogRecord::HEADER_SIZE || size > LOG_BUFFER_SIZE) {
+    return false;
+  }
+  std::vector<char> data(size);
+  return disk_manager_->ReadLog(data.data(), size, offset) && DeserializeLogRecord(data.data(), log_record);
+}
+
+/** Find the tuple that a tuple record or CLR changed, or return false for the records that change no tuple. */
+static auto GetUndoRID(LogRecord *log_record, RID *rid) -> bool {
+  LogRecordType type = log_record->GetLogRecordType();
+  if (type == LogRecordType::CLR) {
+    type = log_record->GetRedoType();
+  }
+  switch (type) {
+    case LogRecordType::INSERT:
+      *rid = log_record->GetInsertRID();
+      return true;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      *rid = log_record->GetDeleteRID();
+      return true;
+    case LogRecordType::UPDATE:
+    case LogRecordType::DELTAUPDATE:
+      *rid = log_record->GetUpdateRID();
+      return true;
+    default:
+      return false;
+  }
+}
+
+auto LogRecovery::UndoRecord(const RID &rid, LogRecord *log_record) -> bool {
+  Page *page = buffer_pool_manager_->FetchPage(rid.GetPageId());
+  BUSTUB_ASSERT(page != nullptr, "every recovery worker pins one page at a time");
+  auto *table_page = reinterpret_cast<TablePage *>(page);
+  // Keep the page cleaner from writing the page between the undo and the page LSN of its CLR.
+  table_page->WLatch();
+  bool undone = true;
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT:
+      table_page->ApplyDelete(rid, nullptr, nullptr);
+      break;
+    case LogRecordType::MARKDELETE:
+      table_page->RollbackDelete(rid, nullptr, nullptr);
+      break;
+    case LogRecordType::ROLLBACKDELETE:
+      undone = table_page->MarkDelete(rid, nullptr, nullptr, nullptr);
+      break;
+    case LogRecordType::APPLYDELETE:
+      undone = table_page->InsertTupleAt(log_record->delete_tuple_, rid);
+      break;
+    case LogRecordType::UPDATE: {
+      Tuple new_tuple;
+      undone = table_page->UpdateTuple(log_record->old_tuple_, &new_tuple, rid, nullptr, nullptr, nullptr);
+      break;
+    }
+    case LogRecordType::DELTAUPDATE:
+      undone = ApplyDelta(table_page, log_record, false);
+      break;
+    default:
+      break;
+  }
+  if (undone) {
+    // WAL: the buffer pool writes the page back only once the CLR is persistent.
+    page->MarkDirty(log_manager_->GetNextLSN());
+    LogRecord clr(LogRecordType::CLR, *log_record);
+    table_page->SetLSN(log_manager_->AppendLogRecord(&clr));
+  }
+  table_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), undone);
+  return undone;
+}
 
 /*
- *undo phase on TABLE PAGE level(table/table_page.h)
- *iterate through active txn map and undo each operation
+ * undo phase on TABLE PAGE level(table/table_page.h)
+ * read the records of all losers newest first and hand each to the worker
+ * owning its page, so the changes to one page are undone in reverse LSN order
+ * while different pages are undone in parallel. a CLR from an earlier run of
+ * recovery means its record is undone already. once a change of a page cannot
+ * be undone, the older ones of the page wait too, and all of them are retried
+ * after the other pages. finally every loser gets an ABORT record, which must
+ * be persistent before the pages are flushed, so the next recovery does not
+ * see the losers again
  */
-void LogRecovery::Undo() {}
+void LogRecovery::Undo() {
+  std::vector<int64_t> offsets;
+  for (const auto &[txn_id, txn_offsets] : active_txn_) {
+    offsets.insert(offsets.end(), txn_offsets.begin(), txn_offsets.end());
+  }
+  // Log file offsets grow with the LSNs.
+  std::sort(offsets.begin(), offsets.end(), std::greater<>());
+
+  std::vector<Channel<std::optional<std::pair<RID, LogRecord>>>> queues(num_workers_);
+  std::vector<std::pair<RID, LogRecord>> deferred;
+  std::mutex deferred_latch;
+  std::vector<std::thread> workers;
+  workers.reserve(num_workers_);
+  for (size_t i = 0; i < num_workers_; i++) {
+    workers.emplace_back([&, queue = &queues[i]] {
+      // A CLR and the record it undid change the same page, and the CLR comes first in reverse LSN order.
+      std::unordered_set<lsn_t> compensated;
+      std::unordered_set<page_id_t> blocked;
+      std::optional<std::pair<RID, LogRecord>> record;
+      while ((record = queue->Get()).has_value()) {
+        auto &[rid, log_record] = *record;
+        if (log_record.log_record_type_ == LogRecordType::CLR) {
+          compensated.insert(log_record.undo_lsn_);
+          continue;
+        }
+        if (compensated.count(log_record.lsn_) > 0) {
+          continue;
+        }
+        if (blocked.count(rid.GetPageId()) > 0 || !UndoRecord(rid, &log_record)) {
+          blocked.insert(rid.GetPageId());
+          std::scoped_lock lock(deferred_latch);
+          deferred.push_back(std::move(*record));
+        }
+      }
+    });
+  }
+
+  std::unordered_map<txn_id_t, lsn_t> last_lsns;
+  for (int64_t offset : offsets) {
+    LogRecord log_record;
+    RID rid;
+    if (!ReadLogRecord(offset, &log_record) || !GetUndoRID(&log_record, &rid)) {
+      continue;
+    }
+    last_lsns.emplace(log_record.txn_id_, log_record.lsn_);
+    queues[static_cast<size_t>(rid.GetPageId()) % num_workers_].Put(std::make_pair(rid, std::move(log_record)));
+  }
+  for (auto &queue : queues) {
+    queue.Put(std::nullopt);
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  // The records of a page keep their order across workers, which differ in their pages only.
+  std::stable_sort(deferred.begin(), deferred.end(),
+                   [](const auto &left, const auto &right) { return left.second.lsn_ > right.second.lsn_; });
+  for (auto &[rid, log_record] : deferred) {
+    BUSTUB_ENSURE(UndoRecord(rid, &log_record), "cannot undo a change of an unfinished transaction");
+  }
+
+  lsn_t abort_lsn = INVALID_LSN;
+  for (const auto &[txn_id, txn_offsets] : active_txn_) {
+    auto it = last_lsns.find(txn_id);
+    LogRecord abort_record(txn_id, it == last_lsns.end() ? INVALID_LSN : it->second, LogRecordType::ABORT);
+    abort_lsn = log_manager_->AppendLogRecord(&abort_record);
+  }
+  log_manager_->WaitUntilPersistent(abort_lsn);
+  active_txn_.clear();
+  buffer_pool_manager_->FlushAllPages();
+}
 
 }  // namespace bustub
@@ -10,8 +10,18 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <dirent.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <mutex>  // NOLINT
@@ -26,99 +36,319 @@ namespace bustub {
 
 static char *buffer_used;
 
+/** Alignment of the buffers, offsets and lengths used for direct I/O. */
+static constexpr size_t DIRECT_IO_ALIGNMENT = BUSTUB_PAGE_SIZE;
+
+/**
+ * Per-thread bounce buffer for direct I/O on page buffers that are not suitably aligned.
+ */
+static auto DirectIOBuffer() -> char * {
+  struct AlignedBuffer {
+    AlignedBuffer() : data_(static_cast<char *>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, BUSTUB_PAGE_SIZE))) {}
+    ~AlignedBuffer() { std::free(data_); }  // NOLINT
+    char *data_;
+  };
+  thread_local AlignedBuffer buffer;
+  return buffer.data_;
+}
+
+/** Identifies a master record file. */
+static constexpr uint32_t MASTER_RECORD_MAGIC = 0x74706b63;
+
+static auto IsAligned(const char *data) -> bool {
+  return reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT == 0;
+}
+
 /**
- * Constructor: open/create a single database file & log file
+ * Constructor: open/create a single database file & the log segment files
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io, int64_t log_segment_size)
+    : log_segment_size_(log_segment_size), file_name_(db_file) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
     return;
   }
   log_name_ = file_name_.substr(0, n) + ".log";
+  master_name_ = file_name_.substr(0, n) + ".ckpt";
 
-  log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
-  // directory or file does not exist
-  if (!log_io_.is_open()) {
-    log_io_.clear();
-    // create a new file
-    log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!log_io_.is_open()) {
+  // Find the log segments and the spares next to the log.
+  std::string::size_type slash = log_name_.rfind('/');
+  std::string dir_name = slash == std::string::npos ? "." : log_name_.substr(0, slash + 1);
+  std::string base_name = slash == std::string::npos ? log_name_ : log_name_.substr(slash + 1);
+  DIR *dir = opendir(dir_name.c_str());
+  if (dir == nullptr) {
+    throw Exception("can't open dblog file");
+  }
+  const std::string spare_prefix = base_name + ".spare.";
+  while (dirent *entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    std::string path = slash == std::string::npos ? name : dir_name + name;
+    if (name == base_name) {
+      log_segments_.emplace(0, -1);
+    } else if (name.compare(0, spare_prefix.size(), spare_prefix) == 0) {
+      spare_segments_.push_back(path);
+    } else if (name.size() > base_name.size() + 1 && name.compare(0, base_name.size() + 1, base_name + ".") == 0 &&
+               std::all_of(name.begin() + base_name.size() + 1, name.end(),
+                           [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; })) {
+      log_segments_.emplace(std::stoll(name.substr(base_name.size() + 1)), -1);
+    }
+  }
+  closedir(dir);
+  if (log_segments_.empty()) {
+    log_segments_.emplace(0, -1);
+  }
+  for (auto &[segment, fd] : log_segments_) {
+    fd = open(LogSegmentName(segment).c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
       throw Exception("can't open dblog file");
     }
   }
+  // Until the log manager finds the end of the last record, writes go after everything in the files.
+  auto last = log_segments_.rbegin();
+  log_extent_ = last->first * log_segment_size_ + std::max(GetFileSize(LogSegmentName(last->first)), 0);
+  log_end_ = log_extent_;
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+  // create the file if it does not exist
+  int flags = O_RDWR | O_CREAT;
+#ifdef O_DIRECT
+  if (direct_io) {
+    db_fd_ = open(db_file.c_str(), flags | O_DIRECT, 0644);
+    if (db_fd_ >= 0) {
+      direct_io_ = true;
+    } else {
+      LOG_WARN("O_DIRECT is not supported for %s, falling back to buffered I/O", db_file.c_str());
     }
   }
+#endif
+  if (db_fd_ < 0) {
+    db_fd_ = open(db_file.c_str(), flags, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+#if !defined(O_DIRECT) && defined(F_NOCACHE)
+  if (direct_io && fcntl(db_fd_, F_NOCACHE, 1) == 0) {
+    direct_io_ = true;
+  }
+#endif
+
+  struct stat stat_buf;
+  db_file_size_ = fstat(db_fd_, &stat_buf) == 0 ? static_cast<int64_t>(stat_buf.st_size) : 0;
   buffer_used = nullptr;
 }
 
+DiskManager::~DiskManager() {
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
+  for (auto &[segment, fd] : log_segments_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  {
-    std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+  std::scoped_lock lock(log_latch_);
+  for (auto &[segment, fd] : log_segments_) {
+    if (fd >= 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+}
+
+/**
+ * Reserve the space of num_pages pages from first_page_id on
+ */
+void DiskManager::AllocateExtent(page_id_t first_page_id, size_t num_pages) {
+  if (db_fd_ < 0) {
+    return;
+  }
+  auto offset = static_cast<off_t>(first_page_id) * BUSTUB_PAGE_SIZE;
+  auto end = offset + static_cast<off_t>(num_pages) * BUSTUB_PAGE_SIZE;
+  std::scoped_lock<std::mutex> lock(extend_latch_);
+  if (end <= db_file_size_.load()) {
+    return;
+  }
+  offset = std::max<off_t>(offset, db_file_size_.load());
+#ifdef __linux__
+  int rc = fallocate(db_fd_, 0, offset, end - offset) == 0 ? 0 : errno;
+#else
+  int rc = posix_fallocate(db_fd_, offset, end - offset);
+#endif
+  if (rc != 0) {
+    // Not supported by the file system: the file grows as pages are written instead.
+    LOG_DEBUG("cannot preallocate the db file: %s", strerror(rc));
+    return;
+  }
+  // The reserved pages read as zeros, like pages past the end of the file.
+  int64_t size = db_file_size_.load();
+  while (size < end && !db_file_size_.compare_exchange_weak(size, end)) {
   }
-  log_io_.close();
 }
 
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
-  // set write cursor to offset
+  auto offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, BUSTUB_PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG_DEBUG("I/O error while writing");
+
+  // Writing past the end of the file extends it by a whole extent rather than by the page.
+  if (offset >= db_file_size_.load()) {
+    AllocateExtent(page_id - page_id % EXTENT_SIZE, EXTENT_SIZE);
+  }
+
+  const char *buf = page_data;
+  if (direct_io_ && !IsAligned(page_data)) {
+    buf = DirectIOBuffer();
+    memcpy(const_cast<char *>(buf), page_data, BUSTUB_PAGE_SIZE);
+  }
+
+  size_t written = 0;
+  while (written < BUSTUB_PAGE_SIZE) {
+    ssize_t rc = pwrite(db_fd_, buf + written, BUSTUB_PAGE_SIZE - written, offset + written);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    // check for I/O error
+    if (rc <= 0) {
+      LOG_DEBUG("I/O error while writing");
+      return;
+    }
+    written += rc;
+  }
+
+  // remember how far the file extends so that reads never have to stat it
+  int64_t end = offset + BUSTUB_PAGE_SIZE;
+  int64_t size = db_file_size_.load();
+  while (size < end && !db_file_size_.compare_exchange_weak(size, end)) {
+  }
+}
+
+/**
+ * Write the contents of a run of consecutive pages into disk file with one vectored write
+ */
+void DiskManager::WritePages(page_id_t first_page_id, const std::vector<const char *> &pages) {
+  if (pages.empty()) {
+    return;
+  }
+  // Without a file of our own (DiskManagerMemory), or with buffers direct I/O cannot use, write page by page.
+  bool aligned = std::all_of(pages.begin(), pages.end(), [](const char *data) { return IsAligned(data); });
+  if (db_fd_ < 0 || (direct_io_ && !aligned)) {
+    for (size_t i = 0; i < pages.size(); i++) {
+      WritePage(first_page_id + static_cast<page_id_t>(i), pages[i]);
+    }
+    return;
+  }
+
+  auto offset = static_cast<off_t>(first_page_id) * BUSTUB_PAGE_SIZE;
+  int64_t end = offset + static_cast<off_t>(pages.size()) * BUSTUB_PAGE_SIZE;
+  num_writes_ += pages.size();
+
+  // Writing past the end of the file extends it by whole extents.
+  if (end > db_file_size_.load()) {
+    page_id_t first_extent = first_page_id - first_page_id % EXTENT_SIZE;
+    page_id_t end_page_id = first_page_id + static_cast<page_id_t>(pages.size());
+    page_id_t end_extent = (end_page_id + EXTENT_SIZE - 1) / EXTENT_SIZE * EXTENT_SIZE;
+    AllocateExtent(first_extent, end_extent - first_extent);
+  }
+
+  std::vector<iovec> iov(pages.size());
+  for (size_t i = 0; i < pages.size(); i++) {
+    iov[i].iov_base = const_cast<char *>(pages[i]);
+    iov[i].iov_len = BUSTUB_PAGE_SIZE;
+  }
+  size_t done = 0;
+  while (done < iov.size()) {
+    int count = static_cast<int>(std::min<size_t>(iov.size() - done, IOV_MAX));
+    ssize_t rc = pwritev(db_fd_, &iov[done], count, offset);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    // check for I/O error
+    if (rc <= 0) {
+      LOG_DEBUG("I/O error while writing");
+      return;
+    }
+    offset += rc;
+    // Skip what was written, which may end in the middle of a page.
+    while (rc > 0) {
+      auto written = std::min<size_t>(rc, iov[done].iov_len);
+      iov[done].iov_base = static_cast<char *>(iov[done].iov_base) + written;
+      iov[done].iov_len -= written;
+      rc -= written;
+      if (iov[done].iov_len == 0) {
+        done++;
+      }
+    }
+  }
+
+  int64_t size = db_file_size_.load();
+  while (size < end && !db_file_size_.compare_exchange_weak(size, end)) {
+  }
+}
+
+/**
+ * Make the page writes so far durable
+ */
+void DiskManager::SyncPages() {
+  if (db_fd_ < 0) {
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+#ifdef __linux__
+  int rc = fdatasync(db_fd_);
+#else
+  int rc = fsync(db_fd_);
+#endif
+  if (rc != 0) {
+    LOG_DEBUG("I/O error while syncing the db file: %s", strerror(errno));
+  }
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
+  auto offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
   // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
+  if (offset >= db_file_size_.load()) {
     LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, BUSTUB_PAGE_SIZE);
-    if (db_io_.bad()) {
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+
+  char *buf = direct_io_ && !IsAligned(page_data) ? DirectIOBuffer() : page_data;
+  size_t read_count = 0;
+  while (read_count < BUSTUB_PAGE_SIZE) {
+    ssize_t rc = pread(db_fd_, buf + read_count, BUSTUB_PAGE_SIZE - read_count, offset + read_count);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc < 0) {
       LOG_DEBUG("I/O error while reading");
       return;
     }
     // if file ends before reading BUSTUB_PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < BUSTUB_PAGE_SIZE) {
+    if (rc == 0) {
       LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+      memset(buf + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+      break;
     }
+    read_count += rc;
+  }
+  if (buf != page_data) {
+    memcpy(page_data, buf, BUSTUB_PAGE_SIZE);
   }
 }
 
@@ -131,7 +361,7 @@ void DiskManager::WriteLog(char *log_data, int size) {
   assert(log_data != buffer_used);
   buffer_used = log_data;
 
-  if (size == 0) {  // no effect on num_flushes_ if log buffer is empty
+  if (size == 0 || log_name_.empty()) {  // no effect on num_flushes_ if log buffer is empty
     return;
   }
 
@@ -143,44 +373,170 @@ void DiskManager::WriteLog(char *log_data, int size) {
   }
 
   num_flushes_ += 1;
-  // sequence write
-  log_io_.write(log_data, size);
-
-  // check for I/O error
-  if (log_io_.bad()) {
-    LOG_DEBUG("I/O error while writing log");
-    return;
+  std::scoped_lock lock(log_latch_);
+  // sequence write, split where it crosses into the next segment
+  for (int written = 0; written < size;) {
+    int64_t segment = log_end_ / log_segment_size_;
+    auto offset = static_cast<off_t>(log_end_ % log_segment_size_);
+    auto count = static_cast<int>(std::min<int64_t>(size - written, log_segment_size_ - offset));
+    int fd = OpenLogSegment(segment);
+    ssize_t rc = fd < 0 ? -1 : pwrite(fd, log_data + written, count, offset);
+    // check for I/O error; needs to sync to make the commits in the buffer durable
+    if (rc != count || fdatasync(fd) != 0) {
+      LOG_DEBUG("I/O error while writing log");
+      return;
+    }
+    written += count;
+    log_end_ += count;
   }
-  // needs to flush to keep disk file in sync
-  log_io_.flush();
+  log_extent_ = std::max(log_extent_, log_end_);
   flush_log_ = false;
 }
 
 /**
  * Read the contents of the log into the given memory area
- * Always read from the beginning and perform sequence read
  * @return: false means already reach the end
  */
-auto DiskManager::ReadLog(char *log_data, int size, int offset) -> bool {
-  if (offset >= GetFileSize(log_name_)) {
-    // LOG_DEBUG("end of log file");
-    // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
+auto DiskManager::ReadLog(char *log_data, int size, int64_t offset) -> bool {
+  std::scoped_lock lock(log_latch_);
+  if (log_segments_.empty() || offset >= log_extent_ || offset < GetLogStartLocked()) {
     return false;
   }
-  log_io_.seekp(offset);
-  log_io_.read(log_data, size);
+  for (int read_count = 0; read_count < size;) {
+    int64_t segment = (offset + read_count) / log_segment_size_;
+    auto segment_offset = static_cast<off_t>((offset + read_count) % log_segment_size_);
+    auto count = static_cast<int>(std::min<int64_t>(size - read_count, log_segment_size_ - segment_offset));
+    auto it = log_segments_.find(segment);
+    ssize_t rc = it == log_segments_.end() || it->second < 0 ? 0 : pread(it->second, log_data + read_count, count,
+                                                                         segment_offset);
+    if (rc < 0) {
+      LOG_DEBUG("I/O error while reading log");
+      return false;
+    }
+    // if the log ends before reading "size"
+    if (rc < count) {
+      memset(log_data + read_count + rc, 0, size - read_count - rc);
+      break;
+    }
+    read_count += count;
+  }
+  return true;
+}
 
-  if (log_io_.bad()) {
-    LOG_DEBUG("I/O error while reading log");
-    return false;
+auto DiskManager::GetLogStart() -> int64_t {
+  std::scoped_lock lock(log_latch_);
+  return GetLogStartLocked();
+}
+
+auto DiskManager::GetLogStartLocked() -> int64_t {
+  return log_segments_.empty() ? log_end_ : log_segments_.begin()->first * log_segment_size_;
+}
+
+void DiskManager::SetLogEnd(int64_t offset) {
+  std::scoped_lock lock(log_latch_);
+  log_end_ = offset;
+}
+
+void DiskManager::TruncateLog(int64_t offset) {
+  std::scoped_lock lock(log_latch_);
+  // The segment being written is never truncated.
+  int64_t end_segment = std::min(offset, log_end_) / log_segment_size_;
+  while (!log_segments_.empty() && log_segments_.begin()->first < end_segment) {
+    auto [segment, fd] = *log_segments_.begin();
+    log_segments_.erase(log_segments_.begin());
+    if (fd >= 0) {
+      close(fd);
+    }
+    std::string name = LogSegmentName(segment);
+    if (spare_segments_.size() < static_cast<size_t>(LOG_MAX_SPARE_SEGMENTS)) {
+      std::string spare_name = log_name_ + ".spare." + std::to_string(segment);
+      if (rename(name.c_str(), spare_name.c_str()) == 0) {
+        spare_segments_.push_back(spare_name);
+        continue;
+      }
+    }
+    if (remove(name.c_str()) != 0) {
+      LOG_DEBUG("cannot remove log segment %s: %s", name.c_str(), strerror(errno));
+    }
+  }
+}
+
+auto DiskManager::LogSegmentName(int64_t segment) -> std::string {
+  return segment == 0 ? log_name_ : log_name_ + "." + std::to_string(segment);
+}
+
+auto DiskManager::OpenLogSegment(int64_t segment) -> int {
+  auto it = log_segments_.find(segment);
+  if (it != log_segments_.end()) {
+    return it->second;
+  }
+  std::string name = LogSegmentName(segment);
+  int fd = -1;
+  if (!spare_segments_.empty()) {
+    // Reuse a recycled segment: its blocks are allocated already; what it still holds is overwritten in order, and
+    // recovery stops at the first record that does not continue the LSNs of the log.
+    std::string spare_name = spare_segments_.back();
+    spare_segments_.pop_back();
+    if (rename(spare_name.c_str(), name.c_str()) == 0) {
+      fd = open(name.c_str(), O_RDWR);
+    }
+  }
+  if (fd < 0) {
+    fd = open(name.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+      return -1;
+    }
+#ifdef __linux__
+    // Allocate the whole segment up front, so that syncing a write does not have to update the file size.
+    if (fallocate(fd, 0, 0, log_segment_size_) != 0) {
+      LOG_DEBUG("cannot preallocate the log segment: %s", strerror(errno));
+    }
+#endif
+  }
+  log_segments_.emplace(segment, fd);
+  log_extent_ = std::max(log_extent_, (segment + 1) * log_segment_size_);
+  return fd;
+}
+
+void DiskManager::WriteMasterRecord(int64_t log_offset, lsn_t checkpoint_lsn) {
+  if (master_name_.empty()) {
+    return;
+  }
+  const std::string tmp_name = master_name_ + ".tmp";
+  char record[sizeof(MASTER_RECORD_MAGIC) + sizeof(log_offset) + sizeof(checkpoint_lsn)];
+  memcpy(record, &MASTER_RECORD_MAGIC, sizeof(MASTER_RECORD_MAGIC));
+  memcpy(record + sizeof(MASTER_RECORD_MAGIC), &log_offset, sizeof(log_offset));
+  memcpy(record + sizeof(MASTER_RECORD_MAGIC) + sizeof(log_offset), &checkpoint_lsn, sizeof(checkpoint_lsn));
+  int fd = open(tmp_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0 || write(fd, record, sizeof(record)) != static_cast<ssize_t>(sizeof(record)) || fdatasync(fd) != 0) {
+    LOG_DEBUG("I/O error while writing the master record");
+    if (fd >= 0) {
+      close(fd);
+    }
+    return;
   }
-  // if log file ends before reading "size"
-  int read_count = log_io_.gcount();
-  if (read_count < size) {
-    log_io_.clear();
-    memset(log_data + read_count, 0, size - read_count);
+  close(fd);
+  if (rename(tmp_name.c_str(), master_name_.c_str()) != 0) {
+    LOG_DEBUG("cannot replace the master record: %s", strerror(errno));
   }
+}
 
+auto DiskManager::ReadMasterRecord(int64_t *log_offset, lsn_t *checkpoint_lsn) -> bool {
+  if (master_name_.empty()) {
+    return false;
+  }
+  char record[sizeof(MASTER_RECORD_MAGIC) + sizeof(*log_offset) + sizeof(*checkpoint_lsn)];
+  int fd = open(master_name_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  bool complete = read(fd, record, sizeof(record)) == static_cast<ssize_t>(sizeof(record));
+  close(fd);
+  if (!complete || memcmp(record, &MASTER_RECORD_MAGIC, sizeof(MASTER_RECORD_MAGIC)) != 0) {
+    return false;
+  }
+  memcpy(log_offset, record + sizeof(MASTER_RECORD_MAGIC), sizeof(*log_offset));
+  memcpy(checkpoint_lsn, record + sizeof(MASTER_RECORD_MAGIC) + sizeof(*log_offset), sizeof(*checkpoint_lsn));
   return true;
 }
 
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.cpp
+//
+// Identification: src/storage/disk/disk_scheduler.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_scheduler.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+DiskScheduler::DiskScheduler(DiskManager *disk_manager, size_t num_workers, size_t page_id_stride)
+    : disk_manager_(disk_manager), page_id_stride_(page_id_stride) {
+  BUSTUB_ASSERT(num_workers > 0, "the disk scheduler needs at least one worker");
+  BUSTUB_ASSERT(page_id_stride > 0, "the page id stride must be positive");
+  for (size_t i = 0; i < num_workers; i++) {
+    request_queues_.emplace_back(std::make_unique<Channel<std::optional<DiskRequest>>>());
+  }
+  // Spawn the background threads only once every queue exists.
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back([this, i] { StartWorkerThread(i); });
+  }
+}
+
+DiskScheduler::~DiskScheduler() {
+  // Put a `std::nullopt` in every queue to signal the workers to exit the loop
+  for (auto &queue : request_queues_) {
+    queue->Put(std::nullopt);
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void DiskScheduler::Schedule(DiskRequest r) {
+  BUSTUB_ASSERT(r.page_id_ >= 0, "cannot schedule I/O for an invalid page");
+  // The queue depends on the page id alone, so all requests for one page still go to the same worker, in order.
+  size_t queue = static_cast<size_t>(r.page_id_) / page_id_stride_ % request_queues_.size();
+  request_queues_[queue]->Put(std::move(r));
+}
+
+void DiskScheduler::StartWorkerThread(size_t worker_id) {
+  auto &queue = *request_queues_[worker_id];
+  while (true) {
+    std::optional<DiskRequest> request = queue.Get();
+    if (!request.has_value()) {
+      return;
+    }
+    if (request->is_write_ && !request->run_.empty()) {
+      request->run_.insert(request->run_.begin(), request->data_);
+      disk_manager_->WritePages(request->page_id_, request->run_);
+    } else if (request->is_write_) {
+      disk_manager_->WritePage(request->page_id_, request->data_);
+    } else {
+      disk_manager_->ReadPage(request->page_id_, request->data_);
+    }
+    request->callback_.set_value(true);
+  }
+}
+
+}  // namespace bustub
@@ -1,6 +1,10 @@
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT
+#include <utility>
 
+#include "buffer/buffer_ring.h"
+#include "buffer/extent_allocator.h"
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/rid.h"
@@ -10,13 +14,15 @@ namespace bustub {
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPoolManager *buffer_pool_manager,
-                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size)
+                          const KeyComparator &comparator, int leaf_max_size, int internal_max_size,
+                          bool optimistic)
     : index_name_(std::move(name)),
       bpm_(buffer_pool_manager),
       comparator_(std::move(comparator)),
       leaf_max_size_(leaf_max_size),
       internal_max_size_(internal_max_size),
-      header_page_id_(header_page_id) {
+      header_page_id_(header_page_id),
+      optimistic_(optimistic) {
   WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
   auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
   root_page->root_page_id_ = INVALID_PAGE_ID;
@@ -26,7 +32,10 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
+auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeHeaderPage>()->root_page_id_ == INVALID_PAGE_ID;
+}
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
@@ -37,10 +46,156 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
-  // Declaration of context instance.
-  Context ctx;
-  (void)ctx;
-  return false;
+  if (optimistic_) {
+    // Readers do not even share a latch on the root this way. Only when writers keep changing the pages underneath
+    // does the lookup latch them after all.
+    for (int attempt = 0; attempt < INDEX_OPTIMISTIC_READ_ATTEMPTS; attempt++) {
+      if (auto found = TryGetValueOptimistic(key, result); found.has_value()) {
+        return *found;
+      }
+    }
+  }
+
+  auto guard = FindLeafRead(&key);
+  if (!guard.has_value()) {
+    return false;
+  }
+  const auto *leaf = guard->template As<LeafPage>();
+  int index = leaf->KeyIndex(key, comparator_);
+  if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) != 0) {
+    return false;
+  }
+  result->push_back(leaf->ValueAt(index));
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryGetValueOptimistic(const KeyType &key, std::vector<ValueType> *result)
+    -> std::optional<bool> {
+  // The pins keep every page read in its frame, so what is read is always from the page asked for, if maybe torn.
+  Page *page = bpm_->FetchPage(header_page_id_);
+  if (page == nullptr) {
+    return std::nullopt;
+  }
+  BasicPageGuard guard(bpm_, page);
+  uint64_t version;
+  if (!page->TryReadVersion(&version)) {
+    return std::nullopt;
+  }
+  page_id_t child_page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  while (true) {
+    if (!page->ValidateVersion(version)) {
+      return std::nullopt;
+    }
+    if (child_page_id == INVALID_PAGE_ID) {
+      return false;
+    }
+    Page *child = bpm_->FetchPage(child_page_id);
+    if (child == nullptr) {
+      return std::nullopt;
+    }
+    BasicPageGuard child_guard(bpm_, child);
+    uint64_t child_version;
+    // The child is only known to be in the tree if the parent still points to it once its version is taken.
+    if (!child->TryReadVersion(&child_version) || !page->ValidateVersion(version)) {
+      return std::nullopt;
+    }
+    page = child;
+    guard = std::move(child_guard);
+    version = child_version;
+    if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+      break;
+    }
+    child_page_id = guard.As<InternalPage>()->Lookup(key, comparator_);
+  }
+
+  const auto *leaf = guard.As<LeafPage>();
+  int index = leaf->KeyIndex(key, comparator_);
+  bool found = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0;
+  ValueType value{};
+  if (found) {
+    value = leaf->ValueAt(index);
+  }
+  if (!page->ValidateVersion(version)) {
+    return std::nullopt;
+  }
+  if (found) {
+    result->push_back(value);
+  }
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafRead(const KeyType *key) -> std::optional<ReadPageGuard> {
+  ReadPageGuard guard = FetchRead(header_page_id_);
+  page_id_t page_id = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return std::nullopt;
+  }
+  // Latch the child before letting go of the parent.
+  guard = FetchRead(page_id);
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    const auto *internal = guard.As<InternalPage>();
+    page_id = key == nullptr ? internal->ValueAt(0) : internal->Lookup(*key, comparator_);
+    guard = FetchRead(page_id);
+  }
+  return guard;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafWrite(const KeyType &key) -> std::optional<WritePageGuard> {
+  ReadPageGuard parent_guard = FetchRead(header_page_id_);
+  page_id_t page_id = parent_guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return std::nullopt;
+  }
+  while (true) {
+    // A page is only initialized before it is linked into the tree and cannot be deleted while its parent is latched,
+    // so whether it is a leaf can be read before latching it.
+    Page *page = PinPage(page_id);
+    if (reinterpret_cast<const BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+      page->WLatch();
+      return WritePageGuard(bpm_, page);
+    }
+    page->RLatch();
+    parent_guard = ReadPageGuard(bpm_, page);
+    page_id = parent_guard.As<InternalPage>()->Lookup(key, comparator_);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryFetchWrite(page_id_t page_id) -> std::optional<WritePageGuard> {
+  Page *page = bpm_->FetchPage(page_id);
+  if (page == nullptr) {
+    return std::nullopt;
+  }
+  page->WLatch();
+  return WritePageGuard(bpm_, page);
+}
+
+// A reader waits with at most the parent pinned, and writers that latch the path from the root down give up all of
+// their pages when they cannot get one, so a frame comes free.
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::PinPage(page_id_t page_id) -> Page * {
+  Page *page;
+  while ((page = bpm_->FetchPage(page_id)) == nullptr) {
+    std::this_thread::yield();
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchRead(page_id_t page_id) -> ReadPageGuard {
+  Page *page = PinPage(page_id);
+  page->RLatch();
+  return {bpm_, page};
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchWrite(page_id_t page_id) -> WritePageGuard {
+  Page *page = PinPage(page_id);
+  page->WLatch();
+  return {bpm_, page};
 }
 
 /*****************************************************************************
@@ -55,10 +210,290 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
-  // Declaration of context instance.
+  if (optimistic_) {
+    // Most inserts fit into their leaf without a split, and need no more than the leaf latched for writing.
+    if (auto leaf_guard = FindLeafWrite(key); leaf_guard.has_value()) {
+      const auto *leaf = leaf_guard->template As<LeafPage>();
+      int index = leaf->KeyIndex(key, comparator_);
+      if (index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0) {
+        return false;
+      }
+      if (leaf->GetSize() < leaf->GetMaxSize()) {
+        leaf_guard->template AsMut<LeafPage>()->InsertAt(index, key, value);
+        return true;
+      }
+    }
+  }
+
+  // When the buffer pool runs out of frames, the insert lets go of all of its pages, so that the operations holding
+  // the others can finish, and starts over.
+  std::optional<bool> inserted;
+  while (!(inserted = TryInsert(key, value)).has_value()) {
+    std::this_thread::yield();
+  }
+  return *inserted;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryInsert(const KeyType &key, const ValueType &value) -> std::optional<bool> {
   Context ctx;
-  (void)ctx;
-  return false;
+  ctx.header_page_ = TryFetchWrite(header_page_id_);
+  if (!ctx.header_page_.has_value()) {
+    return std::nullopt;
+  }
+  ctx.root_page_id_ = ctx.header_page_->As<BPlusTreeHeaderPage>()->root_page_id_;
+  std::vector<BasicPageGuard> new_pages;
+  if (ctx.root_page_id_ == INVALID_PAGE_ID) {
+    if (!NewTreePages(1, &new_pages)) {
+      return std::nullopt;
+    }
+    auto *root = new_pages.back().AsMut<LeafPage>();
+    root->Init(leaf_max_size_);
+    root->InsertAt(0, key, value);
+    ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = new_pages.back().PageId();
+    return true;
+  }
+
+  // Latch crabbing: a page with room for one more key or child absorbs any split below it, so the latches above it
+  // can go.
+  auto root_guard = TryFetchWrite(ctx.root_page_id_);
+  if (!root_guard.has_value()) {
+    return std::nullopt;
+  }
+  ctx.write_set_.push_back(std::move(*root_guard));
+  while (true) {
+    const auto *page = ctx.write_set_.back().As<BPlusTreePage>();
+    if (page->GetSize() < page->GetMaxSize()) {
+      ctx.header_page_ = std::nullopt;
+      while (ctx.write_set_.size() > 1) {
+        ctx.write_set_.pop_front();
+      }
+    }
+    if (page->IsLeafPage()) {
+      break;
+    }
+    page_id_t child_page_id = reinterpret_cast<const InternalPage *>(page)->Lookup(key, comparator_);
+    auto child_guard = TryFetchWrite(child_page_id);
+    if (!child_guard.has_value()) {
+      return std::nullopt;
+    }
+    ctx.write_set_.push_back(std::move(*child_guard));
+  }
+
+  WritePageGuard &leaf_guard = ctx.write_set_.back();
+  int index = leaf_guard.As<LeafPage>()->KeyIndex(key, comparator_);
+  if (index < leaf_guard.As<LeafPage>()->GetSize() && comparator_(leaf_guard.As<LeafPage>()->KeyAt(index), key) == 0) {
+    return false;
+  }
+  if (leaf_guard.As<LeafPage>()->GetSize() < leaf_guard.As<LeafPage>()->GetMaxSize()) {
+    leaf_guard.AsMut<LeafPage>()->InsertAt(index, key, value);
+    return true;
+  }
+
+  // Every latched page below the first one with room splits, and so does the root if none has room, with a new root
+  // on top. All of their new pages are created before the first split, so that a split is never left half done.
+  size_t num_splits = ctx.header_page_.has_value() ? ctx.write_set_.size() + 1 : ctx.write_set_.size() - 1;
+  if (!NewTreePages(num_splits, &new_pages)) {
+    return std::nullopt;
+  }
+
+  // Split the full leaf: it keeps the lower half of the keys, a new leaf to its right takes the upper half.
+  auto *leaf = leaf_guard.AsMut<LeafPage>();
+  BasicPageGuard right_guard = std::move(new_pages.back());
+  new_pages.pop_back();
+  page_id_t right_page_id = right_guard.PageId();
+  auto *right = right_guard.AsMut<LeafPage>();
+  right->Init(leaf_max_size_);
+  int left_size = (leaf->GetSize() + 1) / 2;
+  if (index < left_size) {
+    leaf->MoveTailTo(left_size - 1, right);
+    leaf->InsertAt(index, key, value);
+  } else {
+    leaf->MoveTailTo(left_size, right);
+    right->InsertAt(index - left_size, key, value);
+  }
+  right->SetNextPageId(leaf->GetNextPageId());
+  leaf->SetNextPageId(right_page_id);
+  KeyType separator = right->KeyAt(0);
+  right_guard.Drop();
+  InsertIntoParent(ctx, separator, right_page_id, &new_pages);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::InsertIntoParent(Context &ctx, KeyType key, page_id_t right_page_id,
+                                      std::vector<BasicPageGuard> *new_pages) {
+  while (true) {
+    page_id_t left_page_id = ctx.write_set_.back().PageId();
+    ctx.write_set_.pop_back();
+    if (ctx.write_set_.empty()) {
+      // The root split: a new root goes on top of the two halves.
+      BUSTUB_ASSERT(ctx.IsRootPage(left_page_id) && ctx.header_page_.has_value(), "only the root has no parent");
+      BasicPageGuard &root_guard = new_pages->back();
+      auto *root = root_guard.AsMut<InternalPage>();
+      root->Init(internal_max_size_);
+      root->InsertAt(0, key, left_page_id);
+      root->InsertAt(1, key, right_page_id);
+      ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_guard.PageId();
+      return;
+    }
+
+    auto *parent = ctx.write_set_.back().AsMut<InternalPage>();
+    int index = parent->ValueIndex(left_page_id) + 1;
+    if (parent->GetSize() < parent->GetMaxSize()) {
+      parent->InsertAt(index, key, right_page_id);
+      return;
+    }
+
+    // Split the full parent the same way. The first key of the new page is the one that moves up.
+    BasicPageGuard sibling_guard = std::move(new_pages->back());
+    new_pages->pop_back();
+    page_id_t sibling_page_id = sibling_guard.PageId();
+    auto *sibling = sibling_guard.AsMut<InternalPage>();
+    sibling->Init(internal_max_size_);
+    int left_size = (parent->GetSize() + 1) / 2;
+    if (index < left_size) {
+      parent->MoveTailTo(left_size - 1, sibling);
+      parent->InsertAt(index, key, right_page_id);
+    } else {
+      parent->MoveTailTo(left_size, sibling);
+      sibling->InsertAt(index - left_size, key, right_page_id);
+    }
+    key = sibling->KeyAt(0);
+    right_page_id = sibling_page_id;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::NewTreePages(size_t num_pages, std::vector<BasicPageGuard> *new_pages) -> bool {
+  while (new_pages->size() < num_pages) {
+    page_id_t page_id;
+    Page *page = bpm_->NewPage(&page_id);
+    if (page == nullptr) {
+      for (auto &guard : *new_pages) {
+        page_id = guard.PageId();
+        guard.Drop();
+        FreeTreePages({page_id});
+      }
+      new_pages->clear();
+      return false;
+    }
+    new_pages->emplace_back(bpm_, page);
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::FreeTreePages(const std::vector<page_id_t> &page_ids) {
+  std::scoped_lock<std::mutex> lock(free_latch_);
+  pages_to_free_.insert(pages_to_free_.end(), page_ids.begin(), page_ids.end());
+  auto freed = [this](page_id_t page_id) { return bpm_->DeletePage(page_id); };
+  pages_to_free_.erase(std::remove_if(pages_to_free_.begin(), pages_to_free_.end(), freed), pages_to_free_.end());
+}
+
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(const std::vector<MappingType> &entries, double fill_factor) -> bool {
+  WritePageGuard header_guard = bpm_->FetchPageWrite(header_page_id_);
+  if (header_guard.As<BPlusTreeHeaderPage>()->root_page_id_ != INVALID_PAGE_ID) {
+    return false;
+  }
+  size_t num_keys = 0;
+  for (size_t i = 0; i < entries.size(); i++) {
+    BUSTUB_ASSERT(i == 0 || comparator_(entries[i - 1].first, entries[i].first) <= 0, "entries must be sorted");
+    if (i == 0 || comparator_(entries[i - 1].first, entries[i].first) != 0) {
+      num_keys++;
+    }
+  }
+  if (num_keys == 0) {
+    return true;
+  }
+
+  // Every page is written once and never read back while loading: the pages go through a buffer ring instead of
+  // taking over the pool, and come from extents of their own, so that they reach the disk in one sequential sweep.
+  BufferRing ring(std::min<size_t>(BUFFER_RING_SIZE, bpm_->GetPoolSize() / 4));
+  ExtentAllocator allocator(bpm_);
+  // Should the buffer pool run out of frames halfway, the pages created so far are given back.
+  std::vector<page_id_t> loaded_page_ids;
+  auto new_page = [&](page_id_t *page_id) -> std::optional<BasicPageGuard> {
+    Page *page = allocator.NewPage(page_id, &ring);
+    if (page == nullptr) {
+      return std::nullopt;
+    }
+    loaded_page_ids.push_back(*page_id);
+    return BasicPageGuard(bpm_, page);
+  };
+  // Spread count keys or children evenly over pages of about fill_factor * max_size each, unless that leaves them
+  // below min_size (as BPlusTreePage::GetMinSize() has it).
+  auto num_pages_for = [fill_factor](size_t count, int max_size, int min_size) -> size_t {
+    int per_page = std::clamp(static_cast<int>(max_size * fill_factor), std::max(min_size, 1), max_size);
+    size_t num_pages = (count + per_page - 1) / per_page;
+    if (num_pages > 1 && count / num_pages < static_cast<size_t>(min_size)) {
+      num_pages--;
+    }
+    return num_pages;
+  };
+
+  // The lowest key and the page id of every page of the level built last.
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  size_t num_leaves = num_pages_for(num_keys, leaf_max_size_, leaf_max_size_ / 2);
+  level.reserve(num_leaves);
+  BasicPageGuard prev_guard;
+  LeafPage *prev_leaf = nullptr;
+  size_t next = 0;
+  for (size_t i = 0; i < num_leaves; i++) {
+    page_id_t page_id;
+    auto guard = new_page(&page_id);
+    if (!guard.has_value()) {
+      prev_guard.Drop();
+      FreeTreePages(loaded_page_ids);
+      return false;
+    }
+    auto *leaf = guard->template AsMut<LeafPage>();
+    leaf->Init(leaf_max_size_);
+    auto size = static_cast<int>(num_keys / num_leaves + (i < num_keys % num_leaves ? 1 : 0));
+    while (leaf->GetSize() < size) {
+      if (next == 0 || comparator_(entries[next - 1].first, entries[next].first) != 0) {
+        leaf->InsertAt(leaf->GetSize(), entries[next].first, entries[next].second);
+      }
+      next++;
+    }
+    level.emplace_back(leaf->KeyAt(0), page_id);
+    if (prev_leaf != nullptr) {
+      prev_leaf->SetNextPageId(page_id);
+    }
+    prev_guard = std::move(*guard);
+    prev_leaf = leaf;
+  }
+  prev_guard.Drop();
+
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parents;
+    size_t num_parents = num_pages_for(level.size(), internal_max_size_, (internal_max_size_ + 1) / 2);
+    parents.reserve(num_parents);
+    next = 0;
+    for (size_t i = 0; i < num_parents; i++) {
+      page_id_t page_id;
+      auto guard = new_page(&page_id);
+      if (!guard.has_value()) {
+        FreeTreePages(loaded_page_ids);
+        return false;
+      }
+      auto *internal = guard->template AsMut<InternalPage>();
+      internal->Init(internal_max_size_);
+      auto size = static_cast<int>(level.size() / num_parents + (i < level.size() % num_parents ? 1 : 0));
+      for (int j = 0; j < size; j++, next++) {
+        internal->InsertAt(j, level[next].first, level[next].second);
+      }
+      parents.emplace_back(internal->KeyAt(0), page_id);
+    }
+    level = std::move(parents);
+  }
+
+  header_guard.AsMut<BPlusTreeHeaderPage>()->root_page_id_ = level[0].second;
+  return true;
 }
 
 /*****************************************************************************
@@ -73,9 +508,170 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
-  // Declaration of context instance.
+  if (optimistic_) {
+    // Likewise for a remove that leaves the leaf at its min size or above. A root leaf at its min size, which has
+    // none really, goes the pessimistic way too.
+    auto leaf_guard = FindLeafWrite(key);
+    if (!leaf_guard.has_value()) {
+      return;
+    }
+    const auto *leaf = leaf_guard->template As<LeafPage>();
+    int index = leaf->KeyIndex(key, comparator_);
+    if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) != 0) {
+      return;
+    }
+    if (leaf->GetSize() > leaf->GetMinSize()) {
+      leaf_guard->template AsMut<LeafPage>()->RemoveAt(index);
+      return;
+    }
+  }
+
+  // Like an insert, a remove that runs out of frames on the way down starts over without any of its pages.
+  while (!TryRemove(key)) {
+    std::this_thread::yield();
+  }
+  // Pages an earlier merge could not free may have been let go by now.
+  FreeTreePages({});
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::TryRemove(const KeyType &key) -> bool {
   Context ctx;
-  (void)ctx;
+  ctx.header_page_ = TryFetchWrite(header_page_id_);
+  if (!ctx.header_page_.has_value()) {
+    return false;
+  }
+  ctx.root_page_id_ = ctx.header_page_->As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (ctx.root_page_id_ == INVALID_PAGE_ID) {
+    return true;
+  }
+
+  // Latch crabbing: a page that stays at its min size with one key or child less absorbs any merge below it. The
+  // root has no min size, but changes if it loses its last key or its second to last child.
+  auto root_guard = TryFetchWrite(ctx.root_page_id_);
+  if (!root_guard.has_value()) {
+    return false;
+  }
+  ctx.write_set_.push_back(std::move(*root_guard));
+  while (true) {
+    WritePageGuard &guard = ctx.write_set_.back();
+    const auto *page = guard.As<BPlusTreePage>();
+    int min_size = ctx.IsRootPage(guard.PageId()) ? (page->IsLeafPage() ? 1 : 2) : page->GetMinSize();
+    if (page->GetSize() > min_size) {
+      ctx.header_page_ = std::nullopt;
+      while (ctx.write_set_.size() > 1) {
+        ctx.write_set_.pop_front();
+      }
+    }
+    if (page->IsLeafPage()) {
+      break;
+    }
+    page_id_t child_page_id = reinterpret_cast<const InternalPage *>(page)->Lookup(key, comparator_);
+    auto child_guard = TryFetchWrite(child_page_id);
+    if (!child_guard.has_value()) {
+      return false;
+    }
+    ctx.write_set_.push_back(std::move(*child_guard));
+  }
+
+  WritePageGuard &leaf_guard = ctx.write_set_.back();
+  int index = leaf_guard.As<LeafPage>()->KeyIndex(key, comparator_);
+  if (index == leaf_guard.As<LeafPage>()->GetSize() ||
+      comparator_(leaf_guard.As<LeafPage>()->KeyAt(index), key) != 0) {
+    return true;
+  }
+  leaf_guard.AsMut<LeafPage>()->RemoveAt(index);
+  HandleUnderflow(ctx);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::HandleUnderflow(Context &ctx) {
+  while (true) {
+    WritePageGuard guard = std::move(ctx.write_set_.back());
+    ctx.write_set_.pop_back();
+    page_id_t page_id = guard.PageId();
+    const auto *page = guard.As<BPlusTreePage>();
+    if (ctx.IsRootPage(page_id)) {
+      // An empty root leaf leaves the tree empty, a root with a single child hands the root over to it.
+      if (page->GetSize() == (page->IsLeafPage() ? 0 : 1)) {
+        BUSTUB_ASSERT(ctx.header_page_.has_value(), "the root changes with the header latched");
+        page_id_t root_page_id =
+            page->IsLeafPage() ? INVALID_PAGE_ID : reinterpret_cast<const InternalPage *>(page)->ValueAt(0);
+        ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = root_page_id;
+        guard.Drop();
+        FreeTreePages({page_id});
+      }
+      return;
+    }
+    if (page->GetSize() >= page->GetMinSize()) {
+      return;
+    }
+
+    // Latch the left one of the page and its sibling first, in the order an iterator moves from leaf to leaf. The
+    // page itself cannot change in between: every writer that could get to it needs the parent latch. With the tree
+    // already changed, this waits for a frame for the sibling rather than starting over.
+    auto *parent = ctx.write_set_.back().AsMut<InternalPage>();
+    int index = parent->ValueIndex(page_id);
+    int right_index = index > 0 ? index : 1;
+    WritePageGuard left_guard;
+    WritePageGuard right_guard;
+    if (index > 0) {
+      guard.Drop();
+      left_guard = FetchWrite(parent->ValueAt(index - 1));
+      right_guard = FetchWrite(page_id);
+    } else {
+      left_guard = std::move(guard);
+      right_guard = FetchWrite(parent->ValueAt(1));
+    }
+
+    if (left_guard.As<BPlusTreePage>()->IsLeafPage()) {
+      auto *left = left_guard.AsMut<LeafPage>();
+      auto *right = right_guard.AsMut<LeafPage>();
+      if (left->GetSize() + right->GetSize() > left->GetMaxSize()) {
+        // Borrow a key from the fuller sibling.
+        if (left->GetSize() < right->GetSize()) {
+          left->InsertAt(left->GetSize(), right->KeyAt(0), right->ValueAt(0));
+          right->RemoveAt(0);
+        } else {
+          int last = left->GetSize() - 1;
+          right->InsertAt(0, left->KeyAt(last), left->ValueAt(last));
+          left->RemoveAt(last);
+        }
+        parent->SetKeyAt(right_index, right->KeyAt(0));
+        return;
+      }
+      right->MoveTailTo(0, left);
+      left->SetNextPageId(right->GetNextPageId());
+    } else {
+      auto *left = left_guard.AsMut<InternalPage>();
+      auto *right = right_guard.AsMut<InternalPage>();
+      if (left->GetSize() + right->GetSize() > left->GetMaxSize()) {
+        // Borrow a child from the fuller sibling, rotating the separator through the parent.
+        if (left->GetSize() < right->GetSize()) {
+          left->InsertAt(left->GetSize(), parent->KeyAt(right_index), right->ValueAt(0));
+          parent->SetKeyAt(right_index, right->KeyAt(1));
+          right->RemoveAt(0);
+        } else {
+          int last = left->GetSize() - 1;
+          right->SetKeyAt(0, parent->KeyAt(right_index));
+          right->InsertAt(0, left->KeyAt(last), left->ValueAt(last));
+          parent->SetKeyAt(right_index, left->KeyAt(last));
+          left->RemoveAt(last);
+        }
+        return;
+      }
+      right->SetKeyAt(0, parent->KeyAt(right_index));
+      right->MoveTailTo(0, left);
+    }
+
+    // The two merged into the left page: the right one goes, and the parent has a child less.
+    parent->RemoveAt(right_index);
+    page_id_t right_page_id = right_guard.PageId();
+    right_guard.Drop();
+    left_guard.Drop();
+    FreeTreePages({right_page_id});
+  }
 }
 
 /*****************************************************************************
@@ -87,7 +683,13 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
+  auto guard = FindLeafRead(nullptr);
+  if (!guard.has_value()) {
+    return INDEXITERATOR_TYPE();
+  }
+  return INDEXITERATOR_TYPE(bpm_, std::move(*guard), 0);
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -95,7 +697,14 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE()
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE(); }
+auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
+  auto guard = FindLeafRead(&key);
+  if (!guard.has_value()) {
+    return INDEXITERATOR_TYPE();
+  }
+  int index = guard->template As<LeafPage>()->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(bpm_, std::move(*guard), index);
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -109,7 +718,10 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE();
  * @return Page id of the root of this tree
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return 0; }
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
+  ReadPageGuard guard = bpm_->FetchPageRead(header_page_id_);
+  return guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+}
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
@@ -9,6 +9,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "storage/index/b_plus_tree_index.h"
 
 namespace bustub {
@@ -51,6 +53,26 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   container_->GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries) -> bool {
+  // The comparator takes a NULL column as equal to anything, which is no order to sort by, and the tree would reject a
+  // key holding one as a duplicate of its neighbours anyway: leave those out.
+  auto *key_schema = GetKeySchema();
+  auto has_null = [key_schema](const auto &entry) {
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      if (entry.first.ToValue(key_schema, i).IsNull()) {
+        return true;
+      }
+    }
+    return false;
+  };
+  entries->erase(std::remove_if(entries->begin(), entries->end(), has_null), entries->end());
+  // A stable sort keeps equal keys in the order they came in, as inserting them one by one would.
+  std::stable_sort(entries->begin(), entries->end(),
+                   [this](const auto &lhs, const auto &rhs) { return comparator_(lhs.first, rhs.first) < 0; });
+  return container_->BulkLoad(*entries);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE { return container_->Begin(); }
 
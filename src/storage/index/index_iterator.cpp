@@ -2,7 +2,10 @@
  * index_iterator.cpp
  */
 #include <cassert>
+#include <thread>  // NOLINT
+#include <utility>
 
+#include "buffer/buffer_pool_manager.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
@@ -14,17 +17,53 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index)
+    : bpm_(bpm), guard_(std::move(guard)), page_id_(guard_.PageId()), index_(index) {
+  SkipToValid();
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::IsEnd() -> bool { return page_id_ == INVALID_PAGE_ID; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
+  return guard_.template As<LeafPage>()->ItemAt(index_);
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & { throw std::runtime_error("unimplemented"); }
+auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
+  index_++;
+  SkipToValid();
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & { throw std::runtime_error("unimplemented"); }
+void INDEXITERATOR_TYPE::SkipToValid() {
+  while (page_id_ != INVALID_PAGE_ID) {
+    const auto *leaf = guard_.template As<LeafPage>();
+    if (index_ < leaf->GetSize()) {
+      return;
+    }
+    page_id_ = leaf->GetNextPageId();
+    index_ = 0;
+    if (page_id_ == INVALID_PAGE_ID) {
+      guard_.Drop();
+    } else {
+      // Latch coupling from left to right, the order in which a merge latches siblings too. Like any reader of the
+      // tree, the iterator waits for a frame if the buffer pool has none left.
+      Page *page;
+      while ((page = bpm_->FetchPage(page_id_)) == nullptr) {
+        std::this_thread::yield();
+      }
+      page->RLatch();
+      guard_ = ReadPageGuard(bpm_, page);
+    }
+  }
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.cpp
+//
+// Identification: src/storage/page/b_plus_tree_key_search.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_key_search.h"
+
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace bustub {
+
+// Below this many keys, one sweep over all of them is cheaper than halving the range any further.
+static constexpr int INTEGER_KEY_SWEEP_SIZE = 32;
+
+/** Count the first count integers, stride bytes apart from entries on, that are less than bound. */
+static auto CountLessScalar(const char *entries, size_t stride, size_t key_size, int count, int64_t bound) -> int {
+  int less = 0;
+  for (int i = 0; i < count; i++) {
+    less += ReadIntegerKey(entries + i * stride, key_size) < bound ? 1 : 0;
+  }
+  return less;
+}
+
+#if defined(__x86_64__)
+/**
+ * Like CountLessScalar(), but gathering four 8-byte or eight 4-byte keys at a time. Keys of 1 or 2 bytes are gathered
+ * as 4 bytes and sign extended: a GenericKey is at least 4 bytes, so that does not read past it.
+ */
+__attribute__((target("avx2"))) static auto CountLessAvx2(const char *entries, size_t stride, size_t key_size,
+                                                          int count, int64_t bound) -> int {
+  int less = 0;
+  int i = 0;
+  auto stride32 = static_cast<int32_t>(stride);
+  if (key_size == 8) {
+    const __m128i offsets = _mm_setr_epi32(0, stride32, 2 * stride32, 3 * stride32);
+    const __m256i bounds = _mm256_set1_epi64x(bound);
+    for (; i + 4 <= count; i += 4) {
+      __m256i keys = _mm256_i32gather_epi64(reinterpret_cast<const long long *>(entries + i * stride),  // NOLINT
+                                            offsets, 1);
+      auto mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(bounds, keys)));
+      less += __builtin_popcount(mask);
+    }
+  } else {
+    const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride32));
+    const __m256i bounds = _mm256_set1_epi32(static_cast<int32_t>(bound));
+    const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(32 - 8 * key_size));
+    for (; i + 8 <= count; i += 8) {
+      __m256i keys = _mm256_i32gather_epi32(reinterpret_cast<const int *>(entries + i * stride), offsets, 1);
+      keys = _mm256_sra_epi32(_mm256_sll_epi32(keys, shift), shift);
+      auto mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(bounds, keys)));
+      less += __builtin_popcount(mask);
+    }
+  }
+  return less + CountLessScalar(entries + i * stride, stride, key_size, count - i, bound);
+}
+#endif
+
+using CountLessFunc = auto (*)(const char *, size_t, size_t, int, int64_t) -> int;
+
+static auto PickCountLess() -> CountLessFunc {
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx2")) {
+    return CountLessAvx2;
+  }
+#endif
+  return CountLessScalar;
+}
+
+static const CountLessFunc COUNT_LESS = PickCountLess();
+
+auto ReadIntegerKey(const char *data, size_t key_size) -> int64_t {
+  switch (key_size) {
+    case 1: {
+      int8_t key;
+      memcpy(&key, data, sizeof(key));
+      return key;
+    }
+    case 2: {
+      int16_t key;
+      memcpy(&key, data, sizeof(key));
+      return key;
+    }
+    case 4: {
+      int32_t key;
+      memcpy(&key, data, sizeof(key));
+      return key;
+    }
+    default: {
+      int64_t key;
+      memcpy(&key, data, sizeof(key));
+      return key;
+    }
+  }
+}
+
+auto IntegerKeyNull(size_t key_size) -> int64_t {
+  return key_size == 8 ? std::numeric_limits<int64_t>::min() : -(int64_t{1} << (8 * key_size - 1));
+}
+
+auto IntegerKeyBound(const char *entries, size_t stride, size_t key_size, int begin, int end, int64_t key, bool upper)
+    -> int {
+  // The first key greater than key is the first one not less than key + 1, unless nothing is greater than key.
+  int64_t max_key = key_size == 8 ? std::numeric_limits<int64_t>::max() : (int64_t{1} << (8 * key_size - 1)) - 1;
+  if (upper && key >= max_key) {
+    return end;
+  }
+  int64_t bound = upper ? key + 1 : key;
+
+  while (end - begin > INTEGER_KEY_SWEEP_SIZE) {
+    int mid = begin + (end - begin) / 2;
+    if (ReadIntegerKey(entries + mid * stride, key_size) < bound) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  // The keys are sorted, so as many of the rest are less than bound as come before it.
+  return begin + COUNT_LESS(entries + begin * stride, stride, key_size, end - begin, bound);
+}
+
+}  // namespace bustub
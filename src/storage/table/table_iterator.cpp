@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 
 #include "common/exception.h"
@@ -18,10 +19,23 @@
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, BufferRing *ring)
+    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn), ring_(ring) {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  // Leave at least three quarters of the pool to everything else.
+  read_ahead_max_ = std::min<size_t>(buffer_pool_manager->GetPoolSize() / 4, TABLE_READ_AHEAD_MAX_PAGES);
+  if (ring_ != nullptr) {
+    read_ahead_max_ = std::min(read_ahead_max_, ring_->GetNumFrames() / 2);
+  }
+  read_ahead_window_ = std::min<size_t>(read_ahead_max_, TABLE_READ_AHEAD_MIN_PAGES);
   if (rid.GetPageId() != INVALID_PAGE_ID) {
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_)) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(rid.GetPageId(), AccessType::Scan, ring_));
+    BUSTUB_ENSURE(page != nullptr, "BPM full");
+    page->RLatch();
+    bool found = page->GetTuple(tuple_->rid_, tuple_, txn_, table_heap_->lock_manager_);
+    page->RUnlatch();
+    buffer_pool_manager->UnpinPage(rid.GetPageId(), false, AccessType::Scan);
+    if (!found) {
       throw bustub::Exception("read non-existing tuple");
     }
   }
@@ -39,7 +53,8 @@ auto TableIterator::operator->() -> Tuple * {
 
 auto TableIterator::operator++() -> TableIterator & {
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
+  auto cur_page =
+      static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId(), AccessType::Scan, ring_));
   BUSTUB_ENSURE(cur_page != nullptr, "BPM full");  // all pages are pinned
 
   cur_page->RLatch();
@@ -47,9 +62,11 @@ auto TableIterator::operator++() -> TableIterator & {
   if (!cur_page->GetNextTupleRid(tuple_->rid_,
                                  &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
+      ReadAhead(cur_page->GetTablePageId(), cur_page->GetNextPageId());
+      auto next_page =
+          static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId(), AccessType::Scan, ring_));
       cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false, AccessType::Scan);
       cur_page = next_page;
       cur_page->RLatch();
       if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
@@ -60,20 +77,57 @@ auto TableIterator::operator++() -> TableIterator & {
   tuple_->rid_ = next_tuple_rid;
 
   if (*this != table_heap_->End()) {
-    // DO NOT ACQUIRE READ LOCK twice in a single thread otherwise it may deadlock.
-    // See https://users.rust-lang.org/t/how-bad-is-the-potential-deadlock-mentioned-in-rwlocks-document/67234
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, false)) {
+    // Read the tuple from the page we already hold. Going through TableHeap::GetTuple() would fetch the page again,
+    // outside of the scan's buffer ring.
+    if (!cur_page->GetTuple(tuple_->rid_, tuple_, txn_, table_heap_->lock_manager_)) {
       cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false, AccessType::Scan);
       throw bustub::Exception("read non-existing tuple");
     }
   }
   // release until copy the tuple
   cur_page->RUnlatch();
-  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false, AccessType::Scan);
   return *this;
 }
 
+void TableIterator::ReadAhead(page_id_t cur_page_id, page_id_t next_page_id) {
+  if (read_ahead_max_ == 0) {
+    return;
+  }
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+
+  // The scan has to wait for next_page_id if it is not in memory yet: read further ahead from now on.
+  if (buffer_pool_manager->PrefetchPage(next_page_id, ring_)) {
+    if (++read_ahead_hits_ >= read_ahead_window_ && read_ahead_window_ > TABLE_READ_AHEAD_MIN_PAGES) {
+      read_ahead_window_--;
+      read_ahead_hits_ = 0;
+    }
+  } else {
+    read_ahead_window_ = std::min(read_ahead_window_ * 2, read_ahead_max_);
+    read_ahead_hits_ = 0;
+  }
+
+  page_id_t stride = next_page_id - cur_page_id;
+  if (stride == read_ahead_stride_ && read_ahead_pages_ > 0) {
+    // next_page_id is the first page we predicted.
+    read_ahead_pages_--;
+  } else {
+    // Wrong prediction (or none yet): start over from the real link.
+    read_ahead_stride_ = stride;
+    read_ahead_frontier_ = next_page_id;
+    read_ahead_pages_ = 0;
+  }
+  if (read_ahead_stride_ <= 0) {
+    return;
+  }
+  while (read_ahead_pages_ < read_ahead_window_) {
+    read_ahead_frontier_ += read_ahead_stride_;
+    buffer_pool_manager->PrefetchPage(read_ahead_frontier_, ring_);
+    read_ahead_pages_++;
+  }
+}
+
 auto TableIterator::operator++(int) -> TableIterator {
   TableIterator clone(*this);
   ++(*this);
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer_test.cpp
+//
+// Identification: test/buffer/arc_replacer_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ArcReplacerTest, SampleTest) {
+  ArcReplacer replacer(4);
+
+  // Scenario: pages 10 to 13 come in on frames 0 to 3, and page 10 is accessed again. T1 is [3,2,1], T2 is [0].
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    replacer.RecordAccess(frame_id, AccessType::Unknown, 10 + frame_id);
+    replacer.SetEvictable(frame_id, true);
+  }
+  replacer.RecordAccess(0);
+  ASSERT_EQ(4, replacer.Size());
+  ASSERT_EQ(0, replacer.GetTargetT1Size());
+
+  // Scenario: T1 is above its target of 0, so its least recently used frame goes first.
+  frame_id_t frame_id;
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  EXPECT_EQ(3, replacer.Size());
+
+  // Scenario: page 11 comes back while remembered in B1. T1 should have been larger, and page 11 goes to T2.
+  replacer.RecordAccess(1, AccessType::Unknown, 11);
+  replacer.SetEvictable(1, true);
+  EXPECT_EQ(1, replacer.GetTargetT1Size());
+
+  // Scenario: T1 is [3,2], above its target of 1, then T2 is [1,0] in LRU order.
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(2, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(3, frame_id);
+  EXPECT_FALSE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, replacer.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(ArcReplacerTest, ScanTest) {
+  ArcReplacer replacer(3);
+  for (frame_id_t frame_id = 0; frame_id < 3; frame_id++) {
+    replacer.RecordAccess(frame_id, AccessType::Scan, frame_id);
+    replacer.SetEvictable(frame_id, true);
+  }
+
+  // Scenario: a second scan of page 0 keeps it in T1, while a second get of page 2 moves it to T2.
+  replacer.RecordAccess(0, AccessType::Scan, 0);
+  replacer.RecordAccess(2, AccessType::Get, 2);
+
+  frame_id_t frame_id;
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(2, frame_id);
+}
+
+// NOLINTNEXTLINE
+TEST(ArcReplacerTest, SkipTest) {
+  ArcReplacer replacer(4);
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    replacer.RecordAccess(frame_id, AccessType::Unknown, frame_id);
+    replacer.SetEvictable(frame_id, true);
+  }
+  replacer.SetEvictable(0, false);
+  EXPECT_EQ(3, replacer.Size());
+  EXPECT_EQ((std::vector<frame_id_t>{1, 2, 3}), replacer.GetEvictionCandidates(10));
+
+  // Scenario: frame 0 is not evictable and frame 1 is refused, so frame 2 goes.
+  frame_id_t frame_id;
+  ASSERT_TRUE(replacer.Evict(&frame_id, [](frame_id_t victim) { return victim != 1; }));
+  EXPECT_EQ(2, frame_id);
+
+  // Scenario: a removed frame is forgotten.
+  replacer.Remove(3);
+  EXPECT_EQ(1, replacer.Size());
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  EXPECT_FALSE(replacer.Evict(&frame_id));
+}
+
+}  // namespace bustub
@@ -12,9 +12,15 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <memory>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -22,7 +28,7 @@ namespace bustub {
 
 // NOLINTNEXTLINE
 // Check whether pages containing terminal characters can be recovered
-TEST(BufferPoolManagerTest, DISABLED_BinaryDataTest) {
+TEST(BufferPoolManagerTest, BinaryDataTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 10;
   const size_t k = 5;
@@ -88,7 +94,7 @@ TEST(BufferPoolManagerTest, DISABLED_BinaryDataTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(BufferPoolManagerTest, DISABLED_SampleTest) {
+TEST(BufferPoolManagerTest, SampleTest) {
   const std::string db_name = "test.db";
   const size_t buffer_pool_size = 10;
   const size_t k = 5;
@@ -144,4 +150,320 @@ TEST(BufferPoolManagerTest, DISABLED_SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PrefetchPageTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 3;
+  const size_t k = 2;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, k);
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page0);
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+
+  // Scenario: Page 0 is resident, so reading it ahead is a no-op.
+  EXPECT_TRUE(bpm->PrefetchPage(0));
+
+  // Scenario: Pages that were never allocated are ignored.
+  EXPECT_FALSE(bpm->PrefetchPage(100));
+  EXPECT_FALSE(bpm->PrefetchPage(INVALID_PAGE_ID));
+
+  // Scenario: Push page 0 out with three other pages, then read it ahead. It ends up resident without a pin.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_FALSE(bpm->PrefetchPage(0));
+  while (!bpm->PrefetchPage(0)) {
+    std::this_thread::yield();
+  }
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(1, page0->GetPinCount());
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+  // Scenario: Read-ahead pages do not stay pinned. Every frame can still be used for new pages.
+  EXPECT_FALSE(bpm->PrefetchPage(1));
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentHitTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  const size_t k = 2;
+  const int num_pages = 64;
+  const int num_threads = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, k);
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: Threads hitting a few hot pages without the latch race with threads that keep evicting cold ones. Every
+  // fetch must get the page it asked for.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid] {
+      std::mt19937 gen(tid);
+      for (int i = 0; i < 20000; i++) {
+        auto page_id = static_cast<page_id_t>(tid % 2 == 0 ? gen() % 4 : gen() % num_pages);
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        page->RLatch();
+        ASSERT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+        page->RUnlatch();
+        ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Scenario: No pin was lost or leaked, so every frame can be reused.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ReplacerPolicyTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 8;
+  const int num_pages = 32;
+
+  for (auto policy : {ReplacerPolicy::LRUK, ReplacerPolicy::ARC, ReplacerPolicy::TwoQueue, ReplacerPolicy::ClockPro}) {
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, LRUK_REPLACER_K, nullptr,
+                                      DISK_SCHEDULER_NUM_WORKERS, policy);
+    AccessTrace trace;
+    bpm->SetAccessTrace(&trace);
+    for (int i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+
+    // Scenario: Every policy must give back the page that was asked for, with some frames held pinned.
+    std::mt19937 gen(0);
+    std::vector<page_id_t> pinned;
+    for (int i = 0; i < 2000; i++) {
+      auto page_id = static_cast<page_id_t>(gen() % 4 == 0 ? gen() % 4 : gen() % num_pages);
+      auto *page = bpm->FetchPage(page_id);
+      ASSERT_NE(nullptr, page) << ReplacerPolicyToString(policy);
+      ASSERT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+      pinned.push_back(page_id);
+      if (pinned.size() > buffer_pool_size / 2) {
+        ASSERT_TRUE(bpm->UnpinPage(pinned.front(), false));
+        pinned.erase(pinned.begin());
+      }
+    }
+    bpm->SetAccessTrace(nullptr);
+    EXPECT_EQ(num_pages + 2000, trace.GetAccesses().size());
+    EXPECT_TRUE(trace.GetAccesses().front().is_new_);
+    EXPECT_FALSE(trace.GetAccesses().back().is_new_);
+
+    disk_manager->ShutDown();
+    remove("test.db");
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FlushLatchedPageTest) {
+  const std::string db_name = "flush_latched_test.db";
+  const std::string log_name = "flush_latched_test.log";
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+  page_id_t page_id;
+  {
+    auto guard = bpm->NewPageGuarded(&page_id);
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "old");
+  }
+  ASSERT_TRUE(bpm->FlushPage(page_id));
+
+  // Scenario: Flushing a page somebody is changing under its write latch waits for them instead of writing it torn.
+  // Writing back all pages does not wait for it.
+  char data[BUSTUB_PAGE_SIZE];
+  {
+    auto guard = bpm->FetchPageWrite(page_id);
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "new");
+    std::atomic<bool> flushed{false};
+    std::thread flusher([&] {
+      EXPECT_TRUE(bpm->FlushPage(page_id));
+      flushed = true;
+    });
+    bpm->FlushAllPages();
+    disk_manager->ReadPage(page_id, data);
+    EXPECT_STREQ("old", data);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(flushed);
+
+    // Scenario: Once the latch is released, the waiting flush writes the page.
+    guard.Drop();
+    flusher.join();
+  }
+  disk_manager->ReadPage(page_id, data);
+  EXPECT_STREQ("new", data);
+
+  bpm = nullptr;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, FrameArenaTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const int num_pages = 50;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, LRUK_REPLACER_K, nullptr,
+                                    DISK_SCHEDULER_NUM_WORKERS, ReplacerPolicy::LRUK, true);
+
+  // Scenario: The frames are contiguous and page aligned, and their metadata is cache-line aligned.
+  Page *pages = bpm->GetPages();
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    EXPECT_EQ(pages[0].GetData() + i * BUSTUB_PAGE_SIZE, pages[i].GetData());
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pages[i].GetData()) % BUSTUB_PAGE_SIZE);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(&pages[i]) % CACHE_LINE_SIZE);
+  }
+
+  // Scenario: Pages written through the arena survive eviction, and new pages start zeroed.
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(0, page->GetData()[BUSTUB_PAGE_SIZE - 1]);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page->GetData()[BUSTUB_PAGE_SIZE - 1] = 'x';
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_EQ('x', page->GetData()[BUSTUB_PAGE_SIZE - 1]);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, WarmRestartTest) {
+  const std::string db_name = "warm_restart_test.db";
+  const std::string warm_name = "warm_restart_test.warm";
+  const size_t k = 2;
+  remove(db_name.c_str());
+  remove(warm_name.c_str());
+
+  // Create five pages and access one of them repeatedly. Shutting down saves the resident pages.
+  std::vector<page_id_t> saved;
+  page_id_t hot_page_id = INVALID_PAGE_ID;
+  {
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(10, disk_manager, k);
+    bpm->EnableFreeSpaceMap();
+    bpm->EnableWarmRestart(warm_name);
+    for (int i = 0; i < 5; i++) {
+      page_id_t page_id;
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+      if (i == 1) {
+        hot_page_id = page_id;
+      }
+    }
+    for (int i = 0; i < 3; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(hot_page_id));
+      ASSERT_TRUE(bpm->UnpinPage(hot_page_id, false));
+    }
+    bpm->FlushAllPages();
+    saved = bpm->GetResidentPages();
+    ASSERT_LE(6, saved.size());
+    EXPECT_EQ(hot_page_id, saved.back());
+    delete bpm;
+    disk_manager->ShutDown();
+    delete disk_manager;
+  }
+
+  // Scenario: After a restart with a smaller pool, the hottest pages that fit into the free frames are loaded in the
+  // background, and keep their eviction order.
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(4, disk_manager, k);
+  bpm->EnableFreeSpaceMap();
+  std::vector<page_id_t> resident = bpm->GetResidentPages();
+  size_t free_frames = 4 - resident.size();
+  std::vector<page_id_t> expected;
+  for (auto it = saved.rbegin(); it != saved.rend() && expected.size() < free_frames; ++it) {
+    if (std::find(resident.begin(), resident.end(), *it) == resident.end()) {
+      expected.insert(expected.begin(), *it);
+    }
+  }
+  bpm->EnableWarmRestart(warm_name);
+  while (bpm->IsWarmingUp()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  resident = bpm->GetResidentPages();
+  ASSERT_EQ(4, resident.size());
+  EXPECT_EQ(expected, std::vector<page_id_t>(resident.end() - free_frames, resident.end()));
+
+  // Scenario: The loaded pages hold their data and are hits.
+  uint64_t hits = bpm->GetHitCount(AccessType::Unknown);
+  auto *page = bpm->FetchPage(hot_page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page " + std::to_string(hot_page_id), std::string(page->GetData()));
+  EXPECT_EQ(hits + 1, bpm->GetHitCount(AccessType::Unknown));
+  ASSERT_TRUE(bpm->UnpinPage(hot_page_id, false));
+
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove(db_name.c_str());
+  remove(warm_name.c_str());
+}
+
 }  // namespace bustub
@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_ring_test.cpp
+//
+// Identification: test/buffer/buffer_ring_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_ring.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// Create num_pages pages and return how many hot page fetches missed after a scan over most of them.
+static auto HotPageMissesAfterScan(bool use_ring) -> uint64_t {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+  const page_id_t num_pages = 60;
+  const page_id_t num_hot_pages = 5;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+  for (page_id_t i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  auto fetch_hot_pages = [&]() {
+    for (page_id_t page_id = 0; page_id < num_hot_pages; page_id++) {
+      EXPECT_NE(nullptr, bpm->FetchPage(page_id, AccessType::Get));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false, AccessType::Get));
+    }
+  };
+  for (int round = 0; round < 3; round++) {
+    fetch_hot_pages();
+  }
+
+  // Like a table scan, touch every page twice in a row.
+  auto ring = std::make_unique<BufferRing>(2);
+  for (page_id_t page_id = num_hot_pages; page_id < num_pages; page_id++) {
+    for (int i = 0; i < 2; i++) {
+      EXPECT_NE(nullptr, bpm->FetchPage(page_id, AccessType::Scan, use_ring ? ring.get() : nullptr));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false, AccessType::Scan));
+    }
+  }
+
+  auto misses = bpm->GetMissCount(AccessType::Get);
+  fetch_hot_pages();
+  misses = bpm->GetMissCount(AccessType::Get) - misses;
+  bpm = nullptr;
+  disk_manager->ShutDown();
+  return misses;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferRingTest, ScanKeepsHotPagesTest) {
+  // Without a ring, the scan's pages look just as hot to LRU-K and push the working set out.
+  EXPECT_GT(HotPageMissesAfterScan(false), 0);
+  EXPECT_EQ(0, HotPageMissesAfterScan(true));
+}
+
+// NOLINTNEXTLINE
+TEST(BufferRingTest, SharedPageLeavesRingTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+  for (int i = 0; i < 8; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  bpm->FlushAllPages();
+
+  BufferRing ring(1);
+  ASSERT_NE(nullptr, bpm->FetchPage(0, AccessType::Scan, &ring));
+  ASSERT_TRUE(bpm->UnpinPage(0, false));
+
+  // Scenario: Another query fetches page 0 too, so the ring must not recycle its frame.
+  ASSERT_NE(nullptr, bpm->FetchPage(0, AccessType::Get));
+  ASSERT_TRUE(bpm->UnpinPage(0, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(1, AccessType::Scan, &ring));
+  ASSERT_TRUE(bpm->UnpinPage(1, false));
+  EXPECT_TRUE(bpm->PrefetchPage(0));
+
+  // Scenario: Page 1 is the ring's alone, so the ring's next page takes its frame.
+  ASSERT_NE(nullptr, bpm->FetchPage(2, AccessType::Scan, &ring));
+  ASSERT_TRUE(bpm->UnpinPage(2, false));
+  EXPECT_FALSE(bpm->PrefetchPage(1));
+
+  bpm = nullptr;
+  disk_manager->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(BufferRingTest, BulkWriteTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+  const int num_pages = 50;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+
+  // Scenario: Pages written through a small ring are written back when the ring recycles their frames.
+  BufferRing ring(2);
+  for (int i = 0; i < num_pages; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id, &ring);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true, AccessType::Scan));
+  }
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  bpm = nullptr;
+  disk_manager->ShutDown();
+}
+
+}  // namespace bustub
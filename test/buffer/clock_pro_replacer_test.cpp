@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_pro_replacer_test.cpp
+//
+// Identification: test/buffer/clock_pro_replacer_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/clock_pro_replacer.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ClockProReplacerTest, SampleTest) {
+  ClockProReplacer replacer(3);
+
+  // Scenario: pages 1 to 3 come in cold on frames 0 to 2, and page 1 is accessed again.
+  for (frame_id_t frame_id = 0; frame_id < 3; frame_id++) {
+    replacer.RecordAccess(frame_id, AccessType::Unknown, frame_id + 1);
+    replacer.SetEvictable(frame_id, true);
+  }
+  replacer.RecordAccess(0);
+  ASSERT_EQ(3, replacer.Size());
+
+  // Scenario: page 1 was referenced in its test period and becomes hot, so page 2 goes.
+  frame_id_t frame_id;
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  EXPECT_EQ(2, replacer.Size());
+
+  // Scenario: page 2 comes back during its test period, so it comes in hot and the cold pages go first.
+  replacer.RecordAccess(1, AccessType::Unknown, 2);
+  replacer.SetEvictable(1, true);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(2, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  EXPECT_FALSE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, replacer.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(ClockProReplacerTest, SkipTest) {
+  ClockProReplacer replacer(4);
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    replacer.RecordAccess(frame_id, AccessType::Unknown, frame_id);
+    replacer.SetEvictable(frame_id, true);
+  }
+  replacer.SetEvictable(0, false);
+  EXPECT_EQ(3, replacer.Size());
+
+  // Scenario: frame 0 is not evictable and frame 1 is refused, so frame 2 goes.
+  frame_id_t frame_id;
+  ASSERT_TRUE(replacer.Evict(&frame_id, [](frame_id_t victim) { return victim != 1; }));
+  EXPECT_EQ(2, frame_id);
+
+  replacer.Remove(3);
+  EXPECT_EQ(1, replacer.Size());
+  EXPECT_FALSE(replacer.Evict(&frame_id, [](frame_id_t) { return false; }));
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  EXPECT_FALSE(replacer.Evict(&frame_id));
+}
+
+// NOLINTNEXTLINE
+TEST(ClockProReplacerTest, RandomTest) {
+  // Scenario: random accesses over more pages than frames. Every evicted frame must be one that is tracked and
+  // evictable, and eviction must succeed as long as there is one.
+  const size_t num_frames = 16;
+  ClockProReplacer replacer(num_frames);
+  std::vector<page_id_t> frame_pages(num_frames, INVALID_PAGE_ID);
+  std::set<frame_id_t> pinned;
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<page_id_t> page_dist(0, 63);
+
+  for (int i = 0; i < 10000; i++) {
+    page_id_t page_id = page_dist(gen);
+    auto it = std::find(frame_pages.begin(), frame_pages.end(), page_id);
+    frame_id_t frame_id;
+    if (it != frame_pages.end()) {
+      frame_id = static_cast<frame_id_t>(it - frame_pages.begin());
+      replacer.RecordAccess(frame_id, AccessType::Unknown, page_id);
+      continue;
+    }
+    it = std::find(frame_pages.begin(), frame_pages.end(), INVALID_PAGE_ID);
+    if (it != frame_pages.end()) {
+      frame_id = static_cast<frame_id_t>(it - frame_pages.begin());
+    } else {
+      ASSERT_EQ(num_frames - pinned.size(), replacer.Size());
+      ASSERT_TRUE(replacer.Evict(&frame_id));
+      ASSERT_EQ(0, pinned.count(frame_id));
+    }
+    frame_pages[frame_id] = page_id;
+    replacer.RecordAccess(frame_id, AccessType::Unknown, page_id);
+    // Keep a few frames pinned at any time.
+    bool pin = gen() % 8 == 0 && pinned.size() < num_frames / 2;
+    replacer.SetEvictable(frame_id, !pin);
+    if (pin) {
+      pinned.insert(frame_id);
+    } else if (!pinned.empty() && gen() % 2 == 0) {
+      replacer.SetEvictable(*pinned.begin(), true);
+      pinned.erase(pinned.begin());
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// concurrent_page_table_test.cpp
+//
+// Identification: test/buffer/concurrent_page_table_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/concurrent_page_table.h"
+
+#include <atomic>
+#include <random>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ConcurrentPageTableTest, SampleTest) {
+  const size_t max_entries = 100;
+  ConcurrentPageTable table(max_entries);
+  std::unordered_map<page_id_t, frame_id_t> expected;
+  std::mt19937 gen(0);
+
+  // Scenario: Random inserts and erases, like pages moving in and out of a buffer pool. Erase has to shift entries
+  // back across wrapped clusters, so run long enough to hit those.
+  for (int i = 0; i < 100000; i++) {
+    auto page_id = static_cast<page_id_t>(gen() % (4 * max_entries));
+    if (expected.count(page_id) > 0) {
+      EXPECT_TRUE(table.Erase(page_id));
+      expected.erase(page_id);
+    } else if (expected.size() < max_entries) {
+      auto frame_id = static_cast<frame_id_t>(gen() % max_entries);
+      table.Insert(page_id, frame_id);
+      expected[page_id] = frame_id;
+    }
+    ASSERT_EQ(expected.size(), table.Size());
+  }
+
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(4 * max_entries); page_id++) {
+    frame_id_t frame_id;
+    auto it = expected.find(page_id);
+    if (it == expected.end()) {
+      EXPECT_FALSE(table.Find(page_id, &frame_id));
+      EXPECT_FALSE(table.Erase(page_id));
+    } else {
+      ASSERT_TRUE(table.Find(page_id, &frame_id));
+      EXPECT_EQ(it->second, frame_id);
+    }
+  }
+
+  // Scenario: Inserting an existing page replaces its frame.
+  table.Insert(1000, 1);
+  table.Insert(1000, 2);
+  frame_id_t frame_id;
+  ASSERT_TRUE(table.Find(1000, &frame_id));
+  EXPECT_EQ(2, frame_id);
+}
+
+// NOLINTNEXTLINE
+TEST(ConcurrentPageTableTest, ConcurrentFindTest) {
+  const size_t max_entries = 64;
+  const page_id_t num_stable_pages = 16;
+  ConcurrentPageTable table(max_entries);
+  for (page_id_t page_id = 0; page_id < num_stable_pages; page_id++) {
+    table.Insert(page_id, page_id);
+  }
+
+  // Scenario: While one writer churns through other pages, lookups of the pages that stay never return a wrong
+  // frame. They may miss while an entry is being moved, which is what callers recheck under their lock.
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    std::mt19937 gen(0);
+    std::vector<page_id_t> churn;
+    for (int i = 0; i < 200000; i++) {
+      if (churn.size() < max_entries - num_stable_pages && gen() % 2 == 0) {
+        auto page_id = static_cast<page_id_t>(num_stable_pages + gen() % 1000);
+        table.Insert(page_id, -1);
+        churn.push_back(page_id);
+      } else if (!churn.empty()) {
+        table.Erase(churn.back());
+        churn.pop_back();
+      }
+    }
+    done = true;
+  });
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 2; i++) {
+    readers.emplace_back([&] {
+      while (!done) {
+        for (page_id_t page_id = 0; page_id < num_stable_pages; page_id++) {
+          frame_id_t frame_id;
+          if (table.Find(page_id, &frame_id)) {
+            ASSERT_EQ(page_id, frame_id);
+          }
+        }
+      }
+    });
+  }
+  writer.join();
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  for (page_id_t page_id = 0; page_id < num_stable_pages; page_id++) {
+    frame_id_t frame_id;
+    ASSERT_TRUE(table.Find(page_id, &frame_id));
+    EXPECT_EQ(page_id, frame_id);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extent_allocator_test.cpp
+//
+// Identification: test/buffer/extent_allocator_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/extent_allocator.h"
+
+#include <sys/stat.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ExtentAllocatorTest, ContiguousTest) {
+  const size_t extent_size = 8;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManager(10, disk_manager);
+
+  // Scenario: Two owners growing at the same time each get runs of consecutive pages.
+  std::vector<page_id_t> page_ids[2];
+  {
+    ExtentAllocator allocators[2] = {ExtentAllocator(bpm, INVALID_PAGE_ID, extent_size),
+                                     ExtentAllocator(bpm, INVALID_PAGE_ID, extent_size)};
+    for (int i = 0; i < 20; i++) {
+      for (int owner = 0; owner < 2; owner++) {
+        page_id_t page_id;
+        ASSERT_NE(nullptr, allocators[owner].NewPage(&page_id));
+        page_ids[owner].push_back(page_id);
+        ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+      }
+    }
+  }
+  for (auto &owned : page_ids) {
+    for (size_t i = 1; i < owned.size(); i++) {
+      if (i % extent_size != 0) {
+        EXPECT_EQ(owned[i - 1] + 1, owned[i]);
+      }
+    }
+  }
+
+  // Scenario: Pages of a reserved extent are not handed out by NewPage().
+  std::vector<page_id_t> extent = bpm->AllocateExtent(4);
+  ASSERT_EQ(4, extent.size());
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(extent.back() + 1, page_id);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm->NewPageAt(extent[0]));
+  ASSERT_TRUE(bpm->UnpinPage(extent[0], false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtentAllocatorTest, FreeSpaceMapTest) {
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManager(10, disk_manager);
+  bpm->EnableFreeSpaceMap();
+
+  // Scenario: The unused rest of an extent is given back when its owner goes away.
+  {
+    ExtentAllocator allocator(bpm, INVALID_PAGE_ID, 8);
+    for (page_id_t expected = 1; expected <= 3; expected++) {
+      page_id_t page_id;
+      ASSERT_NE(nullptr, allocator.NewPage(&page_id));
+      EXPECT_EQ(expected, page_id);
+      ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+  }
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(4, page_id);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+
+  // Scenario: An extent takes the first run of free pages that is long enough.
+  for (page_id_t deleted : {2, 3}) {
+    ASSERT_TRUE(bpm->DeletePage(deleted));
+  }
+  std::vector<page_id_t> extent = bpm->AllocateExtent(3);
+  EXPECT_EQ((std::vector<page_id_t>{5, 6, 7}), extent);
+  extent = bpm->AllocateExtent(2);
+  EXPECT_EQ((std::vector<page_id_t>{2, 3}), extent);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtentAllocatorTest, PreallocateTest) {
+  const std::string db_name = "test.db";
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto file_size = [&]() {
+    struct stat stat_buf;
+    return stat(db_name.c_str(), &stat_buf) == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
+  };
+
+  // Scenario: The file grows by whole extents, and reserved pages read as zeros.
+  char data[BUSTUB_PAGE_SIZE];
+  memset(data, 'x', BUSTUB_PAGE_SIZE);
+  disk_manager->WritePage(0, data);
+  EXPECT_EQ(static_cast<int64_t>(EXTENT_SIZE) * BUSTUB_PAGE_SIZE, file_size());
+  disk_manager->AllocateExtent(EXTENT_SIZE, 3 * EXTENT_SIZE);
+  EXPECT_EQ(static_cast<int64_t>(4 * EXTENT_SIZE) * BUSTUB_PAGE_SIZE, file_size());
+  disk_manager->ReadPage(2 * EXTENT_SIZE, data);
+  EXPECT_EQ(0, data[0]);
+  disk_manager->ReadPage(0, data);
+  EXPECT_EQ('x', data[0]);
+
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+}  // namespace bustub
@@ -0,0 +1,195 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_test.cpp
+//
+// Identification: test/buffer/free_space_map_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/free_space_map.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/page/free_space_map_page.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FreeSpaceMapTest, MapPageTest) {
+  alignas(uint64_t) char data[BUSTUB_PAGE_SIZE];
+  memset(data, 0, BUSTUB_PAGE_SIZE);
+  auto *map = reinterpret_cast<FreeSpaceMapPage *>(data);
+  EXPECT_FALSE(map->IsInitialized());
+  map->Init();
+  EXPECT_TRUE(map->IsInitialized());
+  EXPECT_EQ(-1, map->FindLastSet());
+
+  for (int bit = 0; bit < 200; bit++) {
+    if (bit != 70 && bit != 130) {
+      map->Set(bit);
+    }
+  }
+  EXPECT_EQ(198, map->CountSet());
+  EXPECT_EQ(199, map->FindLastSet());
+  EXPECT_EQ(70, map->FindClearFrom(0));
+  EXPECT_EQ(130, map->FindClearFrom(71));
+  EXPECT_EQ(200, map->FindClearFrom(131));
+  EXPECT_EQ(-1, map->FindClearBefore(70));
+  EXPECT_EQ(70, map->FindClearBefore(130));
+  EXPECT_EQ(130, map->FindClearBefore(192));
+
+  map->Clear(5);
+  EXPECT_FALSE(map->IsSet(5));
+  EXPECT_EQ(5, map->FindClearBefore(64));
+  for (int bit = 200; bit < FreeSpaceMapPage::NUM_BITS; bit++) {
+    map->Set(bit);
+  }
+  EXPECT_EQ(-1, map->FindClearFrom(131));
+  EXPECT_EQ(FreeSpaceMapPage::NUM_BITS - 1, map->FindLastSet());
+}
+
+// NOLINTNEXTLINE
+TEST(FreeSpaceMapTest, ReuseTest) {
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManager(10, disk_manager);
+  bpm->EnableFreeSpaceMap();
+
+  // Scenario: Page 0 holds the map, so pages are numbered from 1.
+  for (page_id_t expected = 1; expected <= 20; expected++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(expected, page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  EXPECT_FALSE(bpm->DeletePage(0));
+
+  // Scenario: Deleted pages are reused, resident or not, the one closest to the hint first and the lowest otherwise.
+  for (page_id_t page_id : {3, 12, 14, 18}) {
+    ASSERT_TRUE(bpm->DeletePage(page_id));
+  }
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id, nullptr, 17));
+  EXPECT_EQ(18, page_id);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id, nullptr, 13));
+  EXPECT_EQ(12, page_id);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(3, page_id);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(14, page_id);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(21, page_id);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+
+  // Scenario: A reused page starts zeroed, even if the deleted page was read ahead again.
+  auto *page = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page);
+  memset(page->GetData(), 'x', BUSTUB_PAGE_SIZE);
+  ASSERT_TRUE(bpm->UnpinPage(1, true));
+  ASSERT_TRUE(bpm->FlushPage(1));
+  ASSERT_TRUE(bpm->DeletePage(1));
+  bpm->PrefetchPage(1);
+  page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(1, page_id);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_EQ(0, page->GetData()[BUSTUB_PAGE_SIZE - 1]);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(FreeSpaceMapTest, RestartTest) {
+  const std::string db_name = "test.db";
+  remove(db_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(10, disk_manager);
+  bpm->EnableFreeSpaceMap();
+  for (int i = 0; i < 30; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  ASSERT_TRUE(bpm->DeletePage(7));
+  ASSERT_TRUE(bpm->DeletePage(30));
+  bpm->FlushAllPages();
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  // Scenario: After a restart, freed pages are reused first, then the file grows after the last allocated page.
+  disk_manager = new DiskManager(db_name);
+  bpm = new BufferPoolManager(10, disk_manager);
+  bpm->EnableFreeSpaceMap();
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(7, page_id);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(30, page_id);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(31, page_id);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+
+  // Scenario: The pages that were not deleted are intact.
+  auto *page = bpm->FetchPage(29);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page 29", std::string(page->GetData()));
+  ASSERT_TRUE(bpm->UnpinPage(29, false));
+
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(FreeSpaceMapTest, ParallelTest) {
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(3, 5, disk_manager);
+  bpm->EnableFreeSpaceMap();
+
+  // Scenario: Every instance keeps its own map in its first page.
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 12; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_GE(page_id, 3);
+    page_ids.push_back(page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (page_id_t page_id = 0; page_id < 3; page_id++) {
+    EXPECT_FALSE(bpm->DeletePage(page_id));
+  }
+
+  // Scenario: A page freed in one instance is reused by a new page near it.
+  page_id_t victim = page_ids[4];
+  ASSERT_TRUE(bpm->DeletePage(victim));
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id, nullptr, victim + 3));
+  EXPECT_EQ(victim, page_id);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
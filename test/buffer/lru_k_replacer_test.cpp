@@ -16,7 +16,7 @@
 
 namespace bustub {
 
-TEST(LRUKReplacerTest, DISABLED_SampleTest) {
+TEST(LRUKReplacerTest, SampleTest) {
   LRUKReplacer lru_replacer(7, 2);
 
   // Scenario: add six elements to the replacer. We have [1,2,3,4,5]. Frame 6 is non-evictable.
@@ -95,4 +95,64 @@ TEST(LRUKReplacerTest, DISABLED_SampleTest) {
   ASSERT_EQ(false, lru_replacer.Evict(&value));
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, RandomTest) {
+  // Scenario: random accesses, pins and evictions. Every victim must be the one a full scan of the access histories
+  // picks.
+  const size_t num_frames = 64;
+  const size_t k = 3;
+  LRUKReplacer lru_replacer(num_frames, k);
+  std::vector<std::vector<size_t>> history(num_frames);
+  std::vector<bool> evictable(num_frames, false);
+  size_t timestamp = 0;
+  std::mt19937 gen(0);
+
+  auto expected_victim = [&]() {
+    frame_id_t victim = -1;
+    std::pair<bool, size_t> victim_key;
+    for (size_t fid = 0; fid < num_frames; fid++) {
+      if (history[fid].empty() || !evictable[fid]) {
+        continue;
+      }
+      // +inf backward k-distance first, then the oldest relevant timestamp.
+      bool full = history[fid].size() >= k;
+      std::pair<bool, size_t> key{full, history[fid][history[fid].size() - std::min(k, history[fid].size())]};
+      if (victim == -1 || key < victim_key) {
+        victim = static_cast<frame_id_t>(fid);
+        victim_key = key;
+      }
+    }
+    return victim;
+  };
+
+  for (int i = 0; i < 20000; i++) {
+    auto fid = static_cast<frame_id_t>(gen() % num_frames);
+    switch (gen() % 4) {
+      case 0:
+      case 1:
+        lru_replacer.RecordAccess(fid);
+        history[fid].push_back(timestamp++);
+        break;
+      case 2:
+        if (!history[fid].empty()) {
+          bool set_evictable = gen() % 4 != 0;
+          lru_replacer.SetEvictable(fid, set_evictable);
+          evictable[fid] = set_evictable;
+        }
+        break;
+      default: {
+        frame_id_t expected = expected_victim();
+        int victim;
+        ASSERT_EQ(expected != -1, lru_replacer.Evict(&victim));
+        if (expected != -1) {
+          ASSERT_EQ(expected, victim);
+          history[victim].clear();
+          evictable[victim] = false;
+        }
+      }
+    }
+    ASSERT_EQ(std::count(evictable.begin(), evictable.end(), true), lru_replacer.Size());
+  }
+}
+
 }  // namespace bustub
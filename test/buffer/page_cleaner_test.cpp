@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_cleaner_test.cpp
+//
+// Identification: test/buffer/page_cleaner_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "recovery/log_manager.h"
+#include "recovery/log_record.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// Wait until the page cleaners of bpm have written at least num_pages pages, for up to five seconds.
+static auto WaitForCleaner(BufferPoolManager *bpm, uint64_t num_pages) -> bool {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (bpm->GetCleanerWriteCount() < num_pages) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, EvictCleanedPagesTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k);
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: With a target of 100%, the cleaner writes back every dirty page in the pool.
+  bpm->RunPageCleaner(buffer_pool_size, std::chrono::milliseconds(1), 100);
+  ASSERT_TRUE(WaitForCleaner(bpm.get(), buffer_pool_size));
+  bpm->StopPageCleaner();
+
+  // Scenario: Evicting the cleaned pages does not write anything in the foreground.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(buffer_pool_size, bpm->GetEvictionCount());
+  EXPECT_EQ(0, bpm->GetForegroundWriteCount());
+
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); page_id++) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  bpm = nullptr;
+  disk_manager->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, WriteAheadLogTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, log_manager.get());
+  log_manager->SetPersistentLSN(10);
+
+  page_id_t logged_page_id;
+  auto *logged_page = bpm->NewPage(&logged_page_id);
+  ASSERT_NE(nullptr, logged_page);
+  logged_page->SetLSN(5);
+  ASSERT_TRUE(bpm->UnpinPage(logged_page_id, true));
+
+  page_id_t unlogged_page_id;
+  auto *unlogged_page = bpm->NewPage(&unlogged_page_id);
+  ASSERT_NE(nullptr, unlogged_page);
+  unlogged_page->SetLSN(20);
+  ASSERT_TRUE(bpm->UnpinPage(unlogged_page_id, true));
+
+  // Scenario: The cleaner must not write a page before the log records up to its LSN are persistent.
+  enable_logging = true;
+  bpm->RunPageCleaner(buffer_pool_size, std::chrono::milliseconds(1), 100);
+  ASSERT_TRUE(WaitForCleaner(bpm.get(), 1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(1, bpm->GetCleanerWriteCount());
+  EXPECT_FALSE(logged_page->IsDirty());
+  EXPECT_TRUE(unlogged_page->IsDirty());
+
+  // Scenario: Once the log catches up, the page gets written.
+  log_manager->SetPersistentLSN(20);
+  ASSERT_TRUE(WaitForCleaner(bpm.get(), 2));
+  bpm->StopPageCleaner();
+  enable_logging = false;
+  EXPECT_FALSE(unlogged_page->IsDirty());
+
+  bpm = nullptr;
+  disk_manager->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(PageCleanerTest, ForegroundEvictionWriteAheadLogTest) {
+  const std::string db_name = "page_cleaner_wal_test.db";
+  const std::string log_name = "page_cleaner_wal_test.log";
+  const size_t buffer_pool_size = 2;
+  const size_t k = 2;
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, log_manager.get());
+  enable_logging = true;
+
+  LogRecord record(0, INVALID_LSN, LogRecordType::BEGIN);
+  lsn_t lsn = log_manager->AppendLogRecord(&record);
+  ASSERT_LT(log_manager->GetPersistentLSN(), lsn);
+  page_id_t page_id;
+  auto *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  page->SetLSN(lsn);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+
+  // Scenario: Eviction takes a clean page over a dirty one whose log records are not on disk yet, rather than wait for
+  // the log.
+  page_id_t clean_page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&clean_page_id));
+  ASSERT_TRUE(bpm->UnpinPage(clean_page_id, false));
+  std::vector<page_id_t> other_page_ids(buffer_pool_size);
+  ASSERT_NE(nullptr, bpm->NewPage(&other_page_ids[0]));
+  EXPECT_EQ(0, bpm->GetForegroundWriteCount());
+  EXPECT_LT(log_manager->GetPersistentLSN(), lsn);
+
+  // Scenario: Evicting a dirty page without the cleaner also writes its log records first.
+  ASSERT_NE(nullptr, bpm->NewPage(&other_page_ids[1]));
+  EXPECT_EQ(1, bpm->GetForegroundWriteCount());
+  EXPECT_GE(log_manager->GetPersistentLSN(), lsn);
+  for (auto other_page_id : other_page_ids) {
+    ASSERT_TRUE(bpm->UnpinPage(other_page_id, false));
+  }
+  enable_logging = false;
+
+  bpm = nullptr;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+}
+
+}  // namespace bustub
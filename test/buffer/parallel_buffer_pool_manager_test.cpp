@@ -0,0 +1,213 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+/** Records the runs written by WritePages() and the number of syncs. */
+class RunRecordingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void WritePages(page_id_t first_page_id, const std::vector<const char *> &pages) override {
+    {
+      std::scoped_lock<std::mutex> lock(mutex_);
+      runs_.emplace_back(first_page_id, pages.size());
+    }
+    DiskManagerUnlimitedMemory::WritePages(first_page_id, pages);
+  }
+
+  void SyncPages() override { syncs_++; }
+
+  std::mutex mutex_;
+  std::vector<std::pair<page_id_t, size_t>> runs_;
+  int syncs_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 5;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get(), k);
+  EXPECT_EQ(buffer_pool_size * num_instances, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: We should be able to create new pages until we fill up every instance.
+  std::vector<page_id_t> page_ids{page_id_temp};
+  for (size_t i = 1; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    page_ids.push_back(page_id_temp);
+  }
+
+  // Scenario: Every page id is owned by the instance it maps to.
+  for (auto page_id : page_ids) {
+    EXPECT_EQ(bpm->GetBufferPoolManager(page_id), bpm->GetBufferPoolManager(page_id % num_instances));
+  }
+
+  // Scenario: Once every instance is full, we should not be able to create any new pages.
+  for (size_t i = 0; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: After unpinning page 0 and creating a new page, the new page must come from instance 0, the only one
+  // with an evictable frame, so fetching page 0 again fails while every other instance is still pinned.
+  EXPECT_EQ(true, bpm->UnpinPage(0, true));
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0, page_id_temp % static_cast<page_id_t>(num_instances));
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
+
+  // Scenario: Once a frame frees up in instance 0, page 0 can be read back from disk.
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Scenario: Unpinning a page that is not pinned fails.
+  EXPECT_EQ(false, bpm->UnpinPage(0, false));
+
+  disk_manager->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, GuardTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_instances = 3;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get(), 2);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size * num_instances; ++i) {
+    page_id_t page_id;
+    auto guard = bpm->NewPageGuarded(&page_id);
+    snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: Dropping the guards returned the pins to the owning instances, so every page can be fetched again.
+  for (auto page_id : page_ids) {
+    auto guard = bpm->FetchPageRead(page_id);
+    EXPECT_EQ(page_id, guard.PageId());
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(guard.GetData()));
+  }
+
+  // Scenario: A page can only be deleted once it is unpinned.
+  {
+    auto guard = bpm->FetchPageWrite(page_ids[0]);
+    EXPECT_EQ(false, bpm->DeletePage(page_ids[0]));
+  }
+  EXPECT_EQ(true, bpm->DeletePage(page_ids[0]));
+
+  disk_manager->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const size_t num_threads = 8;
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 16;
+  const size_t pages_per_thread = 64;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get(), 2);
+
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&bpm] {
+      std::vector<page_id_t> page_ids;
+      for (size_t i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id;
+        auto guard = bpm->NewPageGuarded(&page_id);
+        ASSERT_NE(nullptr, guard.GetData());
+        snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "%d", page_id);
+        page_ids.push_back(page_id);
+      }
+      for (auto page_id : page_ids) {
+        auto guard = bpm->FetchPageRead(page_id);
+        EXPECT_EQ(std::to_string(page_id), std::string(guard.GetData()));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  disk_manager->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, FlushAllPagesTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t num_instances = 4;
+
+  auto disk_manager = std::make_unique<RunRecordingDiskManager>();
+  auto bpm = std::make_unique<ParallelBufferPoolManager>(num_instances, buffer_pool_size, disk_manager.get(), 2);
+
+  // Dirty pages 0..11 except 5, and keep page 7 pinned.
+  for (page_id_t expected = 0; expected < 12; expected++) {
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id);
+    if (page_id != 7) {
+      ASSERT_TRUE(bpm->UnpinPage(page_id, page_id != 5));
+    }
+  }
+  ASSERT_TRUE(bpm->UnpinPage(7, true));
+  ASSERT_NE(nullptr, bpm->FetchPage(7));
+
+  // Scenario: Adjacent dirty pages are written with one call each although they belong to different instances, and
+  // the disk manager is synced once.
+  bpm->FlushAllPages();
+  using Run = std::pair<page_id_t, size_t>;
+  std::sort(disk_manager->runs_.begin(), disk_manager->runs_.end());
+  EXPECT_EQ((std::vector<Run>{{0, 5}, {6, 6}}), disk_manager->runs_);
+  EXPECT_EQ(1, disk_manager->syncs_);
+  char data[BUSTUB_PAGE_SIZE];
+  disk_manager->ReadPage(11, data);
+  EXPECT_STREQ("11", data);
+
+  // Scenario: Flushed pages are clean, so a second flush writes nothing, and pinned pages stay pinned.
+  disk_manager->runs_.clear();
+  bpm->FlushAllPages();
+  EXPECT_TRUE(disk_manager->runs_.empty());
+  EXPECT_EQ(1, disk_manager->syncs_);
+  EXPECT_TRUE(bpm->UnpinPage(7, false));
+  EXPECT_FALSE(bpm->UnpinPage(7, false));
+
+  disk_manager->ShutDown();
+}
+
+}  // namespace bustub
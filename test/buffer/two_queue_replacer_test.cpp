@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer_test.cpp
+//
+// Identification: test/buffer/two_queue_replacer_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TwoQueueReplacerTest, SampleTest) {
+  // A1in may hold 2 of the 8 frames before it is evicted from first.
+  TwoQueueReplacer replacer(8);
+
+  // Scenario: pages 100 to 103 come in on frames 0 to 3. Accessing page 100 again in A1in changes nothing.
+  for (frame_id_t frame_id = 0; frame_id < 4; frame_id++) {
+    replacer.RecordAccess(frame_id, AccessType::Unknown, 100 + frame_id);
+    replacer.SetEvictable(frame_id, true);
+  }
+  replacer.RecordAccess(0, AccessType::Unknown, 100);
+  ASSERT_EQ(4, replacer.Size());
+
+  frame_id_t frame_id;
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+
+  // Scenario: page 100 comes back while remembered in A1out, and goes to Am.
+  replacer.RecordAccess(0, AccessType::Unknown, 100);
+  replacer.SetEvictable(0, true);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+
+  // Scenario: a new page goes to A1in. A1in is [1,3,2], above its share, and then down to it.
+  replacer.RecordAccess(1, AccessType::Unknown, 200);
+  replacer.SetEvictable(1, true);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(2, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(3, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  EXPECT_FALSE(replacer.Evict(&frame_id));
+}
+
+// NOLINTNEXTLINE
+TEST(TwoQueueReplacerTest, ScanResistanceTest) {
+  TwoQueueReplacer replacer(8);
+  frame_id_t frame_id;
+
+  // Scenario: page 0 is made hot on frame 0, then a scan runs over many pages through the other frames.
+  replacer.RecordAccess(0, AccessType::Get, 0);
+  replacer.SetEvictable(0, true);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  replacer.RecordAccess(0, AccessType::Get, 0);
+  replacer.SetEvictable(0, true);
+
+  for (page_id_t page_id = 1; page_id < 7; page_id++) {
+    replacer.RecordAccess(page_id, AccessType::Scan, page_id);
+    replacer.SetEvictable(page_id, true);
+  }
+  for (page_id_t page_id = 7; page_id < 100; page_id++) {
+    ASSERT_TRUE(replacer.Evict(&frame_id));
+    ASSERT_NE(0, frame_id);
+    replacer.RecordAccess(frame_id, AccessType::Scan, page_id);
+    replacer.SetEvictable(frame_id, true);
+  }
+}
+
+}  // namespace bustub
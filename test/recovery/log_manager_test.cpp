@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_manager_test.cpp
+//
+// Identification: test/recovery/log_manager_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LogManagerTest, GroupCommitTest) {
+  const std::string db_name = "log_manager_group_commit_test.db";
+  const std::string log_name = "log_manager_group_commit_test.log";
+  const size_t num_threads = 8;
+  const size_t commits_per_thread = 200;
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), log_manager.get());
+
+  log_manager->RunFlushThread();
+  ASSERT_TRUE(enable_logging);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&] {
+      for (size_t j = 0; j < commits_per_thread; j++) {
+        Transaction *txn = txn_manager->Begin();
+        txn_manager->Commit(txn);
+        // A committed transaction's commit record is on disk.
+        EXPECT_GE(log_manager->GetPersistentLSN(), txn->GetPrevLSN());
+        delete txn;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Every transaction logged BEGIN and COMMIT; concurrent commits shared log flushes.
+  const auto commits = static_cast<int>(num_threads * commits_per_thread);
+  EXPECT_EQ(2 * commits, log_manager->GetNextLSN());
+  EXPECT_EQ(log_manager->GetNextLSN() - 1, log_manager->GetPersistentLSN());
+  EXPECT_LE(disk_manager->GetNumFlushes(), commits);
+
+  log_manager->StopFlushThread();
+  ASSERT_FALSE(enable_logging);
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(LogManagerTest, FlushWithoutThreadTest) {
+  const std::string db_name = "log_manager_no_thread_test.db";
+  const std::string log_name = "log_manager_no_thread_test.log";
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+
+  // Fill the log buffer more than twice over; appenders flush it themselves when it is full.
+  lsn_t last_lsn = INVALID_LSN;
+  for (int i = 0; i < 3 * LOG_BUFFER_SIZE / 20; i++) {
+    LogRecord record(i, last_lsn, LogRecordType::BEGIN);
+    last_lsn = log_manager->AppendLogRecord(&record);
+    EXPECT_EQ(i, last_lsn);
+  }
+  EXPECT_LT(log_manager->GetPersistentLSN(), last_lsn);
+  EXPECT_GE(disk_manager->GetNumFlushes(), 2);
+
+  log_manager->WaitUntilPersistent(last_lsn);
+  EXPECT_EQ(last_lsn, log_manager->GetPersistentLSN());
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(LogManagerTest, ConcurrentAppendTest) {
+  const std::string db_name = "log_manager_concurrent_append_test.db";
+  const std::string log_name = "log_manager_concurrent_append_test.log";
+  const int num_threads = 8;
+  const int records_per_thread = 5000;
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  log_manager->RunFlushThread();
+
+  // Records of two different sizes from many threads, so reservations interleave across buffer swaps.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, i] {
+      for (int j = 0; j < records_per_thread; j++) {
+        if (j % 2 == 0) {
+          LogRecord record(i, INVALID_LSN, LogRecordType::BEGIN);
+          log_manager->AppendLogRecord(&record);
+        } else {
+          LogRecord record(i, INVALID_LSN, LogRecordType::NEWPAGE, i, j);
+          log_manager->AppendLogRecord(&record);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  log_manager->StopFlushThread();
+  ASSERT_EQ(num_threads * records_per_thread, log_manager->GetNextLSN());
+  ASSERT_EQ(num_threads * records_per_thread - 1, log_manager->GetPersistentLSN());
+
+  // The log holds every record exactly once, in LSN order, with a valid header.
+  std::vector<char> log(num_threads * records_per_thread * 28);
+  ASSERT_TRUE(disk_manager->ReadLog(log.data(), static_cast<int>(log.size()), 0));
+  size_t offset = 0;
+  for (lsn_t lsn = 0; lsn < num_threads * records_per_thread; lsn++) {
+    int32_t size;
+    lsn_t record_lsn;
+    txn_id_t txn_id;
+    memcpy(&size, log.data() + offset, sizeof(int32_t));
+    memcpy(&record_lsn, log.data() + offset + 4, sizeof(lsn_t));
+    memcpy(&txn_id, log.data() + offset + 8, sizeof(txn_id_t));
+    ASSERT_TRUE(size == 20 || size == 28) << "lsn " << lsn;
+    ASSERT_EQ(lsn, record_lsn);
+    ASSERT_TRUE(txn_id >= 0 && txn_id < num_threads);
+    offset += size;
+  }
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+}
+
+}  // namespace bustub
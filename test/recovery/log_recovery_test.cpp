@@ -0,0 +1,844 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_recovery_test.cpp
+//
+// Identification: test/recovery/log_recovery_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <sys/stat.h>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction_manager.h"
+#include "fmt/core.h"
+#include "gtest/gtest.h"
+#include "recovery/checkpoint_manager.h"
+#include "recovery/log_manager.h"
+#include "recovery/log_recovery.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+static auto MakeTuple(const Schema &schema, int32_t key, int32_t value) -> Tuple {
+  std::vector<Value> values{Value(TypeId::INTEGER, key), Value(TypeId::INTEGER, value)};
+  return {values, &schema};
+}
+
+static void CopyFile(const std::string &from, const std::string &to) {
+  std::ifstream in(from, std::ios::binary);
+  std::ofstream out(to, std::ios::binary | std::ios::trunc);
+  out << in.rdbuf();
+}
+
+/**
+ * Run a committed transaction that inserts num_tuples tuples and a loser transaction that inserts, updates and
+ * deletes on top of it, then crash: the log is flushed but no page is.
+ * @return the first page of the table
+ */
+static auto RunCrashWorkload(const std::string &db_name, const Schema &schema, size_t pool_size, int num_tuples,
+                             std::vector<RID> *committed_rids, std::vector<RID> *loser_rids) -> page_id_t {
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManager>(pool_size, disk_manager.get());
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), log_manager.get());
+  log_manager->RunFlushThread();
+
+  Transaction *txn = txn_manager->Begin();
+  auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), log_manager.get(), txn);
+  for (int i = 0; i < num_tuples; i++) {
+    RID rid;
+    EXPECT_TRUE(table->InsertTuple(MakeTuple(schema, i, i), &rid, txn));
+    committed_rids->push_back(rid);
+  }
+  txn_manager->Commit(txn);
+  delete txn;
+
+  Transaction *loser = txn_manager->Begin();
+  for (int i = 0; i < num_tuples / 10; i++) {
+    RID rid;
+    EXPECT_TRUE(table->InsertTuple(MakeTuple(schema, num_tuples + i, 0), &rid, loser));
+    loser_rids->push_back(rid);
+  }
+  for (int i = 0; i < num_tuples; i += 7) {
+    EXPECT_TRUE(table->UpdateTuple(MakeTuple(schema, i, -i), (*committed_rids)[i], loser));
+  }
+  for (int i = 3; i < num_tuples; i += 7) {
+    EXPECT_TRUE(table->MarkDelete((*committed_rids)[i], loser));
+  }
+
+  // Crash: the log reaches the disk, the dirty pages do not.
+  page_id_t first_page_id = table->GetFirstPageId();
+  log_manager->StopFlushThread();
+  table.reset();
+  bpm.reset();
+  disk_manager->ShutDown();
+  delete loser;
+  return first_page_id;
+}
+
+// NOLINTNEXTLINE
+TEST(LogRecoveryTest, ParallelRedoUndoTest) {
+  const std::string db_name = "log_recovery_redo_undo_test.db";
+  const std::string log_name = "log_recovery_redo_undo_test.log";
+  const int num_tuples = 2000;
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}});
+  std::vector<RID> committed_rids;
+  std::vector<RID> loser_rids;
+  page_id_t first_page_id = RunCrashWorkload(db_name, schema, 64, num_tuples, &committed_rids, &loser_rids);
+  ASSERT_FALSE(enable_logging);
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get(), LRUK_REPLACER_K, log_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), nullptr, first_page_id);
+  Tuple tuple;
+  auto txn = std::make_unique<Transaction>(0);
+  ASSERT_FALSE(table->GetTuple(committed_rids[0], &tuple, txn.get()));
+
+  LogRecovery log_recovery(disk_manager.get(), bpm.get(), log_manager.get(), 4);
+  log_recovery.Redo();
+  log_recovery.Undo();
+
+  // The committed tuples are back with their committed values, the loser's changes are gone.
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(table->GetTuple(committed_rids[i], &tuple, txn.get())) << i;
+    ASSERT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    ASSERT_EQ(i, tuple.GetValue(&schema, 1).GetAs<int32_t>());
+  }
+  for (const auto &rid : loser_rids) {
+    ASSERT_FALSE(table->GetTuple(rid, &tuple, txn.get()));
+  }
+
+  // Running recovery again changes nothing: every page LSN already covers the log.
+  LogRecovery again(disk_manager.get(), bpm.get(), log_manager.get(), 4);
+  again.Redo();
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(table->GetTuple(committed_rids[i], &tuple, txn.get())) << i;
+    ASSERT_EQ(i, tuple.GetValue(&schema, 1).GetAs<int32_t>());
+  }
+
+  table.reset();
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(LogRecoveryTest, CheckpointAfterRecoveryTest) {
+  const std::string db_name = "log_recovery_after_recovery_test.db";
+  const std::string log_name = "log_recovery_after_recovery_test.log";
+  const std::string master_name = "log_recovery_after_recovery_test.ckpt";
+  const int num_tuples = 1000;
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+  remove(master_name.c_str());
+
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}});
+  std::vector<RID> committed_rids;
+  std::vector<RID> loser_rids;
+  page_id_t first_page_id = RunCrashWorkload(db_name, schema, 64, num_tuples, &committed_rids, &loser_rids);
+
+  // Scenario: the first checkpoint after recovery must not truncate the log that the recovered pages, still only in
+  // the buffer pool, depend on.
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+    auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get(), LRUK_REPLACER_K, log_manager.get());
+    auto lock_manager = std::make_unique<LockManager>();
+    auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), log_manager.get());
+    CheckpointManager checkpoint_manager(txn_manager.get(), log_manager.get(), bpm.get());
+    LogRecovery log_recovery(disk_manager.get(), bpm.get(), log_manager.get(), 4);
+    log_recovery.Redo();
+    log_recovery.Undo();
+
+    log_manager->RunFlushThread();
+    checkpoint_manager.BeginCheckpoint();
+    checkpoint_manager.EndCheckpoint();
+    auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), log_manager.get(), first_page_id);
+    Transaction *txn = txn_manager->Begin();
+    for (int i = 0; i < num_tuples; i += 5) {
+      EXPECT_TRUE(table->UpdateTuple(MakeTuple(schema, i, -i), committed_rids[i], txn));
+    }
+    txn_manager->Commit(txn);
+    delete txn;
+
+    // Crash again: the log reaches the disk, the dirty pages do not.
+    log_manager->StopFlushThread();
+    table.reset();
+    bpm.reset();
+    disk_manager->ShutDown();
+  }
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get(), LRUK_REPLACER_K, log_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), nullptr, first_page_id);
+  LogRecovery log_recovery(disk_manager.get(), bpm.get(), log_manager.get(), 4);
+  log_recovery.Redo();
+  log_recovery.Undo();
+
+  Tuple tuple;
+  auto txn = std::make_unique<Transaction>(0);
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(table->GetTuple(committed_rids[i], &tuple, txn.get())) << i;
+    ASSERT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    ASSERT_EQ(i % 5 == 0 ? -i : i, tuple.GetValue(&schema, 1).GetAs<int32_t>());
+  }
+  for (const auto &rid : loser_rids) {
+    ASSERT_FALSE(table->GetTuple(rid, &tuple, txn.get()));
+  }
+
+  table.reset();
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+  remove(master_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(LogRecoveryTest, RepeatedRecoveryTest) {
+  const std::string db_name = "log_recovery_repeated_test.db";
+  const std::string log_name = "log_recovery_repeated_test.log";
+  const int num_tuples = 500;
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"name", TypeId::VARCHAR, 64}});
+  auto make_tuple = [&](int32_t a, const std::string &name) {
+    std::vector<Value> values{Value(TypeId::INTEGER, a), Value(TypeId::VARCHAR, name)};
+    return Tuple(values, &schema);
+  };
+  std::vector<RID> rids;
+  std::vector<RID> loser_rids;
+  page_id_t first_page_id;
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+    auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+    auto lock_manager = std::make_unique<LockManager>();
+    auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), log_manager.get());
+    log_manager->RunFlushThread();
+
+    Transaction *txn = txn_manager->Begin();
+    auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), log_manager.get(), txn);
+    first_page_id = table->GetFirstPageId();
+    for (int i = 0; i < num_tuples; i++) {
+      RID rid;
+      EXPECT_TRUE(table->InsertTuple(make_tuple(i, fmt::format("tuple {:04}", i)), &rid, txn));
+      rids.push_back(rid);
+    }
+    txn_manager->Commit(txn);
+    delete txn;
+
+    // A loser that inserts, deletes tuples as if it crashed while applying its deletes at commit, and lengthens names
+    // in the space that freed up.
+    Transaction *loser = txn_manager->Begin();
+    for (int i = 0; i < num_tuples / 10; i++) {
+      RID rid;
+      EXPECT_TRUE(table->InsertTuple(make_tuple(num_tuples + i, "loser"), &rid, loser));
+      loser_rids.push_back(rid);
+    }
+    for (int i = 1; i < num_tuples; i += 7) {
+      EXPECT_TRUE(table->MarkDelete(rids[i], loser));
+      table->ApplyDelete(rids[i], loser);
+    }
+    for (int i = 0; i < num_tuples; i += 14) {
+      EXPECT_TRUE(table->UpdateTuple(make_tuple(i, fmt::format("longer tuple {:04}", i)), rids[i], loser));
+    }
+
+    // Crash: the log reaches the disk, the dirty pages do not.
+    log_manager->StopFlushThread();
+    table.reset();
+    bpm.reset();
+    disk_manager->ShutDown();
+    delete loser;
+  }
+
+  // Scenario: recovery flushes the rolled back pages, then crashes before any checkpoint, and even before the ABORT
+  // record of the loser reaches the log. The next recovery must not roll the loser back a second time.
+  for (int run = 0; run < 2; run++) {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+    auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get(), LRUK_REPLACER_K, log_manager.get());
+    auto lock_manager = std::make_unique<LockManager>();
+    auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), nullptr, first_page_id);
+    LogRecovery log_recovery(disk_manager.get(), bpm.get(), log_manager.get(), 4);
+    log_recovery.Redo();
+    log_recovery.Undo();
+
+    Tuple tuple;
+    auto txn = std::make_unique<Transaction>(0);
+    for (int i = 0; i < num_tuples; i++) {
+      ASSERT_TRUE(table->GetTuple(rids[i], &tuple, txn.get())) << run << " " << i;
+      ASSERT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>()) << run;
+      ASSERT_EQ(fmt::format("tuple {:04}", i), tuple.GetValue(&schema, 1).ToString()) << run;
+    }
+    for (const auto &rid : loser_rids) {
+      ASSERT_FALSE(table->GetTuple(rid, &tuple, txn.get())) << run;
+    }
+
+    table.reset();
+    bpm.reset();
+    disk_manager->ShutDown();
+    // The ABORT record is the last one in the log, after the CLRs: wipe it.
+    LogRecord abort_record(0, INVALID_LSN, LogRecordType::ABORT);
+    std::vector<char> zeros(abort_record.GetSize(), 0);
+    std::fstream log(log_name, std::ios::binary | std::ios::in | std::ios::out);
+    log.seekp(-static_cast<std::streamoff>(zeros.size()), std::ios::end);
+    log.write(zeros.data(), zeros.size());
+  }
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(LogRecoveryTest, SpaceDependentUndoTest) {
+  const std::string db_name = "log_recovery_space_undo_test.db";
+  const std::string log_name = "log_recovery_space_undo_test.log";
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 1024}});
+  auto make_tuple = [&](int32_t key, size_t length) {
+    std::vector<Value> values{Value(TypeId::INTEGER, key), Value(TypeId::VARCHAR, std::string(length, 'x'))};
+    return Tuple(values, &schema);
+  };
+  RID big_rid;
+  std::vector<RID> filler_rids;
+  std::vector<RID> loser_rids;
+  page_id_t first_page_id;
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager.get());
+    auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+    auto lock_manager = std::make_unique<LockManager>();
+    auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), log_manager.get());
+    log_manager->RunFlushThread();
+
+    // A big tuple and fillers up to the end of the first page.
+    Transaction *txn = txn_manager->Begin();
+    auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), log_manager.get(), txn);
+    first_page_id = table->GetFirstPageId();
+    EXPECT_TRUE(table->InsertTuple(make_tuple(0, 1000), &big_rid, txn));
+    RID rid;
+    int32_t key = 1;
+    do {
+      EXPECT_TRUE(table->InsertTuple(make_tuple(key++, 200), &rid, txn));
+      filler_rids.push_back(rid);
+    } while (rid.GetPageId() == first_page_id);
+    txn_manager->Commit(txn);
+    delete txn;
+
+    // Loser B shrinks the big tuple, then loser A, which began first, takes the space that freed up.
+    Transaction *loser_a = txn_manager->Begin();
+    Transaction *loser_b = txn_manager->Begin();
+    EXPECT_TRUE(table->UpdateTuple(make_tuple(0, 10), big_rid, loser_b));
+    for (int32_t key = -1; key >= -3; key--) {
+      EXPECT_TRUE(table->InsertTuple(make_tuple(key, 250), &rid, loser_a));
+      EXPECT_EQ(first_page_id, rid.GetPageId());
+      loser_rids.push_back(rid);
+    }
+
+    // Crash: the log reaches the disk, the dirty pages do not.
+    log_manager->StopFlushThread();
+    table.reset();
+    bpm.reset();
+    disk_manager->ShutDown();
+    delete loser_a;
+    delete loser_b;
+  }
+
+  // Scenario: the big tuple only fits back once A's inserts are rolled back, although A is the older transaction.
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager.get(), LRUK_REPLACER_K, log_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), nullptr, first_page_id);
+  LogRecovery log_recovery(disk_manager.get(), bpm.get(), log_manager.get(), 4);
+  log_recovery.Redo();
+  log_recovery.Undo();
+
+  Tuple tuple;
+  auto txn = std::make_unique<Transaction>(0);
+  ASSERT_TRUE(table->GetTuple(big_rid, &tuple, txn.get()));
+  EXPECT_EQ(make_tuple(0, 1000).GetLength(), tuple.GetLength());
+  for (const auto &rid : filler_rids) {
+    ASSERT_TRUE(table->GetTuple(rid, &tuple, txn.get()));
+  }
+  for (const auto &rid : loser_rids) {
+    ASSERT_FALSE(table->GetTuple(rid, &tuple, txn.get()));
+  }
+
+  table.reset();
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+}
+
+// NOLINTNEXTLINE
+TEST(LogRecoveryTest, FuzzyCheckpointTest) {
+  const std::string db_name = "log_recovery_checkpoint_test.db";
+  const std::string log_name = "log_recovery_checkpoint_test.log";
+  const std::string master_name = "log_recovery_checkpoint_test.ckpt";
+  const int num_tuples = 1000;
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+  remove(master_name.c_str());
+
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}});
+  std::vector<RID> flushed_rids;
+  std::vector<RID> dirty_rids;
+  std::vector<RID> loser_rids;
+  page_id_t first_page_id;
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+    auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+    auto lock_manager = std::make_unique<LockManager>();
+    auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), log_manager.get());
+    CheckpointManager checkpoint_manager(txn_manager.get(), log_manager.get(), bpm.get());
+    log_manager->RunFlushThread();
+
+    // These tuples are on disk before the checkpoint, so recovery never needs their log records.
+    Transaction *txn = txn_manager->Begin();
+    auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), log_manager.get(), txn);
+    first_page_id = table->GetFirstPageId();
+    for (int i = 0; i < num_tuples; i++) {
+      RID rid;
+      EXPECT_TRUE(table->InsertTuple(MakeTuple(schema, i, i), &rid, txn));
+      flushed_rids.push_back(rid);
+    }
+    txn_manager->Commit(txn);
+    delete txn;
+    bpm->FlushAllPages();
+
+    // A loser is running and committed tuples are only in the buffer pool while the checkpoint is taken.
+    Transaction *loser = txn_manager->Begin();
+    txn = txn_manager->Begin();
+    for (int i = 0; i < num_tuples; i++) {
+      RID rid;
+      EXPECT_TRUE(table->InsertTuple(MakeTuple(schema, num_tuples + i, i), &rid, txn));
+      dirty_rids.push_back(rid);
+    }
+    txn_manager->Commit(txn);
+    delete txn;
+    for (int i = 0; i < num_tuples / 10; i++) {
+      RID rid;
+      EXPECT_TRUE(table->InsertTuple(MakeTuple(schema, 2 * num_tuples + i, 0), &rid, loser));
+      loser_rids.push_back(rid);
+    }
+    checkpoint_manager.BeginCheckpoint();
+    checkpoint_manager.EndCheckpoint();
+
+    // Work after the checkpoint, by the loser and by a committed transaction.
+    for (int i = 0; i < num_tuples; i += 7) {
+      EXPECT_TRUE(table->UpdateTuple(MakeTuple(schema, i, -i), flushed_rids[i], loser));
+    }
+    txn = txn_manager->Begin();
+    for (int i = 0; i < num_tuples; i += 5) {
+      EXPECT_TRUE(table->UpdateTuple(MakeTuple(schema, num_tuples + i, -i), dirty_rids[i], txn));
+    }
+    txn_manager->Commit(txn);
+    delete txn;
+
+    // Crash: the log reaches the disk, the dirty pages do not.
+    log_manager->StopFlushThread();
+    table.reset();
+    bpm.reset();
+    disk_manager->ShutDown();
+    delete loser;
+  }
+
+  // Recovery must not read the log before the checkpoint's scan offset: wipe it.
+  int64_t scan_offset;
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    int64_t master_offset;
+    lsn_t checkpoint_lsn;
+    ASSERT_TRUE(disk_manager->ReadMasterRecord(&master_offset, &checkpoint_lsn));
+    LogRecovery log_recovery(disk_manager.get(), nullptr, nullptr);
+    LogRecord end_record;
+    std::vector<char> data(LOG_BUFFER_SIZE);
+    do {
+      ASSERT_TRUE(disk_manager->ReadLog(data.data(), LOG_BUFFER_SIZE, master_offset));
+      ASSERT_TRUE(log_recovery.DeserializeLogRecord(data.data(), &end_record));
+      master_offset += end_record.GetSize();
+    } while (end_record.GetLSN() != checkpoint_lsn);
+    ASSERT_EQ(LogRecordType::END_CHECKPOINT, end_record.GetLogRecordType());
+    ASSERT_FALSE(end_record.GetActiveTxns().empty());
+    ASSERT_FALSE(end_record.GetDirtyPages().empty());
+    scan_offset = end_record.GetScanOffset();
+    disk_manager->ShutDown();
+  }
+  ASSERT_GT(scan_offset, 0);
+  {
+    std::fstream log(log_name, std::ios::binary | std::ios::in | std::ios::out);
+    std::vector<char> zeros(scan_offset, 0);
+    log.write(zeros.data(), scan_offset);
+  }
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get(), LRUK_REPLACER_K, log_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), nullptr, first_page_id);
+  LogRecovery log_recovery(disk_manager.get(), bpm.get(), log_manager.get(), 4);
+  log_recovery.Redo();
+  log_recovery.Undo();
+
+  Tuple tuple;
+  auto txn = std::make_unique<Transaction>(0);
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(table->GetTuple(flushed_rids[i], &tuple, txn.get())) << i;
+    ASSERT_EQ(i, tuple.GetValue(&schema, 1).GetAs<int32_t>());
+    ASSERT_TRUE(table->GetTuple(dirty_rids[i], &tuple, txn.get())) << i;
+    ASSERT_EQ(num_tuples + i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    ASSERT_EQ(i % 5 == 0 ? -i : i, tuple.GetValue(&schema, 1).GetAs<int32_t>());
+  }
+  for (const auto &rid : loser_rids) {
+    ASSERT_FALSE(table->GetTuple(rid, &tuple, txn.get()));
+  }
+
+  table.reset();
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+  remove(master_name.c_str());
+}
+
+static auto CountLogFiles(const std::string &log_name) -> int {
+  struct stat stat_buf;
+  int count = stat(log_name.c_str(), &stat_buf) == 0 ? 1 : 0;
+  for (int i = 0; i < 100; i++) {
+    for (const auto &name : {log_name + "." + std::to_string(i), log_name + ".spare." + std::to_string(i)}) {
+      count += stat(name.c_str(), &stat_buf) == 0 ? 1 : 0;
+    }
+  }
+  return count;
+}
+
+static void RemoveLogFiles(const std::string &log_name) {
+  remove(log_name.c_str());
+  for (int i = 0; i < 100; i++) {
+    remove((log_name + "." + std::to_string(i)).c_str());
+    remove((log_name + ".spare." + std::to_string(i)).c_str());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(LogRecoveryTest, LogSegmentTest) {
+  const std::string db_name = "log_recovery_segment_test.db";
+  const std::string log_name = "log_recovery_segment_test.log";
+  const std::string master_name = "log_recovery_segment_test.ckpt";
+  const int64_t segment_size = 64 * 1024;
+  const int num_rounds = 20;
+  const int tuples_per_round = 200;
+  remove(db_name.c_str());
+  remove(master_name.c_str());
+  RemoveLogFiles(log_name);
+
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}});
+  std::vector<RID> rids;
+  std::vector<int32_t> values;
+  std::vector<RID> loser_rids;
+  page_id_t first_page_id;
+  lsn_t next_lsn;
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name, false, segment_size);
+    auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+    auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+    auto lock_manager = std::make_unique<LockManager>();
+    auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), log_manager.get());
+    CheckpointManager checkpoint_manager(txn_manager.get(), log_manager.get(), bpm.get());
+    log_manager->RunFlushThread();
+
+    Transaction *txn = txn_manager->Begin();
+    auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), log_manager.get(), txn);
+    txn_manager->Commit(txn);
+    delete txn;
+    first_page_id = table->GetFirstPageId();
+    for (int round = 0; round < num_rounds; round++) {
+      txn = txn_manager->Begin();
+      for (int i = 0; i < tuples_per_round; i++) {
+        RID rid;
+        EXPECT_TRUE(table->InsertTuple(MakeTuple(schema, static_cast<int32_t>(rids.size()), round), &rid, txn));
+        rids.push_back(rid);
+        values.push_back(round);
+      }
+      for (size_t i = round; i < rids.size(); i += 11) {
+        EXPECT_TRUE(table->UpdateTuple(MakeTuple(schema, static_cast<int32_t>(i), -round), rids[i], txn));
+        values[i] = -round;
+      }
+      txn_manager->Commit(txn);
+      delete txn;
+      // The pages reach the disk between checkpoints, so that the redo point moves on with the log.
+      bpm->FlushAllPages();
+      checkpoint_manager.BeginCheckpoint();
+      checkpoint_manager.EndCheckpoint();
+    }
+    // The log outgrew several segments, but only the ones after the redo point and the spares are left.
+    EXPECT_GT(disk_manager->GetLogStart(), 2 * segment_size);
+    EXPECT_LE(CountLogFiles(log_name), 2 + LOG_MAX_SPARE_SEGMENTS);
+
+    Transaction *loser = txn_manager->Begin();
+    for (int i = 0; i < tuples_per_round; i++) {
+      RID rid;
+      EXPECT_TRUE(table->InsertTuple(MakeTuple(schema, -1, 0), &rid, loser));
+      loser_rids.push_back(rid);
+    }
+    for (size_t i = 0; i < rids.size(); i += 13) {
+      EXPECT_TRUE(table->UpdateTuple(MakeTuple(schema, static_cast<int32_t>(i), 12345), rids[i], loser));
+    }
+
+    // Crash: the log reaches the disk, the dirty pages do not.
+    log_manager->StopFlushThread();
+    next_lsn = log_manager->GetNextLSN();
+    table.reset();
+    bpm.reset();
+    disk_manager->ShutDown();
+    delete loser;
+  }
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name, false, segment_size);
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get(), LRUK_REPLACER_K, log_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), nullptr, first_page_id);
+  LogRecovery log_recovery(disk_manager.get(), bpm.get(), log_manager.get(), 4);
+  log_recovery.Redo();
+  log_recovery.Undo();
+
+  Tuple tuple;
+  auto txn = std::make_unique<Transaction>(0);
+  for (size_t i = 0; i < rids.size(); i++) {
+    ASSERT_TRUE(table->GetTuple(rids[i], &tuple, txn.get())) << i;
+    ASSERT_EQ(static_cast<int32_t>(i), tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    ASSERT_EQ(values[i], tuple.GetValue(&schema, 1).GetAs<int32_t>());
+  }
+  for (const auto &rid : loser_rids) {
+    ASSERT_FALSE(table->GetTuple(rid, &tuple, txn.get()));
+  }
+
+  // A restarted log continues after the last record, with the next LSN: after the CLRs and ABORT record of undo.
+  EXPECT_LT(next_lsn, log_manager->GetNextLSN());
+  {
+    LogManager restarted(disk_manager.get());
+    EXPECT_EQ(log_manager->GetNextLSN(), restarted.GetNextLSN());
+    EXPECT_EQ(log_manager->GetNextLSN() - 1, restarted.GetPersistentLSN());
+  }
+
+  table.reset();
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(master_name.c_str());
+  RemoveLogFiles(log_name);
+}
+
+// NOLINTNEXTLINE
+TEST(LogRecoveryTest, DeltaUpdateTest) {
+  const std::string db_name = "log_recovery_delta_update_test.db";
+  const std::string log_name = "log_recovery_delta_update_test.log";
+  const int num_tuples = 1000;
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"name", TypeId::VARCHAR, 32}, Column{"b", TypeId::INTEGER}});
+  auto make_tuple = [&](int32_t a, const std::string &name, int32_t b) {
+    std::vector<Value> values{Value(TypeId::INTEGER, a), Value(TypeId::VARCHAR, name), Value(TypeId::INTEGER, b)};
+    return Tuple(values, &schema);
+  };
+
+  // An update of one integer logs the bytes that changed, not both tuples.
+  {
+    Tuple old_tuple = make_tuple(1, "a tuple with a long name", 100);
+    Tuple new_tuple = make_tuple(1, "a tuple with a long name", 101);
+    LogRecord full(0, INVALID_LSN, LogRecordType::UPDATE, RID(0, 0), old_tuple, new_tuple);
+    LogRecord delta(0, INVALID_LSN, RID(0, 0), old_tuple, new_tuple);
+    EXPECT_EQ(1U, delta.GetOldDelta().size());
+    EXPECT_EQ(1U, delta.GetNewDelta().size());
+    EXPECT_LT(delta.GetSize(), full.GetSize());
+  }
+
+  std::vector<RID> rids;
+  std::vector<std::string> names;
+  std::vector<int32_t> values;
+  page_id_t first_page_id;
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager.get());
+    auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+    auto lock_manager = std::make_unique<LockManager>();
+    auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), log_manager.get());
+    log_manager->RunFlushThread();
+
+    Transaction *txn = txn_manager->Begin();
+    auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), log_manager.get(), txn);
+    for (int i = 0; i < num_tuples; i++) {
+      RID rid;
+      names.push_back(fmt::format("tuple {:04} with a long name", i));
+      values.push_back(i);
+      EXPECT_TRUE(table->InsertTuple(make_tuple(i, names[i], i), &rid, txn));
+      rids.push_back(rid);
+    }
+    txn_manager->Commit(txn);
+    delete txn;
+
+    // Committed updates that change an integer in place, and that shorten the name and so move the rest of the tuple.
+    txn = txn_manager->Begin();
+    for (int i = 0; i < num_tuples; i += 2) {
+      values[i] = i * 10;
+      EXPECT_TRUE(table->UpdateTuple(make_tuple(i, names[i], values[i]), rids[i], txn));
+    }
+    for (int i = 0; i < num_tuples; i += 3) {
+      names[i] = fmt::format("t{}", i);
+      EXPECT_TRUE(table->UpdateTuple(make_tuple(i, names[i], values[i]), rids[i], txn));
+    }
+    txn_manager->Commit(txn);
+    delete txn;
+
+    // A loser that lengthens names again and changes integers, twice on the same tuples.
+    Transaction *loser = txn_manager->Begin();
+    for (int i = 0; i < num_tuples; i += 5) {
+      EXPECT_TRUE(table->UpdateTuple(make_tuple(i, fmt::format("loser {:04} long name", i), -1), rids[i], loser));
+      EXPECT_TRUE(table->UpdateTuple(make_tuple(i, "l", -2), rids[i], loser));
+    }
+
+    // Crash: the log reaches the disk, the dirty pages do not.
+    first_page_id = table->GetFirstPageId();
+    log_manager->StopFlushThread();
+    table.reset();
+    bpm.reset();
+    disk_manager->ShutDown();
+    delete loser;
+  }
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto bpm = std::make_unique<BufferPoolManager>(16, disk_manager.get(), LRUK_REPLACER_K, log_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto table = std::make_unique<TableHeap>(bpm.get(), lock_manager.get(), nullptr, first_page_id);
+  LogRecovery log_recovery(disk_manager.get(), bpm.get(), log_manager.get(), 4);
+  log_recovery.Redo();
+  log_recovery.Undo();
+
+  Tuple tuple;
+  auto txn = std::make_unique<Transaction>(0);
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_TRUE(table->GetTuple(rids[i], &tuple, txn.get())) << i;
+    ASSERT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    ASSERT_EQ(names[i], tuple.GetValue(&schema, 1).ToString());
+    ASSERT_EQ(values[i], tuple.GetValue(&schema, 2).GetAs<int32_t>());
+  }
+
+  table.reset();
+  bpm.reset();
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+}
+
+// Recovery time for a log of about a million records, by number of workers.
+// NOLINTNEXTLINE
+TEST(LogRecoveryTest, DISABLED_RecoveryBenchmark) {
+  const std::string db_name = "log_recovery_benchmark.db";
+  const std::string log_name = "log_recovery_benchmark.log";
+  const int num_records = 1000000;
+  const int tuples_per_page = 100;
+  const int records_per_txn = 1000;
+  const int loser_records = 10000;
+  const int num_pages = num_records / (tuples_per_page + 1) + 1;
+  const size_t pool_size = num_pages + 64;
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+
+  // Write the log of a crashed run: table pages filled by committed transactions, then one loser, none of the pages
+  // on disk.
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}});
+  {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    disk_manager->AllocateExtent(0, num_pages);
+    LogManager log_manager(disk_manager.get());
+    txn_id_t txn_id = 0;
+    lsn_t prev_lsn = INVALID_LSN;
+    int records = 0;
+    auto append = [&](LogRecord *log_record) {
+      prev_lsn = log_manager.AppendLogRecord(log_record);
+      records++;
+    };
+    for (page_id_t page_id = 0; records < num_records; page_id++) {
+      for (int slot = -1; slot < tuples_per_page; slot++) {
+        if (records % records_per_txn == 0) {
+          if (txn_id > 0 && records < num_records - loser_records) {
+            LogRecord commit(txn_id, prev_lsn, LogRecordType::COMMIT);
+            append(&commit);
+          }
+          txn_id++;
+          prev_lsn = INVALID_LSN;
+          LogRecord begin(txn_id, prev_lsn, LogRecordType::BEGIN);
+          append(&begin);
+        }
+        if (slot < 0) {
+          LogRecord new_page(txn_id, prev_lsn, LogRecordType::NEWPAGE, page_id - 1, page_id);
+          append(&new_page);
+        } else {
+          LogRecord insert(txn_id, prev_lsn, LogRecordType::INSERT, RID(page_id, slot),
+                           MakeTuple(schema, page_id, slot));
+          append(&insert);
+        }
+      }
+    }
+    log_manager.WaitUntilPersistent(prev_lsn);
+    disk_manager->ShutDown();
+  }
+
+  // Recovery logs its undo and flushes the recovered pages: keep the crashed files for every run to start from.
+  CopyFile(db_name, db_name + ".crashed");
+  CopyFile(log_name, log_name + ".crashed");
+  for (size_t workers : {1, 2, 4, 8}) {
+    CopyFile(db_name + ".crashed", db_name);
+    CopyFile(log_name + ".crashed", log_name);
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+    auto bpm = std::make_unique<BufferPoolManager>(pool_size, disk_manager.get(), LRUK_REPLACER_K, log_manager.get());
+    LogRecovery log_recovery(disk_manager.get(), bpm.get(), log_manager.get(), workers);
+    auto start = std::chrono::steady_clock::now();
+    log_recovery.Redo();
+    auto redo_done = std::chrono::steady_clock::now();
+    log_recovery.Undo();
+    auto undo_done = std::chrono::steady_clock::now();
+    fmt::print("records={} workers={} redo={}ms undo={}ms\n", num_records, workers,
+               std::chrono::duration_cast<std::chrono::milliseconds>(redo_done - start).count(),
+               std::chrono::duration_cast<std::chrono::milliseconds>(undo_done - redo_done).count());
+    bpm.reset();
+    disk_manager->ShutDown();
+  }
+
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+  remove((db_name + ".crashed").c_str());
+  remove((log_name + ".crashed").c_str());
+}
+
+}  // namespace bustub
@@ -0,0 +1,286 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/catalog.h"
+#include "fmt/core.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using Tree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using Entries = std::vector<std::pair<GenericKey<8>, RID>>;
+
+static auto MakeEntries(const std::vector<int64_t> &keys) -> Entries {
+  Entries entries;
+  for (auto key : keys) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    entries.emplace_back(index_key, RID(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF));
+  }
+  return entries;
+}
+
+static auto Lookup(Tree *tree, int64_t key) -> std::vector<RID> {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  std::vector<RID> rids;
+  tree->GetValue(index_key, &rids);
+  return rids;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, BulkLoadTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPageGuarded(&header_page_id);
+  Tree tree("foo_pk", header_page_id, bpm.get(), comparator, 5, 4);
+
+  // Nothing to load leaves the tree empty.
+  ASSERT_TRUE(tree.BulkLoad({}, 0.8));
+  ASSERT_TRUE(tree.IsEmpty());
+
+  const int64_t num_keys = 5000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    keys.push_back(key);
+  }
+  // The first of several pairs with the same key is kept.
+  Entries entries = MakeEntries(keys);
+  for (int64_t key = 1; key <= num_keys; key += 10) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    entries.emplace_back(index_key, RID(-1, 0));
+  }
+  std::stable_sort(entries.begin(), entries.end(),
+                   [&](const auto &lhs, const auto &rhs) { return comparator(lhs.first, rhs.first) < 0; });
+  ASSERT_TRUE(tree.BulkLoad(entries, 0.8));
+  ASSERT_FALSE(tree.IsEmpty());
+  ASSERT_FALSE(tree.BulkLoad(entries, 0.8));
+
+  for (int64_t key = 1; key <= num_keys; key++) {
+    auto rids = Lookup(&tree, key);
+    ASSERT_EQ(1U, rids.size()) << key;
+    ASSERT_EQ(key, rids[0].GetSlotNum());
+  }
+  int64_t expected = 1;
+  for (auto it = tree.Begin(); it != tree.End(); ++it) {
+    ASSERT_EQ(expected++, (*it).second.GetSlotNum());
+  }
+  ASSERT_EQ(num_keys + 1, expected);
+
+  // The loaded tree takes inserts and removes like any other.
+  auto rng = std::default_random_engine{};
+  std::vector<int64_t> more_keys;
+  for (int64_t key = num_keys + 1; key <= 2 * num_keys; key++) {
+    more_keys.push_back(key);
+  }
+  std::shuffle(more_keys.begin(), more_keys.end(), rng);
+  for (const auto &[key, rid] : MakeEntries(more_keys)) {
+    ASSERT_TRUE(tree.Insert(key, rid));
+  }
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (auto key : keys) {
+    if (key % 3 != 0) {
+      GenericKey<8> index_key;
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, nullptr);
+    }
+  }
+  for (int64_t key = 1; key <= 2 * num_keys; key++) {
+    ASSERT_EQ(key > num_keys || key % 3 == 0 ? 1U : 0U, Lookup(&tree, key).size()) << key;
+  }
+  GenericKey<8> start_key;
+  start_key.SetFromInteger(num_keys / 2);
+  expected = num_keys / 2;
+  for (auto it = tree.Begin(start_key); it != tree.End(); ++it) {
+    while (expected <= num_keys && expected % 3 != 0) {
+      expected++;
+    }
+    ASSERT_EQ(expected++, (*it).second.GetSlotNum());
+  }
+  ASSERT_EQ(2 * num_keys + 1, expected);
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, OutOfFramesTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  const size_t buffer_pool_size = 10;
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPageGuarded(&header_page_id);
+  Tree tree("foo_pk", header_page_id, bpm.get(), comparator, 5, 4);
+
+  // Scenario: With every frame but one for the header and one for a leaf pinned, the load fails at the second leaf
+  // and leaves the tree empty.
+  std::vector<page_id_t> pinned_page_ids(buffer_pool_size - 2);
+  for (auto &page_id : pinned_page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 1000; key++) {
+    keys.push_back(key);
+  }
+  Entries entries = MakeEntries(keys);
+  ASSERT_FALSE(tree.BulkLoad(entries, 0.8));
+  ASSERT_TRUE(tree.IsEmpty());
+
+  // Scenario: Once the frames are let go, the load goes through.
+  for (auto page_id : pinned_page_ids) {
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  ASSERT_TRUE(tree.BulkLoad(entries, 0.8));
+  for (auto key : keys) {
+    ASSERT_EQ(1U, Lookup(&tree, key).size()) << key;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, CreateIndexTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  auto txn = std::make_unique<Transaction>(0);
+
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}});
+  auto *table_info = catalog->CreateTable(txn.get(), "t", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  const int num_rows = 10000;
+  std::vector<RID> rids(num_rows);
+  std::vector<int32_t> keys(num_rows);
+  for (int i = 0; i < num_rows; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::default_random_engine{});
+  for (int i = 0; i < num_rows; i++) {
+    std::vector<Value> values{Value(TypeId::INTEGER, keys[i]), Value(TypeId::INTEGER, i)};
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rids[keys[i]], txn.get()));
+  }
+
+  Schema key_schema({Column{"a", TypeId::INTEGER}});
+  auto *index_info = catalog->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+      txn.get(), "t_a", "t", schema, key_schema, {0}, TWO_INTEGER_SIZE, IntegerHashFunctionType{});
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, index_info);
+
+  for (int32_t key = 0; key < num_rows; key++) {
+    std::vector<RID> result;
+    index_info->index_->ScanKey(Tuple({Value(TypeId::INTEGER, key)}, &key_schema), &result, txn.get());
+    ASSERT_EQ(1U, result.size()) << key;
+    ASSERT_EQ(rids[key], result[0]);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, CreateIndexNullKeysTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  auto catalog = std::make_unique<Catalog>(bpm.get(), nullptr, nullptr);
+  auto txn = std::make_unique<Transaction>(0);
+
+  // Every third row has a NULL key, which compares equal to any key: those rows are left out of the index, and the
+  // others still have to come out in order.
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}});
+  auto *table_info = catalog->CreateTable(txn.get(), "t", schema);
+  ASSERT_NE(Catalog::NULL_TABLE_INFO, table_info);
+  const int num_rows = 3000;
+  std::vector<int32_t> keys(num_rows);
+  for (int i = 0; i < num_rows; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::default_random_engine{});
+  std::vector<RID> rids(num_rows);
+  for (int i = 0; i < num_rows; i++) {
+    Value key = i % 3 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : Value(TypeId::INTEGER, keys[i]);
+    std::vector<Value> values{key, Value(TypeId::INTEGER, i)};
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rids[keys[i]], txn.get()));
+  }
+
+  Schema key_schema({Column{"a", TypeId::INTEGER}});
+  auto *index_info = catalog->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
+      txn.get(), "t_a", "t", schema, key_schema, {0}, TWO_INTEGER_SIZE, IntegerHashFunctionType{});
+  ASSERT_NE(Catalog::NULL_INDEX_INFO, index_info);
+
+  auto *index = dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info->index_.get());
+  ASSERT_NE(nullptr, index);
+  size_t num_entries = 0;
+  int64_t last_key = -1;
+  for (auto it = index->GetBeginIterator(); !it.IsEnd(); ++it) {
+    auto key = (*it).first.ToValue(&key_schema, 0);
+    ASSERT_FALSE(key.IsNull());
+    ASSERT_LT(last_key, key.GetAs<int32_t>());
+    last_key = key.GetAs<int32_t>();
+    ASSERT_EQ(rids[last_key], (*it).second);
+    num_entries++;
+  }
+  ASSERT_EQ(static_cast<size_t>(num_rows - (num_rows + 2) / 3), num_entries);
+}
+
+// CREATE INDEX on a million rows: inserting the keys one by one against loading them bottom-up.
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, DISABLED_BulkLoadBenchmark) {
+  const std::string db_name = "b_plus_tree_bulk_load_benchmark.db";
+  const std::string log_name = "b_plus_tree_bulk_load_benchmark.log";
+  const int64_t num_keys = 1000000;
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < num_keys; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::default_random_engine{});
+
+  for (bool bulk_load : {false, true}) {
+    remove(db_name.c_str());
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto bpm = std::make_unique<BufferPoolManager>(256, disk_manager.get());
+    page_id_t header_page_id;
+    bpm->NewPageGuarded(&header_page_id);
+    Tree tree("foo_pk", header_page_id, bpm.get(), comparator);
+
+    auto start = std::chrono::steady_clock::now();
+    Entries entries = MakeEntries(keys);
+    if (bulk_load) {
+      std::sort(entries.begin(), entries.end(),
+                [&](const auto &lhs, const auto &rhs) { return comparator(lhs.first, rhs.first) < 0; });
+      tree.BulkLoad(entries);
+    } else {
+      for (const auto &[key, rid] : entries) {
+        tree.Insert(key, rid);
+      }
+    }
+    bpm->FlushAllPages();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    fmt::print("{:<10} {:>8} ms  page writes={}\n", bulk_load ? "bulk load" : "insert", elapsed.count(),
+               disk_manager->GetNumWrites());
+    bpm.reset();
+    disk_manager->ShutDown();
+  }
+  remove(db_name.c_str());
+  remove(log_name.c_str());
+}
+
+}  // namespace bustub
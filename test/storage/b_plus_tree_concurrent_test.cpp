@@ -122,7 +122,7 @@ void LookupHelper(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree, con
   delete transaction;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
+TEST(BPlusTreeConcurrentTest, InsertTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -170,7 +170,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest2) {
+TEST(BPlusTreeConcurrentTest, InsertTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -217,7 +217,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest2) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest1) {
+TEST(BPlusTreeConcurrentTest, DeleteTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -256,7 +256,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
+TEST(BPlusTreeConcurrentTest, DeleteTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -295,7 +295,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_DeleteTest2) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_MixTest1) {
+TEST(BPlusTreeConcurrentTest, MixTest1) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -336,7 +336,7 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest1) {
   delete bpm;
 }
 
-TEST(BPlusTreeConcurrentTest, DISABLED_MixTest2) {
+TEST(BPlusTreeConcurrentTest, MixTest2) {
   // create KeyComparator and index schema
   auto key_schema = ParseCreateStatement("a bigint");
   GenericComparator<8> comparator(key_schema.get());
@@ -402,4 +402,48 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest2) {
   delete bpm;
 }
 
+// Small pages, so that inserts and removes fall back from latching only the leaf to splits and merges all the time.
+TEST(BPlusTreeConcurrentTest, MixTestBothLatchingModes) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (bool optimistic : {false, true}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+    page_id_t page_id;
+    auto header_guard = bpm->NewPageGuarded(&page_id);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", page_id, bpm.get(), comparator, 4, 5,
+                                                             optimistic);
+
+    std::vector<int64_t> preserved_keys;
+    std::vector<int64_t> dynamic_keys;
+    for (int64_t key = 1; key <= 2000; key++) {
+      (key % 4 == 0 ? preserved_keys : dynamic_keys).push_back(key);
+    }
+    InsertHelper(&tree, preserved_keys);
+
+    // Every thread inserts its share of the dynamic keys and removes it again, while others look up the rest.
+    const int num_writers = 4;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_writers; i++) {
+      threads.emplace_back([&, i] {
+        InsertHelperSplit(&tree, dynamic_keys, num_writers, i);
+        DeleteHelperSplit(&tree, dynamic_keys, num_writers, i);
+      });
+    }
+    for (int i = 0; i < 2; i++) {
+      threads.emplace_back([&, i] { LookupHelper(&tree, preserved_keys, i); });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    int64_t size = 0;
+    for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+      ASSERT_EQ(preserved_keys[size++], (*iter).first.ToString());
+    }
+    ASSERT_EQ(preserved_keys.size(), size);
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search_test.cpp
+//
+// Identification: test/storage/b_plus_tree_key_search_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/rid.h"
+#include "gtest/gtest.h"
+#include "storage/page/b_plus_tree_key_search.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+// A key of a single integer column holds the integer at its start, like GenericKey::SetFromKey() leaves it.
+template <size_t KeySize>
+static auto MakeKey(int64_t value, size_t key_size) -> GenericKey<KeySize> {
+  GenericKey<KeySize> key;
+  memset(key.data_, 0, KeySize);
+  memcpy(key.data_, &value, key_size);
+  return key;
+}
+
+// The integer search must find the same bounds as the comparator, for every key of the page and around them.
+template <size_t KeySize, typename ValueType>
+static void CheckIntegerSearch(const std::string &type, size_t key_size) {
+  auto key_schema = ParseCreateStatement("a " + type);
+  GenericComparator<KeySize> comparator(key_schema.get());
+  ASSERT_EQ(key_size, comparator.GetIntegerKeySize()) << type;
+
+  // The least integer of the type stands for NULL, which the comparator takes as equal to any key.
+  int64_t max_value = key_size == 8 ? std::numeric_limits<int64_t>::max() : (int64_t{1} << (8 * key_size - 1)) - 1;
+  int64_t min_value = -max_value;
+  std::mt19937_64 rng(key_size);
+  std::uniform_int_distribution<int64_t> dist(min_value, max_value);
+
+  using Search = KeySearch<GenericKey<KeySize>, ValueType, GenericComparator<KeySize>>;
+  for (int size : {0, 1, 7, 8, 33, 100, 255}) {
+    std::set<int64_t> values{min_value, max_value};
+    while (values.size() < static_cast<size_t>(size)) {
+      values.insert(size < 10 ? dist(rng) % 100 : dist(rng));
+    }
+    std::vector<int64_t> sorted(values.begin(), values.end());
+    sorted.resize(size);
+    std::vector<std::pair<GenericKey<KeySize>, ValueType>> entries;
+    for (auto value : sorted) {
+      entries.emplace_back(MakeKey<KeySize>(value, key_size), ValueType{});
+    }
+
+    std::vector<int64_t> probes{min_value, max_value, 0, -1, 1};
+    for (auto value : sorted) {
+      probes.push_back(value);
+      probes.push_back(std::max(value, min_value + 1) - 1);
+      probes.push_back(std::min(value, max_value - 1) + 1);
+    }
+    for (auto probe : probes) {
+      auto key = MakeKey<KeySize>(probe, key_size);
+      for (bool upper : {false, true}) {
+        for (int begin : {0, std::min(1, size)}) {
+          ASSERT_EQ(ComparatorKeyBound(entries.data(), begin, size, key, comparator, upper),
+                    Search::Bound(entries.data(), begin, size, key, comparator, upper))
+              << type << " size=" << size << " probe=" << probe << " upper=" << upper << " begin=" << begin;
+        }
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeySearchTest, IntegerKeysTest) {
+  // Leaf pages pair keys with RIDs, internal pages with page ids: the keys come at different strides.
+  CheckIntegerSearch<4, RID>("tinyint", 1);
+  CheckIntegerSearch<4, page_id_t>("smallint", 2);
+  CheckIntegerSearch<4, RID>("integer", 4);
+  CheckIntegerSearch<8, page_id_t>("integer", 4);
+  CheckIntegerSearch<8, RID>("bigint", 8);
+  CheckIntegerSearch<16, page_id_t>("bigint", 8);
+}
+
+// A NULL probe, or a page starting with a NULL key, must be searched the comparator's way, for which NULL is equal to
+// any key: the tree checks the entry it finds with the comparator.
+template <size_t KeySize, typename ValueType>
+static void CheckNullSearch(const std::string &type, size_t key_size) {
+  auto key_schema = ParseCreateStatement("a " + type);
+  GenericComparator<KeySize> comparator(key_schema.get());
+  int64_t null_value = IntegerKeyNull(key_size);
+
+  using Search = KeySearch<GenericKey<KeySize>, ValueType, GenericComparator<KeySize>>;
+  for (bool with_null : {false, true}) {
+    std::vector<std::pair<GenericKey<KeySize>, ValueType>> entries;
+    if (with_null) {
+      entries.emplace_back(MakeKey<KeySize>(null_value, key_size), ValueType{});
+    }
+    for (int64_t value = -30; value <= 30; value += 3) {
+      entries.emplace_back(MakeKey<KeySize>(value, key_size), ValueType{});
+    }
+    int size = static_cast<int>(entries.size());
+    for (int64_t probe : {null_value, int64_t{-30}, int64_t{-1}, int64_t{0}, int64_t{7}, int64_t{30}}) {
+      auto key = MakeKey<KeySize>(probe, key_size);
+      for (bool upper : {false, true}) {
+        for (int begin : {0, 1}) {
+          ASSERT_EQ(ComparatorKeyBound(entries.data(), begin, size, key, comparator, upper),
+                    Search::Bound(entries.data(), begin, size, key, comparator, upper))
+              << type << " with_null=" << with_null << " probe=" << probe << " upper=" << upper << " begin=" << begin;
+        }
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeySearchTest, NullKeysTest) {
+  CheckNullSearch<4, RID>("tinyint", 1);
+  CheckNullSearch<4, page_id_t>("smallint", 2);
+  CheckNullSearch<8, RID>("integer", 4);
+  CheckNullSearch<8, page_id_t>("bigint", 8);
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeySearchTest, OtherKeysTest) {
+  // Anything but a single integer column keeps being searched with the comparator.
+  for (const auto *statement : {"a bigint,b bigint", "a varchar(8)", "a double", "a boolean"}) {
+    auto key_schema = ParseCreateStatement(statement);
+    GenericComparator<16> comparator(key_schema.get());
+    ASSERT_EQ(0U, comparator.GetIntegerKeySize()) << statement;
+  }
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<4> comparator(key_schema.get());
+  ASSERT_EQ(0U, comparator.GetIntegerKeySize());
+}
+
+}  // namespace bustub
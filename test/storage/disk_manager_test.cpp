@@ -10,7 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sys/stat.h>
 #include <cstring>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
@@ -55,6 +59,94 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ConcurrentReadWritePageTest) {
+  const int num_threads = 8;
+  const int pages_per_thread = 64;
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&dm, tid] {
+      char data[BUSTUB_PAGE_SIZE] = {0};
+      char buf[BUSTUB_PAGE_SIZE] = {0};
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id = i * num_threads + tid;
+        std::snprintf(data, sizeof(data), "page %d", page_id);
+        dm.WritePage(page_id, data);
+        dm.ReadPage(page_id, buf);
+        EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * pages_per_thread, dm.GetNumWrites());
+
+  // Scenario: reading past the end of the file yields a zeroed page.
+  char buf[BUSTUB_PAGE_SIZE];
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(num_threads * pages_per_thread, buf);
+  EXPECT_EQ(0, buf[0]);
+  EXPECT_EQ(0, buf[BUSTUB_PAGE_SIZE - 1]);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, WritePagesTest) {
+  const int num_pages = 100;
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+
+  // Scenario: a vectored write past the end of the file lands every page at its place.
+  std::vector<std::vector<char>> data(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<const char *> pages;
+  for (int i = 0; i < num_pages; i++) {
+    std::snprintf(data[i].data(), BUSTUB_PAGE_SIZE, "page %d", i + 10);
+    pages.push_back(data[i].data());
+  }
+  dm.WritePages(10, pages);
+  dm.SyncPages();
+  EXPECT_EQ(num_pages, dm.GetNumWrites());
+
+  char buf[BUSTUB_PAGE_SIZE];
+  for (int i = 0; i < num_pages; i++) {
+    dm.ReadPage(i + 10, buf);
+    EXPECT_EQ(std::memcmp(buf, data[i].data(), sizeof(buf)), 0);
+  }
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(9, buf);
+  EXPECT_EQ(0, buf[0]);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DirectIOTest) {
+  std::string db_file("test.db");
+  {
+    auto dm = DiskManager(db_file, true);
+    // Scenario: unaligned buffers are bounced through an aligned one when O_DIRECT is in effect.
+    std::vector<char> data(BUSTUB_PAGE_SIZE + 1);
+    std::strncpy(data.data() + 1, "A test string.", BUSTUB_PAGE_SIZE);
+    dm.WritePage(3, data.data() + 1);
+    std::vector<char> buf(BUSTUB_PAGE_SIZE + 1);
+    dm.ReadPage(3, buf.data() + 1);
+    EXPECT_EQ(std::memcmp(buf.data() + 1, data.data() + 1, BUSTUB_PAGE_SIZE), 0);
+    dm.ShutDown();
+  }
+
+  // Scenario: the file size is picked up again when the file is reopened.
+  auto dm = DiskManager(db_file);
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  dm.ReadPage(3, buf);
+  EXPECT_STREQ("A test string.", buf);
+  dm.ShutDown();
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
@@ -72,6 +164,70 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
   dm.ShutDown();
 }
 
+static auto FileExists(const std::string &file_name) -> bool {
+  struct stat stat_buf;
+  return stat(file_name.c_str(), &stat_buf) == 0;
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, LogSegmentTest) {
+  const std::string db_file = "log_segment_test.db";
+  const int64_t segment_size = 1000;
+  const int write_size = 300;
+  const std::vector<std::string> files{"log_segment_test.db",      "log_segment_test.log",
+                                       "log_segment_test.log.1",   "log_segment_test.log.2",
+                                       "log_segment_test.log.3",   "log_segment_test.log.4",
+                                       "log_segment_test.log.spare.0", "log_segment_test.log.spare.1"};
+  for (const auto &file : files) {
+    remove(file.c_str());
+  }
+
+  char buffers[2][write_size];
+  int64_t end = 0;
+  {
+    DiskManager dm(db_file, false, segment_size);
+    // Ten writes cross into segment 2, the fourth one straddling segments 0 and 1.
+    for (int i = 0; i < 8; i++) {
+      memset(buffers[i % 2], 'a' + i, write_size);
+      dm.WriteLog(buffers[i % 2], write_size);
+      end += write_size;
+    }
+    EXPECT_TRUE(FileExists("log_segment_test.log.2"));
+    std::vector<char> buf(write_size);
+    ASSERT_TRUE(dm.ReadLog(buf.data(), write_size, 3 * write_size));
+    EXPECT_EQ(std::vector<char>(write_size, 'd'), buf);
+
+    // Segments 0 and 1 lie before the redo point and become spares; they are reused for segments 3 and 4.
+    dm.TruncateLog(2 * segment_size + 10);
+    EXPECT_EQ(2 * segment_size, dm.GetLogStart());
+    EXPECT_FALSE(FileExists("log_segment_test.log"));
+    EXPECT_FALSE(FileExists("log_segment_test.log.1"));
+    EXPECT_TRUE(FileExists("log_segment_test.log.spare.0"));
+    EXPECT_TRUE(FileExists("log_segment_test.log.spare.1"));
+    EXPECT_FALSE(dm.ReadLog(buf.data(), write_size, 0));
+    for (int i = 8; i < 16; i++) {
+      memset(buffers[i % 2], 'a' + i, write_size);
+      dm.WriteLog(buffers[i % 2], write_size);
+      end += write_size;
+    }
+    EXPECT_TRUE(FileExists("log_segment_test.log.4"));
+    EXPECT_FALSE(FileExists("log_segment_test.log.spare.0"));
+    EXPECT_FALSE(FileExists("log_segment_test.log.spare.1"));
+    dm.ShutDown();
+  }
+
+  // The segments are found again on restart.
+  DiskManager dm(db_file, false, segment_size);
+  EXPECT_EQ(2 * segment_size, dm.GetLogStart());
+  std::vector<char> buf(write_size);
+  ASSERT_TRUE(dm.ReadLog(buf.data(), write_size, end - write_size));
+  EXPECT_EQ(std::vector<char>(write_size, 'p'), buf);
+  dm.ShutDown();
+  for (const auto &file : files) {
+    remove(file.c_str());
+  }
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
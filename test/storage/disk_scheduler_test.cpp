@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler_test.cpp
+//
+// Identification: test/storage/disk_scheduler_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <array>
+#include <cstring>
+#include <future>  // NOLINT
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_scheduler.h"
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, ScheduleWriteReadPageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get());
+
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  auto promise1 = disk_scheduler->CreatePromise();
+  auto future1 = promise1.get_future();
+  auto promise2 = disk_scheduler->CreatePromise();
+  auto future2 = promise2.get_future();
+
+  disk_scheduler->Schedule({/*is_write=*/true, data, /*page_id=*/0, std::move(promise1)});
+  disk_scheduler->Schedule({/*is_write=*/false, buf, /*page_id=*/0, std::move(promise2)});
+
+  ASSERT_TRUE(future1.get());
+  ASSERT_TRUE(future2.get());
+  ASSERT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  disk_scheduler = nullptr;  // Call the DiskScheduler destructor to finish all scheduled jobs.
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, ParallelWorkersTest) {
+  const size_t num_workers = 8;
+  const size_t num_pages = 16;
+  const size_t latency_ms = 50;
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get(), num_workers);
+  ASSERT_EQ(num_workers, disk_scheduler->GetNumWorkers());
+
+  std::vector<std::array<char, BUSTUB_PAGE_SIZE>> pages(num_pages);
+  std::vector<std::future<bool>> futures;
+  for (size_t i = 0; i < num_pages; i++) {
+    std::snprintf(pages[i].data(), BUSTUB_PAGE_SIZE, "page %zu", i);
+    auto promise = disk_scheduler->CreatePromise();
+    futures.emplace_back(promise.get_future());
+    disk_scheduler->Schedule({true, pages[i].data(), static_cast<page_id_t>(i), std::move(promise)});
+  }
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  futures.clear();
+
+  // Scenario: with a slow disk, requests for different pages are serviced concurrently by different workers.
+  dm->SetLatency(latency_ms);
+  std::vector<std::array<char, BUSTUB_PAGE_SIZE>> bufs(num_pages);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_pages; i++) {
+    auto promise = disk_scheduler->CreatePromise();
+    futures.emplace_back(promise.get_future());
+    disk_scheduler->Schedule({false, bufs[i].data(), static_cast<page_id_t>(i), std::move(promise)});
+  }
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, std::chrono::milliseconds(latency_ms * num_pages / 2));
+  for (size_t i = 0; i < num_pages; i++) {
+    ASSERT_EQ(0, std::memcmp(bufs[i].data(), pages[i].data(), BUSTUB_PAGE_SIZE));
+  }
+
+  disk_scheduler = nullptr;
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, StridedPageIdsTest) {
+  const size_t num_workers = 4;
+  const size_t page_id_stride = 4;
+  const size_t num_pages = 8;
+  const size_t latency_ms = 50;
+
+  // Scenario: one instance of a parallel buffer pool only has every page_id_stride-th page id, and still gets all of
+  // its workers.
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get(), num_workers, page_id_stride);
+  dm->SetLatency(latency_ms);
+  std::vector<std::array<char, BUSTUB_PAGE_SIZE>> pages(num_pages);
+  std::vector<std::future<bool>> futures;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_pages; i++) {
+    auto promise = disk_scheduler->CreatePromise();
+    futures.emplace_back(promise.get_future());
+    auto page_id = static_cast<page_id_t>(i * page_id_stride + 1);
+    disk_scheduler->Schedule({true, pages[i].data(), page_id, std::move(promise)});
+  }
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, std::chrono::milliseconds(latency_ms * num_pages / 2));
+
+  disk_scheduler = nullptr;
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, BufferPoolCoalesceTest) {
+  const size_t num_threads = 8;
+  const size_t latency_ms = 50;
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(4, dm.get(), 2);
+
+  page_id_t page_id;
+  {
+    auto guard = bpm->NewPageGuarded(&page_id);
+    std::snprintf(guard.GetDataMut(), BUSTUB_PAGE_SIZE, "hello");
+  }
+  ASSERT_TRUE(bpm->FlushPage(page_id));
+  // Evict the page by filling the pool with other pages.
+  for (int i = 0; i < 4; i++) {
+    page_id_t other;
+    auto guard = bpm->NewPageGuarded(&other);
+  }
+
+  // Scenario: concurrent fetches of the same cold page share one read, and none of them observes a partially loaded
+  // frame.
+  dm->SetLatency(latency_ms);
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&bpm, page_id] {
+      auto guard = bpm->FetchPageRead(page_id);
+      EXPECT_STREQ("hello", guard.GetData());
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, std::chrono::milliseconds(latency_ms * num_threads / 2));
+
+  dm->ShutDown();
+}
+
+}  // namespace bustub
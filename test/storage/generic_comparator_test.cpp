@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_comparator_test.cpp
+//
+// Identification: test/storage/generic_comparator_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Compare two keys column by column as Values, the way GenericComparator used to. */
+template <size_t KeySize>
+static auto CompareAsValues(Schema *key_schema, const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs)
+    -> int {
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    Value lhs_value = lhs.ToValue(key_schema, i);
+    Value rhs_value = rhs.ToValue(key_schema, i);
+    if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * A value of the column's type from a handful of candidates, so that keys often tie on it, or NULL now and then unless
+ * it is a VARCHAR, which a Tuple cannot hold NULL.
+ */
+static auto RandomValue(TypeId type, std::mt19937 *rng) -> Value {
+  std::uniform_int_distribution<int> dist(-3, 3);
+  int pick = dist(*rng);
+  if (pick == -3 && type != TypeId::VARCHAR) {
+    return ValueFactory::GetNullValueByType(type);
+  }
+  switch (type) {
+    case TypeId::BOOLEAN:
+      return Value(type, static_cast<int8_t>(pick > 0 ? 1 : 0));
+    case TypeId::TINYINT:
+      return Value(type, static_cast<int8_t>(pick * 40));
+    case TypeId::SMALLINT:
+      return Value(type, static_cast<int16_t>(pick * 10000));
+    case TypeId::INTEGER:
+      return Value(type, static_cast<int32_t>(pick * 700000000));
+    case TypeId::BIGINT:
+      return Value(type, static_cast<int64_t>(pick) << 60);
+    case TypeId::DECIMAL:
+      return Value(type, pick * 1.5);
+    default:
+      return Value(type, std::string(pick + 3, 'a'));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(GenericComparatorTest, CompareLikeValuesTest) {
+  std::vector<Schema> key_schemas{
+      Schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::DECIMAL}, Column{"c", TypeId::BIGINT},
+              Column{"d", TypeId::SMALLINT}, Column{"e", TypeId::TINYINT}, Column{"f", TypeId::BOOLEAN}}),
+      Schema({Column{"a", TypeId::BOOLEAN}, Column{"b", TypeId::VARCHAR, 8}, Column{"c", TypeId::INTEGER}}),
+      Schema({Column{"a", TypeId::BIGINT}}),
+  };
+  std::mt19937 rng(0);
+  for (auto &key_schema : key_schemas) {
+    GenericComparator<64> comparator(&key_schema);
+    GenericComparator<64> comparator_copy(comparator);
+    std::vector<GenericKey<64>> keys(200);
+    for (auto &key : keys) {
+      std::vector<Value> values;
+      for (const auto &column : key_schema.GetColumns()) {
+        values.push_back(RandomValue(column.GetType(), &rng));
+      }
+      key.SetFromKey(Tuple(values, &key_schema));
+    }
+    for (const auto &lhs : keys) {
+      for (const auto &rhs : keys) {
+        ASSERT_EQ(CompareAsValues(&key_schema, lhs, rhs), comparator(lhs, rhs));
+        ASSERT_EQ(CompareAsValues(&key_schema, lhs, rhs), comparator_copy(lhs, rhs));
+      }
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_iterator_test.cpp
+//
+// Identification: test/table/table_iterator_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TableIteratorTest, ReadAheadScanTest) {
+  const size_t buffer_pool_size = 32;
+  const size_t num_io_workers = 8;
+  const size_t num_pages = 128;
+  const size_t latency_ms = 10;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), LRUK_REPLACER_K, nullptr,
+                                                 num_io_workers);
+  auto txn = std::make_unique<Transaction>(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, txn.get());
+
+  // Four tuples per page.
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 1000}});
+  std::set<page_id_t> pages;
+  int num_tuples = 0;
+  while (pages.size() < num_pages) {
+    Tuple tuple({ValueFactory::GetIntegerValue(num_tuples), ValueFactory::GetVarcharValue(std::string(900, 'x'))},
+                &schema);
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, txn.get()));
+    pages.insert(rid.GetPageId());
+    num_tuples++;
+  }
+  bpm->FlushAllPages();
+  disk_manager->SetLatency(latency_ms);
+
+  auto start = std::chrono::steady_clock::now();
+  int expected = 0;
+  for (auto iter = table.Begin(txn.get()); iter != table.End(); ++iter) {
+    ASSERT_EQ(expected, iter->GetValue(&schema, 0).GetAs<int32_t>());
+    expected++;
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  EXPECT_EQ(num_tuples, expected);
+
+  // At most buffer_pool_size pages are still resident, so a scan that reads one page at a time takes at least this
+  // long. Reading ahead overlaps the reads on the disk workers.
+  auto serial_ms = static_cast<int64_t>((num_pages - buffer_pool_size) * latency_ms);
+  EXPECT_LT(elapsed.count(), serial_ms / 2);
+
+  disk_manager->SetLatency(0);
+  bpm = nullptr;
+  disk_manager->ShutDown();
+}
+
+}  // namespace bustub
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -12,8 +13,11 @@
 
 #include "argparse/argparse.hpp"
 #include "binder/binder.h"
+#include "buffer/access_trace.h"
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_ring.h"
 #include "buffer/lru_k_replacer.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "common/config.h"
 #include "common/exception.h"
 #include "common/util/string_util.h"
@@ -53,7 +57,7 @@ struct BpmTotalMetrics {
     get_cnt_ += get_cnt;
   }
 
-  void Report() {
+  void Report(double get_hit_ratio) {
     auto now = ClockMs();
     auto elsped = now - start_time_;
     auto scan_per_sec = scan_cnt_ / static_cast<double>(elsped) * 1000;
@@ -62,6 +66,7 @@ struct BpmTotalMetrics {
     fmt::print("<<< BEGIN\n");
     fmt::print("scan: {}\n", scan_per_sec);
     fmt::print("get: {}\n", get_per_sec);
+    fmt::print("get_hit_ratio: {}\n", get_hit_ratio);
     fmt::print(">>> END\n");
   }
 };
@@ -102,14 +107,26 @@ struct BpmMetrics {
 
 // NOLINTNEXTLINE
 auto main(int argc, char **argv) -> int {
+  using bustub::AccessTrace;
   using bustub::AccessType;
   using bustub::BufferPoolManager;
+  using bustub::BufferRing;
   using bustub::DiskManagerUnlimitedMemory;
+  using bustub::ParallelBufferPoolManager;
   using bustub::page_id_t;
 
   argparse::ArgumentParser program("bustub-bpm-bench");
   program.add_argument("--duration").help("run bpm bench for n milliseconds");
   program.add_argument("--latency").help("set disk latency to n milliseconds");
+  program.add_argument("--shards").help("split the buffer pool frames across n independent instances");
+  program.add_argument("--io-workers").help("number of disk scheduler threads per buffer pool instance");
+  program.add_argument("--ring").help("give every scan thread a buffer ring of n frames (0 = no ring)");
+  program.add_argument("--cleaner").help("run the page cleaner, keeping n percent of the frames clean (0 = off)");
+  program.add_argument("--bpm-size").help("number of frames in the buffer pool");
+  program.add_argument("--scan-threads").help("number of scan threads (0 = get-only workload)");
+  program.add_argument("--replacer").help("replacement policy: lru-k, arc, 2q or clock-pro");
+  program.add_argument("--trace").help("record the page accesses into this file, for replacer-replay");
+  program.add_argument("--arena").help("keep the frames in one huge-page backed arena (yes/no)");
 
   try {
     program.parse_args(argc, argv);
@@ -129,12 +146,74 @@ auto main(int argc, char **argv) -> int {
     latency_ms = std::stoi(program.get("--latency"));
   }
 
+  size_t shards = 1;
+  if (program.present("--shards")) {
+    shards = std::stoi(program.get("--shards"));
+  }
+
+  size_t io_workers = bustub::DISK_SCHEDULER_NUM_WORKERS;
+  if (program.present("--io-workers")) {
+    io_workers = std::stoi(program.get("--io-workers"));
+  }
+
+  size_t ring_size = 0;
+  if (program.present("--ring")) {
+    ring_size = std::stoi(program.get("--ring"));
+  }
+
+  size_t bpm_size = BUSTUB_BPM_SIZE;
+  if (program.present("--bpm-size")) {
+    bpm_size = std::stoi(program.get("--bpm-size"));
+  }
+
+  size_t scan_threads = BUSTUB_SCAN_THREAD;
+  if (program.present("--scan-threads")) {
+    scan_threads = std::stoi(program.get("--scan-threads"));
+  }
+
+  size_t cleaner_percent = 0;
+  if (program.present("--cleaner")) {
+    cleaner_percent = std::stoi(program.get("--cleaner"));
+  }
+
+  bool use_frame_arena = false;
+  if (program.present("--arena")) {
+    use_frame_arena = program.get("--arena") == "yes" || program.get("--arena") == "true";
+  }
+
+  auto replacer_policy = bustub::ReplacerPolicy::LRUK;
+  if (program.present("--replacer")) {
+    auto policy = bustub::ReplacerPolicyFromString(program.get("--replacer"));
+    if (!policy.has_value()) {
+      std::cerr << "unknown replacer: " << program.get("--replacer") << std::endl;
+      return 1;
+    }
+    replacer_policy = *policy;
+  }
+
   auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
-  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
+  std::unique_ptr<BufferPoolManager> bpm;
+  if (shards <= 1) {
+    bpm = std::make_unique<BufferPoolManager>(bpm_size, disk_manager.get(), LRU_K_SIZE, nullptr, io_workers,
+                                              replacer_policy, use_frame_arena);
+  } else {
+    // Keep the total number of frames fixed so that runs with different shard counts are comparable.
+    bpm = std::make_unique<ParallelBufferPoolManager>(shards, std::max<size_t>(1, bpm_size / shards),
+                                                      disk_manager.get(), LRU_K_SIZE, nullptr, io_workers,
+                                                      replacer_policy, use_frame_arena);
+  }
   std::vector<page_id_t> page_ids;
 
-  fmt::print(stderr, "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}\n",
-             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE);
+  AccessTrace trace;
+  if (program.present("--trace")) {
+    bpm->SetAccessTrace(&trace);
+  }
+
+  fmt::print(stderr,
+             "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}, shards={}, "
+             "io_workers={}, ring={}, cleaner={}, scan_threads={}, replacer={}, arena={}\n",
+             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, bpm_size, shards, io_workers, ring_size,
+             cleaner_percent, scan_threads, bustub::ReplacerPolicyToString(replacer_policy), use_frame_arena);
 
   for (size_t i = 0; i < BUSTUB_PAGE_CNT; i++) {
     page_id_t page_id;
@@ -151,6 +230,10 @@ auto main(int argc, char **argv) -> int {
 
   // enable disk latency after creating all pages
   disk_manager->SetLatency(latency_ms);
+  if (cleaner_percent > 0) {
+    bpm->RunPageCleaner(bustub::PAGE_CLEANER_PAGES_PER_ROUND,
+                        std::chrono::milliseconds(bustub::PAGE_CLEANER_INTERVAL_MS), cleaner_percent);
+  }
 
   fmt::print(stderr, "[info] benchmark start\n");
 
@@ -159,15 +242,21 @@ auto main(int argc, char **argv) -> int {
 
   std::vector<std::thread> threads;
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_SCAN_THREAD; thread_id++) {
-    threads.emplace_back(std::thread([thread_id, &page_ids, &bpm, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < scan_threads; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, &page_ids, &bpm, duration_ms, ring_size, scan_threads,
+                                      &total_metrics] {
       BpmMetrics metrics(fmt::format("scan {:>2}", thread_id), duration_ms);
       metrics.Begin();
 
-      size_t page_idx = BUSTUB_PAGE_CNT * thread_id / BUSTUB_SCAN_THREAD;
+      std::unique_ptr<BufferRing> ring;
+      if (ring_size > 0) {
+        ring = std::make_unique<BufferRing>(ring_size);
+      }
+
+      size_t page_idx = BUSTUB_PAGE_CNT * thread_id / scan_threads;
 
       while (!metrics.ShouldFinish()) {
-        auto *page = bpm->FetchPage(page_ids[page_idx], AccessType::Scan);
+        auto *page = bpm->FetchPage(page_ids[page_idx], AccessType::Scan, ring.get());
         if (page == nullptr) {
           continue;
         }
@@ -225,8 +314,21 @@ auto main(int argc, char **argv) -> int {
   for (auto &thread : threads) {
     thread.join();
   }
+  bpm->StopPageCleaner();
+  if (program.present("--trace")) {
+    bpm->SetAccessTrace(nullptr);
+    if (!trace.Save(program.get("--trace"))) {
+      std::cerr << "cannot write trace to " << program.get("--trace") << std::endl;
+      return 1;
+    }
+    fmt::print(stderr, "[info] recorded {} accesses to {}\n", trace.GetAccesses().size(), program.get("--trace"));
+  }
+  fmt::print(stderr, "[info] evictions={}, foreground_writes={}, cleaner_writes={}\n", bpm->GetEvictionCount(),
+             bpm->GetForegroundWriteCount(), bpm->GetCleanerWriteCount());
 
-  total_metrics.Report();
+  auto get_hits = bpm->GetHitCount(AccessType::Get);
+  auto get_misses = bpm->GetMissCount(AccessType::Get);
+  total_metrics.Report(static_cast<double>(get_hits) / std::max<uint64_t>(get_hits + get_misses, 1));
 
   return 0;
 }
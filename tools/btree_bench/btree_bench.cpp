@@ -6,6 +6,7 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <cpp_random_distributions/zipfian_int_distribution.h>
@@ -38,6 +39,11 @@ static const size_t LRU_K_SIZE = 4;
 static const size_t BUSTUB_BPM_SIZE = 256;
 static const size_t TOTAL_KEYS = 100000;
 static const size_t KEY_MODIFY_RANGE = 2048;
+// The page sizes a BPlusTree defaults to, spelled out to pass the latching mode after them.
+static const int LEAF_MAX_SIZE =
+    (bustub::BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<bustub::GenericKey<8>, bustub::RID>);
+static const int INTERNAL_MAX_SIZE =
+    (bustub::BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(std::pair<bustub::GenericKey<8>, bustub::page_id_t>);
 
 struct BTreeTotalMetrics {
   uint64_t write_cnt_{0};
@@ -110,67 +116,48 @@ auto KeyWillVanish(size_t key) -> bool { return key % 7 == 0; }
 // These keys will be overwritten to a new value
 auto KeyWillChange(size_t key) -> bool { return key % 5 == 0; }
 
-// NOLINTNEXTLINE
-auto main(int argc, char **argv) -> int {
-  using bustub::AccessType;
+using BPlusTree = bustub::BPlusTree<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>>;
+
+/**
+ * Run `read_threads` readers and `write_threads` writers against a tree of TOTAL_KEYS keys for `duration_ms`, and add
+ * up what they did in total_metrics.
+ */
+void RunBench(size_t read_threads, size_t write_threads, bool optimistic, uint64_t duration_ms,
+              BTreeTotalMetrics *total_metrics) {
   using bustub::BufferPoolManager;
   using bustub::DiskManagerUnlimitedMemory;
   using bustub::page_id_t;
 
-  argparse::ArgumentParser program("bustub-btree-bench");
-  program.add_argument("--duration").help("run btree bench for n milliseconds");
-
-  try {
-    program.parse_args(argc, argv);
-  } catch (const std::runtime_error &err) {
-    std::cerr << err.what() << std::endl;
-    std::cerr << program;
-    return 1;
-  }
-
-  uint64_t duration_ms = 30000;
-  if (program.present("--duration")) {
-    duration_ms = std::stoi(program.get("--duration"));
-  }
-
   auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
   auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
 
-  fmt::print(stderr, "[info] total_keys={}, duration_ms={}, lru_k_size={}, bpm_size={}\n", TOTAL_KEYS, duration_ms,
-             LRU_K_SIZE, BUSTUB_BPM_SIZE);
-
   auto key_schema = bustub::ParseCreateStatement("a bigint");
   bustub::GenericComparator<8> comparator(key_schema.get());
 
   page_id_t page_id;
   auto header_page = bpm->NewPageGuarded(&page_id);
 
-  bustub::BPlusTree<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>> index("foo_pk", page_id,
-                                                                                            bpm.get(), comparator);
+  BPlusTree index("foo_pk", page_id, bpm.get(), comparator, LEAF_MAX_SIZE, INTERNAL_MAX_SIZE, optimistic);
 
+  std::vector<std::pair<bustub::GenericKey<8>, bustub::RID>> entries(TOTAL_KEYS);
   for (size_t key = 0; key < TOTAL_KEYS; key++) {
-    bustub::GenericKey<8> index_key;
-    bustub::RID rid;
     uint32_t value = key;
-    rid.Set(value, value);
-    index_key.SetFromInteger(key);
-    index.Insert(index_key, rid, nullptr);
+    entries[key].first.SetFromInteger(key);
+    entries[key].second.Set(value, value);
   }
+  index.BulkLoad(entries);
 
-  fmt::print(stderr, "[info] benchmark start\n");
-
-  BTreeTotalMetrics total_metrics;
-  total_metrics.Begin();
+  total_metrics->Begin();
 
   std::vector<std::thread> threads;
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_READ_THREAD; thread_id++) {
-    threads.emplace_back(std::thread([thread_id, &index, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < read_threads; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, read_threads, &index, duration_ms, total_metrics] {
       BTreeMetrics metrics(fmt::format("read  {:>2}", thread_id), duration_ms);
       metrics.Begin();
 
-      size_t key_start = TOTAL_KEYS / BUSTUB_READ_THREAD * thread_id;
-      size_t key_end = TOTAL_KEYS / BUSTUB_READ_THREAD * (thread_id + 1);
+      size_t key_start = TOTAL_KEYS / read_threads * thread_id;
+      size_t key_end = TOTAL_KEYS / read_threads * (thread_id + 1);
       std::random_device r;
       std::default_random_engine gen(r());
       std::uniform_int_distribution<size_t> dis(key_start, key_end - 1);
@@ -206,17 +193,17 @@ auto main(int argc, char **argv) -> int {
         }
       }
 
-      total_metrics.ReportRead(metrics.cnt_);
+      total_metrics->ReportRead(metrics.cnt_);
     }));
   }
 
-  for (size_t thread_id = 0; thread_id < BUSTUB_WRITE_THREAD; thread_id++) {
-    threads.emplace_back(std::thread([thread_id, &index, duration_ms, &total_metrics] {
+  for (size_t thread_id = 0; thread_id < write_threads; thread_id++) {
+    threads.emplace_back(std::thread([thread_id, write_threads, &index, duration_ms, total_metrics] {
       BTreeMetrics metrics(fmt::format("write {:>2}", thread_id), duration_ms);
       metrics.Begin();
 
-      size_t key_start = TOTAL_KEYS / BUSTUB_WRITE_THREAD * thread_id;
-      size_t key_end = TOTAL_KEYS / BUSTUB_WRITE_THREAD * (thread_id + 1);
+      size_t key_start = TOTAL_KEYS / write_threads * thread_id;
+      size_t key_end = TOTAL_KEYS / write_threads * (thread_id + 1);
       std::random_device r;
       std::default_random_engine gen(r());
       std::uniform_int_distribution<size_t> dis(key_start, key_end - 1);
@@ -253,14 +240,80 @@ auto main(int argc, char **argv) -> int {
         do_insert = !do_insert;
       }
 
-      total_metrics.ReportWrite(metrics.cnt_);
+      total_metrics->ReportWrite(metrics.cnt_);
     }));
   }
 
   for (auto &thread : threads) {
     thread.join();
   }
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-btree-bench");
+  program.add_argument("--duration").help("run btree bench for n milliseconds");
+  program.add_argument("--max-writers")
+      .help("instead of the mixed workload, double the number of writers from 1 up to n, latching pessimistically "
+            "and optimistically");
+  program.add_argument("--max-readers")
+      .help("instead of the mixed workload, double the number of readers from 1 up to n, latching and reading "
+            "optimistically");
+  program.add_argument("--lookup-latency")
+      .help("instead of the mixed workload, time point lookups of a single reader with nothing else running")
+      .default_value(false)
+      .implicit_value(true);
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t duration_ms = 30000;
+  if (program.present("--duration")) {
+    duration_ms = std::stoi(program.get("--duration"));
+  }
+
+  fmt::print(stderr, "[info] total_keys={}, duration_ms={}, lru_k_size={}, bpm_size={}\n", TOTAL_KEYS, duration_ms,
+             LRU_K_SIZE, BUSTUB_BPM_SIZE);
+
+  if (program.present("--max-writers") || program.present("--max-readers")) {
+    bool writers = program.present("--max-writers").has_value();
+    size_t max_threads = std::stoi(program.get(writers ? "--max-writers" : "--max-readers"));
+    fmt::print("<<< BEGIN\n");
+    for (bool optimistic : {false, true}) {
+      for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        BTreeTotalMetrics total_metrics;
+        RunBench(writers ? 0 : threads, writers ? threads : 0, optimistic, duration_ms, &total_metrics);
+        auto elapsed = ClockMs() - total_metrics.start_time_;
+        auto ops = writers ? total_metrics.write_cnt_ : total_metrics.read_cnt_;
+        fmt::print("latching={:<11} {}={:<4} {}/s={:.1f}\n", optimistic ? "optimistic" : "pessimistic",
+                   writers ? "writers" : "readers", threads, writers ? "writes" : "reads",
+                   ops / static_cast<double>(elapsed) * 1000);
+      }
+    }
+    fmt::print(">>> END\n");
+    return 0;
+  }
 
+  if (program.get<bool>("--lookup-latency")) {
+    BTreeTotalMetrics total_metrics;
+    RunBench(1, 0, true, duration_ms, &total_metrics);
+    auto elapsed = ClockMs() - total_metrics.start_time_;
+    fmt::print("<<< BEGIN\n");
+    fmt::print("lookups: {}\n", total_metrics.read_cnt_);
+    fmt::print("lookup latency: {:.1f} ns\n", elapsed * 1e6 / static_cast<double>(total_metrics.read_cnt_));
+    fmt::print(">>> END\n");
+    return 0;
+  }
+
+  fmt::print(stderr, "[info] benchmark start\n");
+
+  BTreeTotalMetrics total_metrics;
+  RunBench(BUSTUB_READ_THREAD, BUSTUB_WRITE_THREAD, true, duration_ms, &total_metrics);
   total_metrics.Report();
 
   return 0;
@@ -0,0 +1,120 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "common/config.h"
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction_manager.h"
+#include "fmt/core.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+static const char *BUSTUB_COMMIT_BENCH_DB = "bustub-commit-bench.db";
+static const char *BUSTUB_COMMIT_BENCH_LOG = "bustub-commit-bench.log";
+
+struct CommitBenchResult {
+  uint64_t commits_{0};
+  uint64_t flushes_{0};
+  uint64_t elapsed_ms_{0};
+};
+
+/**
+ * Run `clients` threads that commit empty transactions back to back for `duration_ms`, with the log flush thread
+ * running. Every commit waits for its commit record to be durable.
+ */
+auto RunCommits(size_t clients, uint64_t duration_ms) -> CommitBenchResult {
+  using bustub::DiskManager;
+  using bustub::LockManager;
+  using bustub::LogManager;
+  using bustub::Transaction;
+  using bustub::TransactionManager;
+
+  std::remove(BUSTUB_COMMIT_BENCH_DB);
+  std::remove(BUSTUB_COMMIT_BENCH_LOG);
+  auto disk_manager = std::make_unique<DiskManager>(BUSTUB_COMMIT_BENCH_DB);
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), log_manager.get());
+  log_manager->RunFlushThread();
+
+  std::atomic<uint64_t> commits{0};
+  uint64_t start = ClockMs();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < clients; i++) {
+    threads.emplace_back([&] {
+      uint64_t local_commits = 0;
+      while (ClockMs() - start < duration_ms) {
+        Transaction *txn = txn_manager->Begin();
+        txn_manager->Commit(txn);
+        delete txn;
+        local_commits++;
+      }
+      commits += local_commits;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  CommitBenchResult result;
+  result.elapsed_ms_ = ClockMs() - start;
+  log_manager->StopFlushThread();
+  result.commits_ = commits;
+  result.flushes_ = disk_manager->GetNumFlushes();
+
+  disk_manager->ShutDown();
+  std::remove(BUSTUB_COMMIT_BENCH_DB);
+  std::remove(BUSTUB_COMMIT_BENCH_LOG);
+  return result;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-commit-bench");
+  program.add_argument("--duration").help("run every client count for n milliseconds");
+  program.add_argument("--max-clients").help("double the number of committing clients from 1 up to n");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t duration_ms = 5000;
+  if (program.present("--duration")) {
+    duration_ms = std::stoi(program.get("--duration"));
+  }
+
+  size_t max_clients = 32;
+  if (program.present("--max-clients")) {
+    max_clients = std::stoi(program.get("--max-clients"));
+  }
+
+  fmt::print("<<< BEGIN\n");
+  for (size_t clients = 1; clients <= max_clients; clients *= 2) {
+    auto result = RunCommits(clients, duration_ms);
+    auto commits_per_sec = result.commits_ / static_cast<double>(result.elapsed_ms_) * 1000;
+    auto flushes_per_commit = result.commits_ == 0 ? 0 : result.flushes_ / static_cast<double>(result.commits_);
+    fmt::print("clients={:<4} commits/s={:<12.1f} log_flushes={:<10} flushes/commit={:.4f}\n", clients,
+               commits_per_sec, result.flushes_, flushes_per_commit);
+  }
+  fmt::print(">>> END\n");
+
+  return 0;
+}
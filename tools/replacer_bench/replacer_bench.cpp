@@ -0,0 +1,118 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/util/string_util.h"
+#include "fmt/core.h"
+
+/**
+ * Drive a replacer the way a buffer pool of num_frames frames would, over four times as many pages: a hit records an
+ * access, a miss evicts a frame and records the access of the new page. Returns the time per operation in ns.
+ */
+auto RunReplacer(bustub::ReplacerPolicy policy, size_t num_frames, size_t k, size_t num_ops, double *hit_ratio)
+    -> double {
+  using bustub::frame_id_t;
+  using bustub::page_id_t;
+
+  auto replacer = bustub::MakeReplacer(policy, num_frames, k);
+  size_t num_pages = num_frames * 4;
+  std::vector<frame_id_t> page_frames(num_pages, -1);
+  std::vector<page_id_t> frame_pages(num_frames, bustub::INVALID_PAGE_ID);
+  for (size_t i = 0; i < num_frames; i++) {
+    page_frames[i] = static_cast<frame_id_t>(i);
+    frame_pages[i] = static_cast<page_id_t>(i);
+    replacer->RecordAccess(static_cast<frame_id_t>(i), bustub::AccessType::Get, static_cast<page_id_t>(i));
+    replacer->SetEvictable(static_cast<frame_id_t>(i), true);
+  }
+
+  // Half of the accesses go to a hot set of an eighth of the pages, the rest anywhere.
+  std::mt19937_64 gen(0);
+  std::vector<page_id_t> accesses(num_ops);
+  for (auto &page_id : accesses) {
+    page_id = static_cast<page_id_t>(gen() % 2 == 0 ? gen() % (num_pages / 8) : gen() % num_pages);
+  }
+
+  size_t hits = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (page_id_t page_id : accesses) {
+    frame_id_t frame_id = page_frames[page_id];
+    if (frame_id != -1) {
+      hits++;
+      replacer->RecordAccess(frame_id, bustub::AccessType::Get, page_id);
+      continue;
+    }
+    if (!replacer->Evict(&frame_id)) {
+      throw std::runtime_error("nothing to evict");
+    }
+    page_frames[frame_pages[frame_id]] = -1;
+    page_frames[page_id] = frame_id;
+    frame_pages[frame_id] = page_id;
+    replacer->RecordAccess(frame_id, bustub::AccessType::Get, page_id);
+    replacer->SetEvictable(frame_id, true);
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  *hit_ratio = static_cast<double>(hits) / static_cast<double>(num_ops);
+  return elapsed / static_cast<double>(num_ops);
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-replacer-bench");
+  program.add_argument("--frames").help("comma-separated numbers of frames (default 1000,10000,100000,1000000)");
+  program.add_argument("--ops").help("number of accesses per run (default 2000000)");
+  program.add_argument("--k").help("lookback constant of LRU-K");
+  program.add_argument("--replacer").help("only run this policy: lru-k, arc, 2q or clock-pro");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  std::vector<size_t> frame_counts{1000, 10000, 100000, 1000000};
+  if (program.present("--frames")) {
+    frame_counts.clear();
+    for (const auto &count : bustub::StringUtil::Split(program.get("--frames"), ',')) {
+      frame_counts.push_back(std::stoul(count));
+    }
+  }
+
+  size_t num_ops = 2000000;
+  if (program.present("--ops")) {
+    num_ops = std::stoul(program.get("--ops"));
+  }
+
+  size_t k = bustub::LRUK_REPLACER_K;
+  if (program.present("--k")) {
+    k = std::stoul(program.get("--k"));
+  }
+
+  std::vector<bustub::ReplacerPolicy> policies{bustub::ReplacerPolicy::LRUK, bustub::ReplacerPolicy::ARC,
+                                               bustub::ReplacerPolicy::TwoQueue, bustub::ReplacerPolicy::ClockPro};
+  if (program.present("--replacer")) {
+    auto policy = bustub::ReplacerPolicyFromString(program.get("--replacer"));
+    if (!policy.has_value()) {
+      std::cerr << "unknown replacer: " << program.get("--replacer") << std::endl;
+      return 1;
+    }
+    policies = {*policy};
+  }
+
+  fmt::print("{:>10} {:>10} {:>10} {:>10}\n", "frames", "replacer", "ns_per_op", "hit_ratio");
+  for (size_t num_frames : frame_counts) {
+    for (auto policy : policies) {
+      double hit_ratio;
+      double ns_per_op = RunReplacer(policy, num_frames, k, num_ops, &hit_ratio);
+      fmt::print("{:>10} {:>10} {:>10.1f} {:>10.4f}\n", num_frames, bustub::ReplacerPolicyToString(policy), ns_per_op,
+                 hit_ratio);
+    }
+  }
+  return 0;
+}
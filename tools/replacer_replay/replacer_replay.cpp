@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/access_trace.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/util/string_util.h"
+#include "fmt/core.h"
+
+static const size_t LRU_K_SIZE = 16;
+
+struct ReplayResult {
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+  uint64_t new_pages_{0};
+};
+
+/**
+ * Replay a trace against one policy, as a buffer pool of the given size in which no page stays pinned would see it:
+ * every fetch of a resident page is a hit, every other fetch is a miss that takes a free or evicted frame.
+ */
+auto Replay(const bustub::AccessTrace &trace, bustub::ReplacerPolicy policy, size_t bpm_size) -> ReplayResult {
+  using bustub::frame_id_t;
+  using bustub::page_id_t;
+
+  auto replacer = bustub::MakeReplacer(policy, bpm_size, LRU_K_SIZE);
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_pages(bpm_size, bustub::INVALID_PAGE_ID);
+  std::list<frame_id_t> free_list;
+  for (size_t i = 0; i < bpm_size; i++) {
+    free_list.push_back(static_cast<frame_id_t>(i));
+  }
+
+  ReplayResult result;
+  for (const auto &access : trace.GetAccesses()) {
+    auto it = page_table.find(access.page_id_);
+    if (it != page_table.end()) {
+      result.hits_++;
+      replacer->RecordAccess(it->second, access.access_type_, access.page_id_);
+      continue;
+    }
+    if (access.is_new_) {
+      result.new_pages_++;
+    } else {
+      result.misses_++;
+    }
+
+    frame_id_t frame_id;
+    if (!free_list.empty()) {
+      frame_id = free_list.front();
+      free_list.pop_front();
+    } else if (replacer->Evict(&frame_id)) {
+      page_table.erase(frame_pages[frame_id]);
+    } else {
+      continue;
+    }
+    page_table[access.page_id_] = frame_id;
+    frame_pages[frame_id] = access.page_id_;
+    replacer->RecordAccess(frame_id, access.access_type_, access.page_id_);
+    replacer->SetEvictable(frame_id, true);
+  }
+  return result;
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-replacer-replay");
+  program.add_argument("trace").help("trace file recorded with --trace by bpm-bench or terrier-bench");
+  program.add_argument("--bpm-size").help("comma-separated numbers of frames to simulate (default 64)");
+  program.add_argument("--replacer").help("only replay this policy: lru-k, arc, 2q or clock-pro");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  bustub::AccessTrace trace;
+  if (!trace.Load(program.get("trace"))) {
+    std::cerr << "cannot read trace " << program.get("trace") << std::endl;
+    return 1;
+  }
+
+  std::vector<size_t> bpm_sizes{64};
+  if (program.present("--bpm-size")) {
+    bpm_sizes.clear();
+    for (const auto &size : bustub::StringUtil::Split(program.get("--bpm-size"), ',')) {
+      bpm_sizes.push_back(std::stoul(size));
+    }
+  }
+
+  std::vector<bustub::ReplacerPolicy> policies{bustub::ReplacerPolicy::LRUK, bustub::ReplacerPolicy::ARC,
+                                               bustub::ReplacerPolicy::TwoQueue, bustub::ReplacerPolicy::ClockPro};
+  if (program.present("--replacer")) {
+    auto policy = bustub::ReplacerPolicyFromString(program.get("--replacer"));
+    if (!policy.has_value()) {
+      std::cerr << "unknown replacer: " << program.get("--replacer") << std::endl;
+      return 1;
+    }
+    policies = {*policy};
+  }
+
+  fmt::print("[info] accesses={}\n", trace.GetAccesses().size());
+  fmt::print("{:>10} {:>10} {:>12} {:>12} {:>10}\n", "bpm_size", "replacer", "hits", "misses", "hit_ratio");
+  for (size_t bpm_size : bpm_sizes) {
+    for (auto policy : policies) {
+      auto result = Replay(trace, policy, bpm_size);
+      double hit_ratio = static_cast<double>(result.hits_) / std::max<uint64_t>(result.hits_ + result.misses_, 1);
+      fmt::print("{:>10} {:>10} {:>12} {:>12} {:>10.4f}\n", bpm_size, bustub::ReplacerPolicyToString(policy),
+                 result.hits_, result.misses_, hit_ratio);
+    }
+  }
+  return 0;
+}
@@ -10,6 +10,8 @@
 
 #include "argparse/argparse.hpp"
 #include "binder/binder.h"
+#include "buffer/access_trace.h"
+#include "buffer/buffer_pool_manager.h"
 #include "common/bustub_instance.h"
 #include "common/exception.h"
 #include "common/util/string_util.h"
@@ -120,6 +122,8 @@ auto main(int argc, char **argv) -> int {
   program.add_argument("--duration").help("run terrier bench for n milliseconds");
   program.add_argument("--force-create-index").help("create index in terrier bench");
   program.add_argument("--force-enable-update").help("use update statement in terrier bench");
+  program.add_argument("--replacer").help("replacement policy: lru-k, arc, 2q or clock-pro");
+  program.add_argument("--trace").help("record the page accesses into this file, for replacer-replay");
 
   try {
     program.parse_args(argc, argv);
@@ -129,8 +133,24 @@ auto main(int argc, char **argv) -> int {
     return 1;
   }
 
-  auto bustub = std::make_unique<bustub::BustubInstance>();
+  auto replacer_policy = bustub::ReplacerPolicy::LRUK;
+  if (program.present("--replacer")) {
+    auto policy = bustub::ReplacerPolicyFromString(program.get("--replacer"));
+    if (!policy.has_value()) {
+      std::cerr << "unknown replacer: " << program.get("--replacer") << std::endl;
+      return 1;
+    }
+    replacer_policy = *policy;
+  }
+
+  auto bustub = std::make_unique<bustub::BustubInstance>(128, 1, replacer_policy);
   auto writer = bustub::SimpleStreamWriter(std::cerr);
+  std::cerr << "x: replacer " << bustub::ReplacerPolicyToString(replacer_policy) << std::endl;
+
+  bustub::AccessTrace trace;
+  if (program.present("--trace")) {
+    bustub->buffer_pool_manager_->SetAccessTrace(&trace);
+  }
 
   // create schema
   auto schema = "CREATE TABLE nft(id int, terrier int);";
@@ -358,6 +378,15 @@ auto main(int argc, char **argv) -> int {
     }
   }
 
+  if (program.present("--trace")) {
+    bustub->buffer_pool_manager_->SetAccessTrace(nullptr);
+    if (!trace.Save(program.get("--trace"))) {
+      std::cerr << "cannot write trace to " << program.get("--trace") << std::endl;
+      return 1;
+    }
+    std::cerr << "x: recorded " << trace.GetAccesses().size() << " accesses" << std::endl;
+  }
+
   total_metrics.Report();
 
   return 0;